@@ -0,0 +1,42 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+/**
+ * @file AllocationCounter.hpp
+ * @brief Подсчёт выделений памяти в бенчмарках
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @brief Число вызовов operator new во всех потоках с начала процесса
+ */
+std::uint64_t allocationCount();
+
+/**
+ * @class AllocationScope
+ * @brief Добавляет в бенчмарк счётчик allocs/op
+ *
+ * Создаётся перед циклом замера, при уничтожении делит выделения за
+ * время жизни на число итераций. В многопоточных бенчмарках счётчик
+ * общий, поэтому включает выделения соседних потоков.
+ */
+class AllocationScope
+{
+public:
+    explicit AllocationScope(benchmark::State& state)
+        : state_(state), start_(allocationCount())
+    {
+    }
+
+    ~AllocationScope()
+    {
+        state_.counters["allocs/op"] = benchmark::Counter(
+            static_cast<double>(allocationCount() - start_), benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State& state_;
+    std::uint64_t start_;
+};
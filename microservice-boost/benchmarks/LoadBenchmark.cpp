@@ -0,0 +1,272 @@
+#include "BoostBeastApplication.hpp"
+#include "Environment.hpp"
+#include "LoadGenerator.hpp"
+#include <boost/asio.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file LoadBenchmark.cpp
+ * @brief Сквозной замер пропускной способности и задержек по режимам сервера
+ * @author Anton Tobolkin
+ *
+ * Поднимает BoostBeastApplication на loopback с синтетическими
+ * обработчиками и нагружает его LoadGenerator. Параметры - --ключ=значение:
+ *
+ *   --mode=thread|pool|reuseport|coroutine|all   (all)
+ *   --scenario=get-small|get-new-connection|post-large|wildcard|param-routes|all   (all)
+ *   --server-threads=N   потоки сервера в pool/reuseport/coroutine (4)
+ *   --connections=N      соединения генератора, по потоку на каждое (8)
+ *   --rate=R             запросов в секунду всего, 0 - закрытый цикл (0)
+ *   --duration=S --warmup=S   секунды замера и разогрева (5 и 1)
+ *   --port=P             первый порт, режимы занимают P, P+1, ... (18400)
+ */
+
+namespace
+{
+
+constexpr std::size_t kLargeBodySize = 256 * 1024;
+constexpr int kParamRoutes = 50;
+
+class HelloHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest&, IResponse& res) override
+    {
+        res.setStatus(200);
+        res.setHeader("Content-Type", "text/plain");
+        res.setBody("hello");
+    }
+};
+
+// Принимает тело целиком и отвечает его размером
+class UploadHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest& req, IResponse& res) override
+    {
+        res.setStatus(200);
+        res.setBody(std::to_string(req.body().size()));
+    }
+};
+
+class LoadTestApplication : public BoostBeastApplication
+{
+public:
+    explicit LoadTestApplication(std::shared_ptr<IEnvironment> env)
+    {
+        env_ = std::move(env);
+    }
+
+    void configureInjection() override
+    {
+        auto hello = std::make_shared<HelloHandler>();
+        handlers_[getHandlerKey("GET", "/hello")] = hello;
+        handlers_[getHandlerKey("POST", "/upload")] = std::make_shared<UploadHandler>();
+        handlers_[getHandlerKey("GET", "/files/*")] = hello;
+        // Параметризованные маршруты, чтобы поиск обработчика был не тривиальным
+        for (int i = 0; i < kParamRoutes; ++i)
+        {
+            handlers_[getHandlerKey("GET", "/api/v1/resource" + std::to_string(i) + "/{id:int}")] = hello;
+        }
+    }
+};
+
+struct Scenario
+{
+    std::string name;
+    std::string method;
+    std::vector<std::string> targets; ///< Запросы идут по кругу
+    bool keepAlive;
+    bool largeBody;
+};
+
+const std::vector<Scenario>& scenarios()
+{
+    static const std::vector<Scenario> all = [] {
+        // Все параметризованные маршруты по очереди, с разными id
+        std::vector<std::string> resources;
+        for (int i = 0; i < kParamRoutes; ++i)
+        {
+            resources.push_back("/api/v1/resource" + std::to_string(i) + "/" + std::to_string(1000 + i * 7));
+        }
+        return std::vector<Scenario>{
+            {"get-small", "GET", {"/hello"}, true, false},
+            {"get-new-connection", "GET", {"/hello"}, false, false},
+            {"post-large", "POST", {"/upload"}, true, true},
+            {"wildcard", "GET", {"/files/site.css"}, true, false},
+            {"param-routes", "GET", resources, true, false},
+        };
+    }();
+    return all;
+}
+
+std::vector<std::string> availableModes()
+{
+    std::vector<std::string> modes = {"thread", "pool", "reuseport"};
+#ifdef MICROSERVICE_COROUTINES
+    modes.push_back("coroutine");
+#endif
+    return modes;
+}
+
+std::map<std::string, std::string> parseArguments(int argc, char** argv)
+{
+    std::map<std::string, std::string> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos)
+        {
+            throw std::runtime_error("Invalid argument: " + arg + " (expected --key=value)");
+        }
+        args[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+    }
+    return args;
+}
+
+std::string argument(const std::map<std::string, std::string>& args, const std::string& key,
+                     const std::string& fallback)
+{
+    auto it = args.find(key);
+    return it != args.end() ? it->second : fallback;
+}
+
+// Сервер готов, когда принимает соединения
+bool waitForPort(unsigned short port)
+{
+    boost::asio::io_context ioc;
+    for (int attempt = 0; attempt < 500; ++attempt)
+    {
+        boost::asio::ip::tcp::socket socket(ioc);
+        boost::system::error_code ec;
+        socket.connect({boost::asio::ip::make_address("127.0.0.1"), port}, ec);
+        if (!ec)
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+double milliseconds(std::uint64_t ns)
+{
+    return static_cast<double>(ns) / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        auto args = parseArguments(argc, argv);
+        std::string modeArg = argument(args, "mode", "all");
+        std::string scenarioArg = argument(args, "scenario", "all");
+        int serverThreads = std::stoi(argument(args, "server-threads", "4"));
+        int basePort = std::stoi(argument(args, "port", "18400"));
+
+        LoadOptions base;
+        base.connections = std::stoi(argument(args, "connections", "8"));
+        base.rate = std::stod(argument(args, "rate", "0"));
+        base.duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(std::stod(argument(args, "duration", "5"))));
+        base.warmup = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(std::stod(argument(args, "warmup", "1"))));
+
+        std::vector<std::string> modes = modeArg == "all" ? availableModes() : std::vector<std::string>{modeArg};
+
+        std::vector<Scenario> selected;
+        for (const auto& scenario : scenarios())
+        {
+            if (scenarioArg == "all" || scenarioArg == scenario.name)
+            {
+                selected.push_back(scenario);
+            }
+        }
+        if (selected.empty())
+        {
+            throw std::runtime_error("Unknown scenario: " + scenarioArg);
+        }
+
+        std::printf("%s loop, %d connection(s), %d server thread(s)\n",
+                    base.rate > 0 ? "open" : "closed", base.connections, serverThreads);
+        std::printf("%-20s %-10s %10s %8s %12s %10s %10s %10s\n", "scenario", "mode", "requests", "errors",
+                    "rps", "p50 ms", "p99 ms", "p999 ms");
+
+        for (std::size_t m = 0; m < modes.size(); ++m)
+        {
+            auto port = static_cast<unsigned short>(basePort + static_cast<int>(m));
+            auto env = std::make_shared<Environment>();
+            env->setProperty("server.host", std::string("127.0.0.1"));
+            env->setProperty("server.port", static_cast<int>(port));
+            env->setProperty("server.mode", modes[m]);
+            env->setProperty("server.threads", serverThreads);
+            env->setProperty("logging.level", std::string("warn"));
+
+            LoadTestApplication app(env);
+            app.configureInjection();
+            std::exception_ptr failure;
+            std::thread serverThread([&app, &failure] {
+                try
+                {
+                    app.start();
+                }
+                catch (...)
+                {
+                    failure = std::current_exception();
+                }
+            });
+            if (!waitForPort(port))
+            {
+                app.stop();
+                serverThread.join();
+                if (failure)
+                {
+                    std::rethrow_exception(failure);
+                }
+                throw std::runtime_error("Server did not start on port " + std::to_string(port));
+            }
+
+            for (const auto& scenario : selected)
+            {
+                LoadOptions options = base;
+                options.port = port;
+                options.method = scenario.method;
+                options.targets = scenario.targets;
+                options.keepAlive = scenario.keepAlive;
+                if (scenario.largeBody)
+                {
+                    options.body.assign(kLargeBodySize, 'x');
+                }
+
+                LoadResult result = LoadGenerator(std::move(options)).run();
+                std::printf("%-20s %-10s %10llu %8llu %12.0f %10.3f %10.3f %10.3f\n", scenario.name.c_str(),
+                            modes[m].c_str(), static_cast<unsigned long long>(result.requests),
+                            static_cast<unsigned long long>(result.errors), result.rps(),
+                            milliseconds(result.latency.quantile(0.5)), milliseconds(result.latency.quantile(0.99)),
+                            milliseconds(result.latency.quantile(0.999)));
+                std::fflush(stdout);
+            }
+
+            app.stop();
+            serverThread.join();
+        }
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "loadtest: " << e.what() << std::endl;
+        return 1;
+    }
+}
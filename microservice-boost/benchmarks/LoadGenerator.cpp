@@ -0,0 +1,200 @@
+#include "LoadGenerator.hpp"
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/**
+ * @file LoadGenerator.cpp
+ * @brief Реализация генератора нагрузки
+ * @author Anton Tobolkin
+ */
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+struct LoadGenerator::Totals
+{
+    std::atomic<std::uint64_t> requests{0};
+    std::atomic<std::uint64_t> errors{0};
+};
+
+LoadGenerator::LoadGenerator(LoadOptions options) : options_(std::move(options))
+{
+    options_.connections = std::max(options_.connections, 1);
+    if (options_.targets.empty())
+    {
+        options_.targets.push_back(options_.target);
+    }
+
+    for (const auto& target : options_.targets)
+    {
+        std::string request = options_.method + " " + target + " HTTP/1.1\r\n";
+        request += "Host: " + options_.host + ":" + std::to_string(options_.port) + "\r\n";
+        request += "User-Agent: microservice-loadtest\r\n";
+        if (!options_.keepAlive)
+        {
+            request += "Connection: close\r\n";
+        }
+        if (!options_.body.empty() || options_.method == "POST" || options_.method == "PUT")
+        {
+            request += "Content-Type: application/octet-stream\r\n";
+            request += "Content-Length: " + std::to_string(options_.body.size()) + "\r\n";
+        }
+        request += "\r\n";
+        request += options_.body;
+        requests_.push_back(std::move(request));
+    }
+}
+
+LoadResult LoadGenerator::run()
+{
+    LatencyHistogram latency(16);
+    Totals totals;
+
+    auto measureFrom = Clock::now() + options_.warmup;
+    auto until = measureFrom + options_.duration;
+
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<std::size_t>(options_.connections));
+    for (int i = 0; i < options_.connections; ++i)
+    {
+        workers.emplace_back([this, i, measureFrom, until, &latency, &totals] {
+            worker(i, measureFrom, until, latency, totals);
+        });
+    }
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+
+    LoadResult result;
+    result.requests = totals.requests.load();
+    result.errors = totals.errors.load();
+    result.seconds = std::chrono::duration<double>(options_.duration).count();
+    result.latency = latency.snapshot();
+    return result;
+}
+
+void LoadGenerator::worker(int index, Clock::time_point measureFrom, Clock::time_point until,
+                           LatencyHistogram& latency, Totals& totals)
+{
+    asio::io_context ioc;
+    tcp::resolver resolver(ioc);
+    tcp::resolver::results_type endpoints;
+    tcp::socket socket(ioc);
+    beast::flat_buffer buffer;
+
+    // Открытый цикл: у соединения своё расписание, старты сдвинуты, чтобы
+    // соединения не отправляли запросы пачкой в один и тот же момент
+    bool openLoop = options_.rate > 0;
+    Clock::duration interval{};
+    Clock::time_point next = Clock::now();
+    if (openLoop)
+    {
+        interval = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(options_.connections / options_.rate));
+        next += interval * index / options_.connections;
+    }
+
+    // Соединения начинают с разных target, чтобы вместе обходить все
+    std::size_t nextRequest = static_cast<std::size_t>(index);
+
+    auto close = [&socket, &buffer](bool reset) {
+        beast::error_code ignored;
+        if (reset)
+        {
+            // RST вместо FIN: в режиме нового соединения клиент иначе быстро
+            // исчерпывает локальные порты на сокетах в TIME_WAIT
+            socket.set_option(asio::socket_base::linger(true, 0), ignored);
+        }
+        else
+        {
+            socket.shutdown(tcp::socket::shutdown_send, ignored);
+        }
+        socket.close(ignored);
+        buffer.clear();
+    };
+
+    while (true)
+    {
+        Clock::time_point intended;
+        if (openLoop)
+        {
+            intended = next;
+            next += interval;
+            if (intended >= until)
+            {
+                break;
+            }
+            std::this_thread::sleep_until(intended);
+        }
+        else
+        {
+            intended = Clock::now();
+            if (intended >= until)
+            {
+                break;
+            }
+        }
+        bool measured = intended >= measureFrom;
+
+        try
+        {
+            // Ошибка resolve считается как сбой запроса и не роняет поток
+            if (endpoints.empty())
+            {
+                endpoints = resolver.resolve(options_.host, std::to_string(options_.port));
+            }
+            if (!socket.is_open())
+            {
+                asio::connect(socket, endpoints);
+                socket.set_option(tcp::no_delay(true));
+            }
+
+            const std::string& request = requests_[nextRequest++ % requests_.size()];
+            asio::write(socket, asio::buffer(request));
+
+            http::response_parser<http::string_body> parser;
+            parser.body_limit(boost::none);
+            http::read(socket, buffer, parser);
+            auto elapsed = Clock::now() - intended;
+
+            const auto& response = parser.get();
+            if (!options_.keepAlive || !response.keep_alive())
+            {
+                close(true);
+            }
+
+            if (measured)
+            {
+                if (response.result_int() / 100 == 2)
+                {
+                    latency.record(elapsed);
+                    totals.requests.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    totals.errors.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        catch (const std::exception&)
+        {
+            if (measured)
+            {
+                totals.errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            close(true);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    close(false);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Metrics.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file LoadGenerator.hpp
+ * @brief Генератор HTTP/1.1 нагрузки для сквозных замеров сервера
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @brief Параметры нагрузки
+ */
+struct LoadOptions
+{
+    std::string host = "127.0.0.1";
+    unsigned short port = 0;
+    int connections = 4;                                         ///< Поток и соединение на каждое
+    std::chrono::steady_clock::duration warmup = std::chrono::seconds(1);
+    std::chrono::steady_clock::duration duration = std::chrono::seconds(5);
+    double rate = 0;                                             ///< Запросов в секунду всего, 0 - закрытый цикл
+    bool keepAlive = true;                                       ///< false - новое соединение на запрос
+    std::string method = "GET";
+    std::string target = "/";
+    std::vector<std::string> targets;                            ///< Непусто - запросы идут по кругу по ним вместо target
+    std::string body;
+};
+
+/**
+ * @brief Итог замера (без разогрева)
+ */
+struct LoadResult
+{
+    std::uint64_t requests = 0; ///< Ответы 2xx
+    std::uint64_t errors = 0;   ///< Ошибки соединения и ответы не 2xx
+    double seconds = 0;
+    LatencyHistogram::Snapshot latency;
+
+    double rps() const
+    {
+        return seconds > 0 ? static_cast<double>(requests) / seconds : 0;
+    }
+};
+
+/**
+ * @class LoadGenerator
+ * @brief Нагрузка с закрытым или открытым (постоянная частота) циклом
+ *
+ * Каждое соединение обслуживает свой поток с блокирующими сокетами.
+ *
+ * Закрытый цикл: следующий запрос уходит сразу после ответа на
+ * предыдущий, задержка - от отправки до ответа. Так измеряется пропускная
+ * способность, но задержки занижены: пока сервер тормозит, генератор
+ * просто не отправляет запросы (coordinated omission).
+ *
+ * Открытый цикл: запросы соединения назначены по расписанию через равные
+ * интервалы, а задержка считается от назначенного момента, а не от
+ * фактической отправки. Если сервер не успевает, очередь запросов,
+ * которые клиент отправил бы, учитывается в задержке, как в wrk2.
+ */
+class LoadGenerator
+{
+public:
+    explicit LoadGenerator(LoadOptions options);
+
+    /**
+     * @brief Разогреть сервер, выполнить замер и дождаться всех потоков
+     */
+    LoadResult run();
+
+private:
+    struct Totals;
+
+    void worker(int index, std::chrono::steady_clock::time_point measureFrom,
+                std::chrono::steady_clock::time_point until, LatencyHistogram& latency, Totals& totals);
+
+    LoadOptions options_;
+    std::vector<std::string> requests_; ///< Запросы целиком, собраны заранее, по одному на target
+};
@@ -0,0 +1,205 @@
+#include "AllocationCounter.hpp"
+#include "BoostBeastApplication.hpp"
+#include "RouteMatcher.hpp"
+#include "StaticRoutes.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+
+/**
+ * @file RouterBenchmark.cpp
+ * @brief Бенчмарки сопоставления путей и поиска обработчика
+ * @author Anton Tobolkin
+ */
+
+namespace
+{
+
+class NoopHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest&, IResponse&) override {}
+};
+
+// Открывает findHandler и регистрацию маршрутов без запуска сервера
+class BenchApplication : public BoostBeastApplication
+{
+public:
+    using BoostBeastApplication::findHandler;
+
+    void addRoute(const std::string& method, const std::string& pattern)
+    {
+        handlers_[getHandlerKey(method, pattern)] = std::make_shared<NoopHandler>();
+    }
+
+    void build()
+    {
+        compileRoutes();
+    }
+
+protected:
+    void configureInjection() override {}
+};
+
+std::string resource(int index)
+{
+    return "/api/v1/resource" + std::to_string(index);
+}
+
+void BM_RouteMatcherExact(benchmark::State& state)
+{
+    std::string pattern = "/api/v1/users/profile";
+    std::string path = "/api/v1/users/profile";
+
+    AllocationScope allocations(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(RouteMatcher::matches(pattern, path));
+    }
+}
+BENCHMARK(BM_RouteMatcherExact);
+
+void BM_RouteMatcherWildcard(benchmark::State& state)
+{
+    std::string pattern = "/api/*/users/*/profile";
+    std::string path = "/api/v1/users/42/profile";
+
+    AllocationScope allocations(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(RouteMatcher::matches(pattern, path));
+    }
+}
+BENCHMARK(BM_RouteMatcherWildcard);
+
+void BM_RouteMatcherParams(benchmark::State& state)
+{
+    std::string pattern = "/api/{version}/users/{id:int}/profile";
+    std::string path = "/api/v1/users/42/profile";
+    PathParams params;
+
+    AllocationScope allocations(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(RouteMatcher::matches(pattern, path, &params));
+    }
+}
+BENCHMARK(BM_RouteMatcherParams);
+
+// Поиск последнего из N точных маршрутов
+void BM_FindHandlerExact(benchmark::State& state)
+{
+    const int routes = static_cast<int>(state.range(0));
+    BenchApplication app;
+    for (int i = 0; i < routes; ++i)
+    {
+        app.addRoute("GET", resource(i) + "/items");
+    }
+    app.build();
+
+    std::string method = "GET";
+    std::string path = resource(routes - 1) + "/items";
+
+    AllocationScope allocations(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(app.findHandler(method, path));
+    }
+}
+BENCHMARK(BM_FindHandlerExact)->Arg(10)->Arg(100)->Arg(1000);
+
+// То же по разобранному методу, как в обработке запроса: без разбора имени метода
+void BM_FindHandlerExactByVerb(benchmark::State& state)
+{
+    const int routes = static_cast<int>(state.range(0));
+    BenchApplication app;
+    for (int i = 0; i < routes; ++i)
+    {
+        app.addRoute("GET", resource(i) + "/items");
+    }
+    app.build();
+
+    std::string path = resource(routes - 1) + "/items";
+
+    AllocationScope allocations(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(app.findHandler(HttpMethod::Get, "GET", path));
+    }
+}
+BENCHMARK(BM_FindHandlerExactByVerb)->Arg(10)->Arg(100)->Arg(1000);
+
+void noop(IRequest&, IResponse&) {}
+
+constexpr auto kStaticRoutes = makeStaticRoutes({
+    route("GET", "/api/v1/resource0/items", &noop),
+    route("GET", "/api/v1/resource1/items", &noop),
+    route("GET", "/api/v1/resource2/items", &noop),
+    route("GET", "/api/v1/resource3/items", &noop),
+    route("GET", "/api/v1/resource4/items", &noop),
+    route("GET", "/api/v1/resource5/items", &noop),
+    route("GET", "/api/v1/resource6/items", &noop),
+    route("GET", "/api/v1/resource7/items", &noop),
+    route("GET", "/api/v1/resource8/items", &noop),
+    route("GET", "/api/v1/resource9/items", &noop),
+});
+
+// Таблица из 10 маршрутов, построенная компилятором - сравнить с BM_FindHandlerExactByVerb/10
+void BM_StaticRoutesFind(benchmark::State& state)
+{
+    StaticRoutes routes = kStaticRoutes.view();
+    std::string path = "/api/v1/resource9/items";
+
+    AllocationScope allocations(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(routes.find(HttpMethod::Get, path));
+    }
+}
+BENCHMARK(BM_StaticRoutesFind);
+
+// Поиск последнего из N маршрутов с wildcard
+void BM_FindHandlerWildcard(benchmark::State& state)
+{
+    const int routes = static_cast<int>(state.range(0));
+    BenchApplication app;
+    for (int i = 0; i < routes; ++i)
+    {
+        app.addRoute("GET", resource(i) + "/*/details");
+    }
+    app.build();
+
+    std::string method = "GET";
+    std::string path = resource(routes - 1) + "/42/details";
+
+    AllocationScope allocations(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(app.findHandler(method, path));
+    }
+}
+BENCHMARK(BM_FindHandlerWildcard)->Arg(10)->Arg(100)->Arg(1000);
+
+// Промах: 404 проходит тот же путь по дереву
+void BM_FindHandlerMiss(benchmark::State& state)
+{
+    const int routes = static_cast<int>(state.range(0));
+    BenchApplication app;
+    for (int i = 0; i < routes; ++i)
+    {
+        app.addRoute("GET", resource(i) + "/*/details");
+    }
+    app.build();
+
+    std::string method = "GET";
+    std::string path = "/api/v1/missing/42/details";
+
+    AllocationScope allocations(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(app.findHandler(method, path));
+    }
+}
+BENCHMARK(BM_FindHandlerMiss)->Arg(10)->Arg(100)->Arg(1000);
+
+} // namespace
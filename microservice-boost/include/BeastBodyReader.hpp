@@ -0,0 +1,127 @@
+#pragma once
+
+#include "IBodyReader.hpp"
+#include "RequestArena.hpp"
+#include "TimerWheel.hpp"
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <chrono>
+#include <sys/socket.h>
+
+/**
+ * @file BeastBodyReader.hpp
+ * @brief Потоковое чтение тела запроса через http::buffer_body
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class BeastBodyReader
+ * @brief IBodyReader поверх парсера с buffer_body
+ *
+ * Каждый read() отдаёт парсеру буфер вызывающего и читает из сокета,
+ * пока в него не попадёт хотя бы один байт тела: память не зависит от
+ * размера тела. Чтение синхронное и работает во всех режимах сервера
+ * (asio ждёт готовности неблокирующего сокета через poll); асинхронные
+ * режимы вызывают потоковые обработчики вне потоков io_context.
+ *
+ * Тело целиком, от первого read() до последнего байта, ограничено одним
+ * сроком bodyTimeout: по истечении shutdown() прерывает чтение. Ошибки
+ * (в том числе http::error::body_limit) выбрасываются как beast::system_error.
+ */
+class BeastBodyReader : public IBodyReader
+{
+public:
+    using Parser = boost::beast::http::request_parser<boost::beast::http::buffer_body, RequestArena::Allocator>;
+
+    /**
+     * @param deadlines Колесо сроков (nullptr - без срока)
+     */
+    BeastBodyReader(boost::asio::ip::tcp::socket& socket, boost::beast::flat_buffer& buffer,
+                    Parser& parser, TimerWheel* deadlines,
+                    std::chrono::steady_clock::duration bodyTimeout)
+        : socket_(socket),
+          buffer_(buffer),
+          parser_(parser),
+          deadlines_(deadlines),
+          bodyTimeout_(bodyTimeout),
+          deadline_([fd = socket.native_handle()] { ::shutdown(fd, SHUT_RDWR); })
+    {
+    }
+
+    std::size_t read(char* data, std::size_t size) override
+    {
+        namespace http = boost::beast::http;
+
+        if (size == 0 || parser_.is_done())
+        {
+            return 0;
+        }
+
+        auto& body = parser_.get().body();
+        body.data = data;
+        body.size = size;
+        body.more = true;
+
+        // Один срок на всё тело: ставится первым read(), снимается с концом тела
+        if (deadlines_ && !armed_)
+        {
+            deadlines_->schedule(deadline_, bodyTimeout_);
+            armed_ = true;
+        }
+
+        boost::beast::error_code ec;
+        while (body.size == size && !parser_.is_done())
+        {
+            http::read_some(socket_, buffer_, parser_, ec);
+            if (ec == http::error::need_buffer)
+            {
+                ec = {};
+                break;
+            }
+            if (ec)
+            {
+                break;
+            }
+        }
+
+        if (armed_ && (ec || parser_.is_done()))
+        {
+            deadlines_->cancel(deadline_);
+            armed_ = false;
+        }
+
+        if (ec)
+        {
+            throw boost::beast::system_error{ec};
+        }
+        return size - body.size;
+    }
+
+    std::optional<std::uint64_t> contentLength() const override
+    {
+        auto length = parser_.content_length();
+        if (!length)
+        {
+            return std::nullopt;
+        }
+        return *length;
+    }
+
+    /**
+     * @brief Тело прочитано целиком (соединение можно использовать дальше)
+     */
+    bool done() const
+    {
+        return parser_.is_done();
+    }
+
+private:
+    boost::asio::ip::tcp::socket& socket_;
+    boost::beast::flat_buffer& buffer_;
+    Parser& parser_;
+    TimerWheel* deadlines_;
+    std::chrono::steady_clock::duration bodyTimeout_;
+    TimerWheel::Timer deadline_;
+    bool armed_ = false;
+};
@@ -1,9 +1,16 @@
 // BeastRequestAdapter.hpp
 #pragma once
+#include "HttpMethod.hpp"
 #include "IRequest.hpp"
+#include "PathParams.hpp"
+#include "QueryParams.hpp"
+#include "RequestArena.hpp"
 #include <boost/beast/http.hpp>
 #include <map>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 /**
  * @file BeastRequestAdapter.hpp
@@ -12,52 +19,166 @@
  */
 struct BeastRequestAdapter : IRequest
 {
-    BeastRequestAdapter(
-        const boost::beast::http::request<boost::beast::http::string_body>& req,
-        const std::string& clientIp)
-        : req_(req), ip_(clientIp) {}
+    using PlainRequest = boost::beast::http::request<boost::beast::http::string_body>;
+    using PlainRequestHeader = boost::beast::http::request_header<>;
+
+    BeastRequestAdapter(const ArenaRequest& req, const std::string& clientIp)
+        : arenaReq_(&req), body_(req.body()), ip_(clientIp), query_(queryOf(req), arena()) {}
+
+    /**
+     * @brief Запрос без буферизованного тела (потоковые обработчики)
+     */
+    BeastRequestAdapter(const ArenaRequestHeader& header, const std::string& clientIp)
+        : arenaReq_(&header), ip_(clientIp), query_(queryOf(header), arena()) {}
+
+    /**
+     * @brief Запрос с обычными (не ареновыми) заголовками; arena() - куча
+     */
+    BeastRequestAdapter(const PlainRequest& req, const std::string& clientIp)
+        : plainReq_(&req), body_(req.body()), ip_(clientIp), query_(queryOf(req)) {}
+
+    BeastRequestAdapter(const PlainRequestHeader& header, const std::string& clientIp)
+        : plainReq_(&header), ip_(clientIp), query_(queryOf(header)) {}
 
     std::string getPath() const override
     {
-        auto target = std::string(req_.target());
-        auto pos = target.find('?');
-        return pos == std::string::npos ? target : target.substr(0, pos);
+        return std::string(path());
+    }
+
+    std::string_view path() const override
+    {
+        auto target = withHeader([](const auto& req) { return req.target(); });
+        std::string_view view(target.data(), target.size());
+        return view.substr(0, view.find('?'));
+    }
+
+    const PathParams& getPathParams() const override
+    {
+        return pathParams_;
+    }
+
+    /**
+     * @brief Сегменты пути, которые заполняет маршрутизатор
+     */
+    PathParams& pathParams()
+    {
+        return pathParams_;
+    }
+
+    /**
+     * @brief Метод запроса без копирования строки (Other - нестандартный)
+     */
+    HttpMethod method() const
+    {
+        return toHttpMethod(withHeader([](const auto& req) { return req.method(); }));
+    }
+
+    static HttpMethod toHttpMethod(boost::beast::http::verb verb)
+    {
+        namespace http = boost::beast::http;
+        switch (verb)
+        {
+        case http::verb::get: return HttpMethod::Get;
+        case http::verb::head: return HttpMethod::Head;
+        case http::verb::post: return HttpMethod::Post;
+        case http::verb::put: return HttpMethod::Put;
+        case http::verb::delete_: return HttpMethod::Delete;
+        case http::verb::connect: return HttpMethod::Connect;
+        case http::verb::options: return HttpMethod::Options;
+        case http::verb::trace: return HttpMethod::Trace;
+        case http::verb::patch: return HttpMethod::Patch;
+        default: return HttpMethod::Other;
+        }
+    }
+
+    /**
+     * @brief Имя метода - view в запрос
+     */
+    std::string_view methodName() const
+    {
+        auto name = withHeader([](const auto& req) { return req.method_string(); });
+        return std::string_view(name.data(), name.size());
     }
 
     std::string getMethod() const override
     {
-        return std::string(req_.method_string());
+        return std::string(methodName());
     }
 
     std::string getBody() const override
     {
-        return req_.body();
+        return std::string(body_);
+    }
+
+    std::string_view body() const override
+    {
+        return body_;
+    }
+
+    /**
+     * @brief Арена запроса, в которой разобраны его заголовки
+     */
+    std::pmr::memory_resource* arena() const override
+    {
+        return arenaReq_ ? arenaReq_->get_allocator().resource() : std::pmr::get_default_resource();
+    }
+
+    using IRequest::header;
+
+    std::string_view header(std::string_view name) const override
+    {
+        // basic_fields ищет имя без учёта регистра
+        return withHeader([name](const auto& req) {
+            return fieldValue(req, req.find(boost::beast::string_view(name.data(), name.size())));
+        });
+    }
+
+    /**
+     * @brief Значение заголовка по полю Beast, без копирования
+     */
+    std::string_view header(boost::beast::http::field field) const
+    {
+        return withHeader([field](const auto& req) { return fieldValue(req, req.find(field)); });
     }
 
+    std::optional<std::string_view> param(std::string_view name) const override
+    {
+        return query_.get(name);
+    }
+
+    /**
+     * @brief Параметры query string: разбираются один раз, при первом обращении
+     */
+    const QueryParams& query() const
+    {
+        return query_;
+    }
+
+    /**
+     * @brief Параметры query string как есть, без декодирования
+     *
+     * При повторе ключа - последнее значение; разбор останавливается на
+     * первой паре без '='. Декодированные значения - param() и query().
+     */
     std::map<std::string, std::string> getParams() const override
     {
         std::map<std::string, std::string> params;
-        auto target = std::string(req_.target());
-        auto pos = target.find('?');
-        if (pos == std::string::npos)
-            return params;
-
-        std::string query = target.substr(pos + 1);
+        std::string_view query = withHeader([](const auto& req) { return queryOf(req); });
         size_t start = 0;
         while (start < query.size())
         {
             auto eq = query.find('=', start);
             auto amp = query.find('&', start);
-            if (eq == std::string::npos)
+            if (eq == std::string_view::npos)
                 break;
 
-            std::string key = query.substr(start, eq - start);
-            std::string value = amp == std::string::npos
-                                    ? query.substr(eq + 1)
-                                    : query.substr(eq + 1, amp - eq - 1);
+            std::string key(query.substr(start, eq - start));
+            std::string value(amp == std::string_view::npos
+                                  ? query.substr(eq + 1)
+                                  : query.substr(eq + 1, amp - eq - 1));
 
             params[key] = value;
-            if (amp == std::string::npos)
+            if (amp == std::string_view::npos)
                 break;
             start = amp + 1;
         }
@@ -68,12 +189,14 @@ struct BeastRequestAdapter : IRequest
     {
         std::map<std::string, std::string> headers;
         
-        for (auto const& field : req_)
-        {
-            std::string name = std::string(field.name_string());
-            std::string value = std::string(field.value());
-            headers[name] = value;
-        }
+        withHeader([&headers](const auto& req) {
+            for (auto const& field : req)
+            {
+                std::string name = std::string(field.name_string());
+                std::string value = std::string(field.value());
+                headers[name] = value;
+            }
+        });
         
         return headers;
     }
@@ -83,12 +206,76 @@ struct BeastRequestAdapter : IRequest
         return ip_;
     }
 
+    /**
+     * @brief IP клиента без копирования строки
+     */
+    std::string_view ip() const
+    {
+        return ip_;
+    }
+
     int getPort() const override
     {
         return 80;
     }
 
+    const RequestTiming* timing() const override
+    {
+        return timing_;
+    }
+
+    /**
+     * @brief Подключить отметки времени, которые ведёт сессия
+     */
+    void setTiming(RequestTiming* timing)
+    {
+        timing_ = timing;
+    }
+
+    /**
+     * @brief Поставить отметку, если отметки подключены
+     */
+    void mark(RequestTiming::Mark which)
+    {
+        if (timing_)
+        {
+            timing_->mark(which);
+        }
+    }
+
 private:
-    const boost::beast::http::request<boost::beast::http::string_body>& req_;
+    // Возвращаемый тип задан явно: вызовы стоят в классе выше определения
+    template <class F>
+    std::invoke_result_t<F, const ArenaRequestHeader&> withHeader(F&& f) const
+    {
+        return arenaReq_ ? f(*arenaReq_) : f(*plainReq_);
+    }
+
+    template <class Header>
+    static std::string_view fieldValue(const Header& req, typename Header::const_iterator it)
+    {
+        if (it == req.end())
+        {
+            return {};
+        }
+        auto value = it->value();
+        return std::string_view(value.data(), value.size());
+    }
+
+    template <class Header>
+    static std::string_view queryOf(const Header& header)
+    {
+        auto target = header.target();
+        std::string_view view(target.data(), target.size());
+        auto pos = view.find('?');
+        return pos == std::string_view::npos ? std::string_view() : view.substr(pos + 1);
+    }
+
+    const ArenaRequestHeader* arenaReq_ = nullptr; ///< Ровно один из двух заголовков
+    const PlainRequestHeader* plainReq_ = nullptr;
+    std::string_view body_;   ///< Пусто, если тело читается потоком
     std::string ip_;
+    PathParams pathParams_;
+    QueryParams query_;
+    RequestTiming* timing_ = nullptr;
 };
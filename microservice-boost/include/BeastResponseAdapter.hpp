@@ -1,7 +1,13 @@
 #pragma once
+#include "BeastResponseStream.hpp"
+#include "RequestArena.hpp"
 #include "IResponse.hpp"
 #include <boost/beast/http.hpp>
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 
 /**
  * @file BeastResponseAdapter.hpp
@@ -9,21 +15,102 @@
  * @author Anton Tobolkin
  */
 struct BeastResponseAdapter : IResponse {
-    BeastResponseAdapter(boost::beast::http::response<boost::beast::http::string_body>& res)
-        : res_(res) {}
+    using PlainResponse = boost::beast::http::response<boost::beast::http::string_body>;
+
+    BeastResponseAdapter(ArenaResponse& res,
+                         BeastResponseStream* stream = nullptr)
+        : arenaRes_(&res), body_(res.body()), stream_(stream) {}
+
+    /**
+     * @brief Ответ с обычными (не ареновыми) заголовками, без отправки порциями
+     */
+    BeastResponseAdapter(PlainResponse& res)
+        : plainRes_(&res), body_(res.body()), stream_(nullptr) {}
 
     void setStatus(int code) override {
-        res_.result(boost::beast::http::status(code));
+        withResponse([code](auto& res) { res.result(boost::beast::http::status(code)); });
     }
 
     void setBody(const std::string& body) override {
-        res_.body() = body;
+        resetBody();
+        body_ = body;
+    }
+
+    void setBody(std::string&& body) override {
+        resetBody();
+        body_ = std::move(body);
+    }
+
+    void reserveBody(std::size_t bytes) override {
+        resetBody();
+        body_.reserve(bytes);
+    }
+
+    void appendBody(std::string_view data) override {
+        resetBody();
+        body_.append(data);
+    }
+
+    void setSharedBody(std::shared_ptr<const std::string> body) override {
+        resetBody();
+        if (!body) {
+            // nullptr - пустое тело
+            body_.clear();
+        } else if (stream_) {
+            stream_->setBuffer(std::move(body));
+        } else {
+            body_ = *body;
+        }
     }
 
     void setHeader(const std::string& name, const std::string& value) override {
-        res_.set(name, value);
+        withResponse([&](auto& res) { res.set(name, value); });
+    }
+
+    void write(std::string_view chunk) override {
+        resetBody();
+        if (stream_) {
+            stream_->write(chunk);
+        } else {
+            body_.append(chunk);
+        }
+    }
+
+    void end() override {
+        if (stream_) {
+            stream_->finish();
+        }
+    }
+
+    void setFileBody(std::shared_ptr<const int> fd, std::uint64_t size) override {
+        resetBody();
+        if (stream_) {
+            stream_->setFile(std::move(fd), size);
+        } else {
+            IResponse::setFileBody(std::move(fd), size);
+        }
     }
 
 private:
-    boost::beast::http::response<boost::beast::http::string_body>& res_;
+    template <class F>
+    void withResponse(F&& f) {
+        if (arenaRes_) {
+            f(*arenaRes_);
+        } else {
+            f(*plainRes_);
+        }
+    }
+
+    // Каждый setter тела заменяет ранее заданные общий буфер и файл
+    void resetBody() {
+        if (stream_) {
+            stream_->setBuffer(nullptr);
+            stream_->setFile(nullptr, 0);
+        }
+    }
+
+    ArenaResponse* arenaRes_ = nullptr; ///< Ровно один из двух ответов
+    PlainResponse* plainRes_ = nullptr;
+    std::string& body_;
+    BeastResponseStream* stream_; ///< nullptr - порции копятся в теле
 };
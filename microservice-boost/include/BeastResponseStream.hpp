@@ -0,0 +1,521 @@
+#pragma once
+
+#include "RequestArena.hpp"
+#include "TimerWheel.hpp"
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <poll.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+
+/**
+ * @file BeastResponseStream.hpp
+ * @brief Потоковая отправка ответа chunked transfer encoding
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class BeastResponseStream
+ * @brief Отправляет заголовки ответа сразу, а тело - порциями по мере записи
+ *
+ * Первый write() сериализует статус и заголовки ответа (http::serializer
+ * над empty_body с Transfer-Encoding: chunked), каждый следующий -
+ * отдельный chunk. Как именно они уходят, задаёт Mode:
+ *
+ * - Blocking (поток на соединение, обработчики в пуле blocking) - запись
+ *   синхронная: обработчик ждёт, пока ядро примет данные, и не может
+ *   обогнать медленного клиента (flow control без буферизации в памяти).
+ *   Весь ответ ограничен одним сроком writeTimeout от первой записи до
+ *   finish(): по истечении shutdown() прерывает запись. Ошибка записи
+ *   выбрасывается как beast::system_error, после неё соединение не
+ *   используется.
+ * - Deferred (обработчики на потоках io_context) - write() сразу отдаёт
+ *   ядру то, что оно примет без ожидания (send с MSG_DONTWAIT), остальное
+ *   копится в памяти, но не больше maxPending байт: сверх этого write()
+ *   ждёт, пока клиент примет данные, каждый раз не дольше writeTimeout
+ *   (поток io_context на это время занят). После обработчика сессия
+ *   отправляет накопленное (output()) асинхронно. Ошибка записи
+ *   выбрасывается так же, как в Blocking.
+ *
+ * Клиентам HTTP/1.0 chunked недоступен - порции копятся в теле ответа.
+ *
+ * Тело из файла (setFile) отправляется при finish(): заголовки с
+ * Content-Length, затем sendfile(2) из дескриптора прямо в сокет. В
+ * режиме Deferred finish() только готовит заголовки, а файл сессия
+ * отправляет sendFileSome() по мере готовности сокета к записи.
+ * Общий буфер (setBuffer) тоже отправляется при finish(), одной записью
+ * с заголовками, без копирования в тело ответа.
+ */
+class BeastResponseStream
+{
+public:
+    using Response = ArenaResponse;
+
+    /// Deferred: сколько неотправленных байт ответа копится, пока write() не начнёт ждать клиента
+    static constexpr std::size_t maxPending = 256 * 1024;
+
+    /**
+     * @brief Как уходят записанные данные (см. описание класса)
+     */
+    enum class Mode
+    {
+        Blocking,
+        Deferred
+    };
+
+    /**
+     * @param deadlines Колесо сроков (nullptr - без срока)
+     */
+    BeastResponseStream(boost::asio::ip::tcp::socket& socket, Response& res, TimerWheel* deadlines,
+                        std::chrono::steady_clock::duration writeTimeout, Mode mode = Mode::Blocking)
+        : socket_(socket),
+          res_(res),
+          deadlines_(deadlines),
+          writeTimeout_(writeTimeout),
+          deadline_([fd = socket.native_handle()] { ::shutdown(fd, SHUT_RDWR); }),
+          mode_(mode)
+    {
+    }
+
+    BeastResponseStream(const BeastResponseStream&) = delete;
+    BeastResponseStream& operator=(const BeastResponseStream&) = delete;
+
+    /**
+     * @brief Отправить порцию тела (первый вызов отправляет и заголовки)
+     */
+    void write(std::string_view chunk)
+    {
+        namespace http = boost::beast::http;
+
+        if (res_.version() < 11)
+        {
+            res_.body().append(chunk);
+            return;
+        }
+        if (finished_ && !failed_)
+        {
+            return;
+        }
+
+        if (!started_)
+        {
+            started_ = true;
+            res_.erase(http::field::content_length);
+            res_.chunked(true);
+            sendHeader();
+            if (mode_ == Mode::Deferred && chunk.empty())
+            {
+                flush();
+            }
+        }
+
+        // Пустой chunk означал бы конец тела
+        if (!chunk.empty())
+        {
+            chunkBytes_ += chunk.size();
+            auto framed = http::make_chunk(boost::asio::buffer(chunk.data(), chunk.size()));
+            if (mode_ == Mode::Deferred)
+            {
+                append(framed);
+                flush();
+                return;
+            }
+            send([&](boost::beast::error_code& ec) { boost::asio::write(socket_, framed, ec); });
+        }
+    }
+
+    /**
+     * @brief Отправить тело из файла при finish() (nullptr - отменить)
+     */
+    void setFile(std::shared_ptr<const int> fd, std::uint64_t size)
+    {
+        if (started_ && fd)
+        {
+            throw std::logic_error("BeastResponseStream: file body after streamed chunks");
+        }
+        file_ = std::move(fd);
+        fileSize_ = file_ ? size : 0;
+    }
+
+    /**
+     * @brief Отправить тело из общего буфера при finish() (nullptr - отменить)
+     */
+    void setBuffer(std::shared_ptr<const std::string> buffer)
+    {
+        if (started_ && buffer)
+        {
+            throw std::logic_error("BeastResponseStream: shared body after streamed chunks");
+        }
+        buffer_ = std::move(buffer);
+    }
+
+    /**
+     * @brief Размер тела ответа: chunk-и, файл, общий буфер или обычное тело
+     */
+    std::uint64_t bodySize() const
+    {
+        if (file_)
+        {
+            return fileSize_;
+        }
+        if (buffer_)
+        {
+            return buffer_->size();
+        }
+        return started_ ? chunkBytes_ : res_.body().size();
+    }
+
+    /**
+     * @brief Завершить ответ: отправить файл, буфер или завершающий chunk
+     */
+    void finish()
+    {
+        if (file_ && !started_)
+        {
+            sendFile();
+            disarm();
+            return;
+        }
+        if (buffer_ && !started_)
+        {
+            sendBuffer();
+            disarm();
+            return;
+        }
+        if (!started_ || finished_ || failed_)
+        {
+            return;
+        }
+        finished_ = true;
+        if (mode_ == Mode::Deferred)
+        {
+            append(boost::beast::http::make_chunk_last());
+            return;
+        }
+        send([&](boost::beast::error_code& ec) {
+            boost::asio::write(socket_, boost::beast::http::make_chunk_last(), ec);
+        });
+        disarm();
+    }
+
+    /**
+     * @brief Режим Deferred: байты ответа для отправки после finish()
+     *
+     * Не отправленные ещё заголовки и chunk-и, затем общий буфер, если тело в нём. Буферы
+     * действительны, пока жив поток и общий буфер не заменён.
+     */
+    std::array<boost::asio::const_buffer, 2> output() const
+    {
+        return {boost::asio::buffer(pending_.data() + sent_, pending_.size() - sent_),
+                bufferBody_ ? boost::asio::buffer(*buffer_) : boost::asio::const_buffer{}};
+    }
+
+    /**
+     * @brief Режим Deferred: после output() осталось отправить файл (sendFileSome)
+     */
+    bool filePending() const
+    {
+        return file_ && finished_ && static_cast<std::uint64_t>(fileOffset_) < fileSize_;
+    }
+
+    /**
+     * @brief Отправить файл sendfile(2), пока сокет принимает данные без ожидания
+     *
+     * ec == would_block - сокет заполнен, продолжить после готовности к
+     * записи; пустой ec при !filePending() - файл отправлен целиком.
+     */
+    void sendFileSome(boost::beast::error_code& ec)
+    {
+        if (mode_ == Mode::Deferred)
+        {
+            socket_.native_non_blocking(true, ec);
+            if (ec)
+            {
+                return;
+            }
+        }
+        while (static_cast<std::uint64_t>(fileOffset_) < fileSize_)
+        {
+            std::uint64_t left = fileSize_ - static_cast<std::uint64_t>(fileOffset_);
+            ssize_t n = ::sendfile(socket_.native_handle(), *file_, &fileOffset_,
+                                   static_cast<std::size_t>(std::min<std::uint64_t>(left, 1 << 30)));
+            if (n > 0)
+            {
+                continue;
+            }
+            if (n == 0)
+            {
+                // Файл укоротился после stat - Content-Length уже не выполнить
+                ec = boost::asio::error::eof;
+                return;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                ec = boost::asio::error::would_block;
+                return;
+            }
+            if (errno != EINTR)
+            {
+                ec.assign(errno, boost::system::system_category());
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Ответ отправляет поток (chunk-и или файл), а не сессия обычным путём
+     */
+    bool started() const
+    {
+        return started_ || file_ || buffer_;
+    }
+
+    /**
+     * @brief Заголовки ответа уже записаны (в сокет или в output()) и больше не меняются
+     *
+     * Для файла и общего буфера заголовки уходят только при finish(), до
+     * этого их ещё можно дополнить.
+     */
+    bool headersSent() const
+    {
+        return started_;
+    }
+
+    /**
+     * @brief Запись завершилась ошибкой, соединение нужно закрыть
+     */
+    bool failed() const
+    {
+        return failed_;
+    }
+
+private:
+    void sendBuffer()
+    {
+        namespace http = boost::beast::http;
+
+        started_ = true;
+        finished_ = true;
+        res_.body().clear();
+
+        if (mode_ == Mode::Deferred)
+        {
+            // Тело остаётся в общем буфере: output() отдаёт его вслед за заголовками
+            bufferBody_ = true;
+            res_.content_length(buffer_->size());
+            sendHeader();
+            return;
+        }
+
+        // buffer_body ссылается на буфер: заголовки и тело уходят одной записью
+        http::response<http::buffer_body, ArenaFields> response{static_cast<const ArenaResponseHeader&>(res_)};
+        response.body().data = const_cast<char*>(buffer_->data());
+        response.body().size = buffer_->size();
+        response.body().more = false;
+        response.content_length(buffer_->size());
+        send([&](boost::beast::error_code& ec) { http::write(socket_, response, ec); });
+    }
+
+    void sendFile()
+    {
+        started_ = true;
+        finished_ = true;
+        res_.body().clear();
+        res_.content_length(fileSize_);
+        sendHeader();
+        if (mode_ == Mode::Deferred)
+        {
+            // Файл отправляет сессия после output(): sendFileSome() по готовности сокета
+            return;
+        }
+
+        // Блокирующий сокет ждёт клиента в самом sendfile(2); срок прерывает
+        // ожидание через shutdown()
+        send([&](boost::beast::error_code& ec) {
+            sendFileSome(ec);
+            while (ec == boost::asio::error::would_block)
+            {
+                pollfd pfd{};
+                pfd.fd = socket_.native_handle();
+                pfd.events = POLLOUT;
+                ::poll(&pfd, 1, -1);
+                ec = {};
+                sendFileSome(ec);
+            }
+        });
+    }
+
+    // Заголовки в сокет (Blocking) или в output() (Deferred)
+    void sendHeader()
+    {
+        namespace http = boost::beast::http;
+
+        http::response<http::empty_body, ArenaFields> head{static_cast<const ArenaResponseHeader&>(res_)};
+        http::response_serializer<http::empty_body, ArenaFields> serializer{head};
+        if (mode_ == Mode::Blocking)
+        {
+            send([&](boost::beast::error_code& ec) { http::write_header(socket_, serializer, ec); });
+            return;
+        }
+
+        serializer.split(true);
+        boost::beast::error_code ec;
+        while (!serializer.is_header_done())
+        {
+            serializer.next(ec, [&](boost::beast::error_code&, const auto& buffers) {
+                append(buffers);
+                serializer.consume(boost::beast::buffer_bytes(buffers));
+            });
+        }
+    }
+
+    // Deferred: отдать ядру накопленное; больше maxPending байт не копится -
+    // тогда обработчик ждёт клиента, как в Blocking
+    void flush()
+    {
+        if (failed_)
+        {
+            throw boost::beast::system_error{boost::asio::error::broken_pipe};
+        }
+
+        boost::beast::error_code ec;
+        sendPending(ec);
+        if (!ec && pending_.size() - sent_ > maxPending)
+        {
+            // Срок на каждое ожидание, а не на весь ответ: обработчик может
+            // готовить данные сколько угодно, пока клиент их принимает
+            arm();
+            while (!ec && pending_.size() - sent_ > maxPending)
+            {
+                pollfd pfd{};
+                pfd.fd = socket_.native_handle();
+                pfd.events = POLLOUT;
+                ::poll(&pfd, 1, -1);
+                sendPending(ec);
+            }
+            disarm();
+        }
+        if (ec)
+        {
+            failed_ = true;
+            throw boost::beast::system_error{ec};
+        }
+
+        // Принятое ядром удаляется, когда его больше половины: сдвиг не
+        // повторяется на каждой маленькой записи
+        if (sent_ == pending_.size())
+        {
+            pending_.clear();
+            sent_ = 0;
+        }
+        else if (sent_ > pending_.size() / 2)
+        {
+            pending_.erase(0, sent_);
+            sent_ = 0;
+        }
+    }
+
+    // Отдать ядру pending_, пока оно принимает без ожидания
+    void sendPending(boost::beast::error_code& ec)
+    {
+        while (sent_ < pending_.size())
+        {
+            ssize_t n = ::send(socket_.native_handle(), pending_.data() + sent_, pending_.size() - sent_,
+                               MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n >= 0)
+            {
+                sent_ += static_cast<std::size_t>(n);
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return;
+            }
+            if (errno != EINTR)
+            {
+                ec.assign(errno, boost::system::system_category());
+                return;
+            }
+        }
+    }
+
+    template<class Buffers>
+    void append(const Buffers& buffers)
+    {
+        for (auto buffer : boost::beast::buffers_range_ref(buffers))
+        {
+            pending_.append(static_cast<const char*>(buffer.data()), buffer.size());
+        }
+    }
+
+    template<class Operation>
+    void send(Operation&& operation)
+    {
+        if (failed_)
+        {
+            throw boost::beast::system_error{boost::asio::error::broken_pipe};
+        }
+
+        // Один срок на весь ответ: ставится первой записью, снимается в finish()
+        arm();
+
+        boost::beast::error_code ec;
+        operation(ec);
+
+        if (ec)
+        {
+            failed_ = true;
+            disarm();
+            throw boost::beast::system_error{ec};
+        }
+    }
+
+    void arm()
+    {
+        if (deadlines_ && !armed_)
+        {
+            deadlines_->schedule(deadline_, writeTimeout_);
+            armed_ = true;
+        }
+    }
+
+    void disarm()
+    {
+        if (armed_)
+        {
+            deadlines_->cancel(deadline_);
+            armed_ = false;
+        }
+    }
+
+    boost::asio::ip::tcp::socket& socket_;
+    Response& res_;
+    TimerWheel* deadlines_;
+    std::chrono::steady_clock::duration writeTimeout_;
+    TimerWheel::Timer deadline_;
+    Mode mode_;
+    std::string pending_; ///< Deferred: заголовки и chunk-и для output()
+    std::size_t sent_ = 0; ///< Deferred: начало pending_, уже принятое ядром
+    std::shared_ptr<const int> file_;
+    std::uint64_t fileSize_ = 0;
+    off_t fileOffset_ = 0; ///< Сколько файла уже отправлено
+    std::shared_ptr<const std::string> buffer_;
+    std::uint64_t chunkBytes_ = 0;
+    bool started_ = false;
+    bool finished_ = false;
+    bool failed_ = false;
+    bool armed_ = false;
+    bool bufferBody_ = false; ///< Deferred: output() включает общий буфер
+};
@@ -1,16 +1,35 @@
 #pragma once
 #include "IWebApplication.hpp"
+#include "AccessLog.hpp"
+#include "Metrics.hpp"
 #include "IHttpHandler.hpp"
+#include "IRequestTimingExporter.hpp"
+#include "AdmissionControl.hpp"
+#include "Router.hpp"
+#include "StaticRoutes.hpp"
+#include "SessionRegistry.hpp"
+#include "TimerWheel.hpp"
+#include "settings/ServerSettings.hpp"
+#include "HttpSession.hpp"
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/beast/http.hpp>
 #include <nlohmann/json.hpp>
+#ifdef MICROSERVICE_COROUTINES
+#include <boost/asio/awaitable.hpp>
+#endif
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <map>
+#include <thread>
+#include <vector>
 
-class IRequest;
 class IResponse;
+struct BeastRequestAdapter;
 
 class BoostBeastApplication : public IWebApplication
 {
@@ -19,26 +38,171 @@ public:
     virtual ~BoostBeastApplication();
 
     void start() override;
+
+    /**
+     * @brief Остановить сервер с graceful drain
+     *
+     * Прекращает приём соединений, сразу закрывает простаивающие keep-alive
+     * соединения и ждёт завершения запросов в обработке не дольше
+     * server.drain_timeout, после чего закрывает оставшиеся принудительно.
+     * Блокирует вызывающий поток; не вызывать из обработчика запроса.
+     * Вызов до start() (или пока start() ещё не начал приём) отменяет
+     * запуск: start() вернётся, не обслужив ни одного соединения.
+     */
     void stop();
     void loadEnvironment(int argc, char* argv[]) override;
 
+    /**
+     * @brief Число открытых клиентских соединений во всех режимах
+     */
+    std::size_t activeSessions() const;
+
 protected:
     std::map<std::string, std::shared_ptr<IHttpHandler>> handlers_;
     
-    std::shared_ptr<IHttpHandler> findHandler(const std::string& method, const std::string& path);
+    /**
+     * @brief Найти обработчик по маршрутам, скомпилированным из handlers_ в start()
+     * @param params Куда сложить сегменты {name} - string_view в path
+     */
+    std::shared_ptr<IHttpHandler> findHandler(std::string_view method, std::string_view path,
+                                              PathParams* params = nullptr) const;
+
+    /**
+     * @brief Найти обработчик по разобранному методу (таблица по HttpMethod)
+     * @param methodName Имя метода, нужно только для HttpMethod::Other
+     */
+    std::shared_ptr<IHttpHandler> findHandler(HttpMethod method, std::string_view methodName,
+                                              std::string_view path, PathParams* params = nullptr) const;
     std::string getHandlerKey(const std::string& method, const std::string& pattern) const;
 
+    /**
+     * @brief Собрать маршрутизатор из handlers_ (start() вызывает сам)
+     */
+    void compileRoutes();
+
+    /**
+     * @brief Подключить таблицу маршрутов, построенную компилятором
+     *
+     * Проверяется раньше handlers_: точный путь из таблицы обрабатывает
+     * функция без поиска по дереву и без виртуального вызова. Таблица
+     * должна жить дольше приложения (static constexpr).
+     */
+    void setStaticRoutes(StaticRoutes routes);
+
+    /**
+     * @brief Реестр метрик: счётчики и gauge приложения регистрируются до start()
+     *
+     * Время обработки запросов записывается при metrics.enabled = true.
+     */
+    MetricsRegistry& metrics();
+
+    /**
+     * @brief Получатель отметок времени каждого запроса (вызывать до start())
+     */
+    void setTimingExporter(std::shared_ptr<IRequestTimingExporter> exporter);
+
 private:
+    AdmissionControl admission_; ///< Должен пережить io_context: сессии держат его слоты
+    SessionRegistry sessions_;   ///< Аналогично: сессии снимают регистрацию при уничтожении
+    std::unique_ptr<TimerWheel> deadlines_; ///< Аналогично: сессии снимают с него свои сроки
+    std::unique_ptr<AccessLog> accessLog_;  ///< Аналогично: пишут обработчики сессий; nullptr - выключен
+    MetricsRegistry metrics_;               ///< Аналогично
+    bool metricsEnabled_ = false;
+    bool serverTiming_ = false;         ///< Добавлять заголовок Server-Timing
+    std::shared_ptr<IRequestTimingExporter> timingExporter_;
+    std::chrono::steady_clock::duration drainTimeout_;
+    OverloadPolicy overloadPolicy_;
+    std::string overloadResponse_; ///< Готовый ответ 503 с Retry-After
+    std::string tooLargeResponse_; ///< Готовый ответ 413 для тела больше лимита
+    Router router_;                ///< Маршруты handlers_, собираются в start()
+    bool responseStreams_ = false; ///< Есть обработчики со streamsResponse()
+    StaticRoutes staticRoutes_;    ///< Маршруты, известные при компиляции
+
     std::unique_ptr<boost::asio::io_context> ioContext_;
     std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor_;
-    bool running_;
+    /**
+     * @brief Шард режима SO_REUSEPORT: собственный io_context и acceptor
+     *
+     * У каждого шарда свои лимиты (доля общих): у каждого acceptor своя
+     * очередь в ядре, и общий слот, зарезервированный простаивающим шардом,
+     * не должен блокировать соединения, пришедшие в другой шард.
+     */
+    struct Shard
+    {
+        std::unique_ptr<AdmissionControl> admission;
+        std::unique_ptr<TimerWheel> deadlines;
+        HttpSession::Options sessionOptions;
+        std::unique_ptr<boost::asio::io_context> ioContext;
+        std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor;
+    };
+
+    std::vector<Shard> shards_;
+    std::vector<std::thread> workers_; ///< Потоки пула или шардов
+    std::unique_ptr<boost::asio::thread_pool> blockingPool_; ///< Потоковые обработчики асинхронных режимов
+    ServerMode mode_;
+    HttpSession::Options sessionOptions_; ///< Параметры keep-alive для всех режимов
+    std::atomic<bool> running_;
+    std::atomic<bool> stopRequested_; ///< stop() вызван; start() проверяет его и сбрасывает при выходе
 
-    void handleSession(boost::asio::ip::tcp::socket socket);
+    /// Перейти в running_, если stop() не был вызван раньше
+    bool beginRunning();
+
+    void runThreadPerConnection();
+    void runPool(int threads);
+    void runReusePort(const boost::asio::ip::tcp::endpoint& endpoint, int threads,
+                      std::size_t maxConnections, std::size_t maxInflight);
+    void doAccept(boost::asio::ip::tcp::acceptor& acceptor, AdmissionControl& admission,
+                  const HttpSession::Options& options);
+    AdmissionControl::Slot waitConnectionSlot();
+    void rejectConnection(boost::asio::ip::tcp::socket& socket);
+
+    /// Обработчики запросов соединения, общие для всех режимов
+    HttpSession::Callbacks makeCallbacks();
+
+    void handleSession(std::unique_ptr<boost::asio::ip::tcp::socket> connection, AdmissionControl::Slot slot,
+                       std::chrono::steady_clock::time_point accepted);
     void loadJsonToEnvironment(const nlohmann::json& j, const std::string& prefix = "");
     void handleBeastRequest(
-        const boost::beast::http::request<boost::beast::http::string_body>& req,
-        boost::beast::http::response<boost::beast::http::string_body>& res,
-        const std::string& clientIp);
+        const HttpSession::Request& req,
+        HttpSession::Response& res,
+        const std::string& clientIp,
+        HttpSession::Exchange& exchange,
+        BeastResponseStream* stream = nullptr);
     
-    void handleRequest(IRequest& req, IResponse& res);
+    void handleRequest(BeastRequestAdapter& req, IResponse& res);
+
+    /// Создать серии метрик маршрутов handlers_ и статической таблицы (повторный вызов их не дублирует)
+    void registerRouteMetrics();
+
+    /// Отметить конец обработчика, запомнить ответ в exchange и добавить Server-Timing
+    void finishHandling(const BeastRequestAdapter& req, HttpSession::Response& res,
+                        const BeastResponseStream* stream, std::uint64_t bytesIn,
+                        HttpSession::Exchange& exchange);
+
+    /// Учесть отправленный ответ в метриках, журнале доступа и у получателя отметок
+    void completeRequest(HttpSession::Exchange& exchange);
+
+    /// Лимит тела и способ его чтения для маршрута запроса
+    HttpSession::BodyPlan planBody(const HttpSession::HeaderParser& parser);
+    void handleBeastStream(
+        IStreamingHttpHandler& handler,
+        const HttpSession::StreamRequest& req,
+        IBodyReader& body,
+        HttpSession::Response& res,
+        const std::string& clientIp,
+        HttpSession::Exchange& exchange,
+        BeastResponseStream* stream = nullptr);
+
+#ifdef MICROSERVICE_COROUTINES
+    /// Режим coroutine: accept, сессии и вызов обработчиков через co_await
+    boost::asio::awaitable<void> coAccept();
+    boost::asio::awaitable<void> coSession(boost::asio::ip::tcp::socket socket, AdmissionControl::Slot slot);
+    boost::asio::awaitable<void> handleBeastRequestAsync(
+        const HttpSession::Request& req,
+        HttpSession::Response& res,
+        const std::string& clientIp,
+        HttpSession::Exchange& exchange,
+        BeastResponseStream* stream = nullptr);
+    boost::asio::awaitable<void> handleRequestAsync(BeastRequestAdapter& req, IResponse& res);
+#endif
 };
@@ -1,17 +1,70 @@
 #pragma once
 
+#include "IEnvironment.hpp"
 #include "IHttpClient.hpp"
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 /**
  * @file HttpClient.hpp
  * @brief HTTP клиент для общения между микросервисами
  * @author Anton Tobolkin
  */
+
+/**
+ * @class HttpClient
+ * @brief Синхронный HTTP/1.1 клиент с пулом keep-alive соединений
+ *
+ * Для каждого адресата (host:port) хранится пул открытых соединений и
+ * результат DNS-запроса, так что повторный запрос обходится без resolve
+ * и connect. Соединение возвращается в пул, если ответ прочитан целиком и
+ * сервер не закрыл keep-alive.
+ *
+ * При выдаче из пула соединения старше idleTimeout закрываются, а
+ * оставшееся проверяется: закрытое сервером (EOF) или с непрошенными
+ * данными заменяется новым. Не реже раза в idleTimeout любой acquire или
+ * release обходит пулы всех адресатов, так что простаивающие соединения к
+ * адресатам, которым больше не пишут, тоже закрываются. Фонового потока у
+ * клиента нет: простаивающие соединения остаются открытыми до следующего
+ * send() или closeIdle(). Если сервер закрыл соединение между проверкой и
+ * отправкой, идемпотентный запрос один раз повторяется на новом.
+ *
+ * send() можно вызывать из многих потоков одновременно. Клиент должен
+ * пережить все вызовы send().
+ */
 class HttpClient : public IHttpClient
 {
 public:
+    struct Options
+    {
+        std::size_t maxIdlePerHost = 8;                     ///< Простаивающих соединений в пуле адресата
+        std::size_t maxConnectionsPerHost = 64;             ///< Всего соединений с адресатом, 0 - без ограничения
+        std::chrono::milliseconds idleTimeout{30000};       ///< Простоявшие дольше закрываются
+        std::chrono::milliseconds acquireTimeout{5000};     ///< Ожидание свободного соединения при лимите
+
+        /**
+         * @brief Прочитать http_client.max_idle_per_host, http_client.max_connections_per_host,
+         *        http_client.idle_timeout_ms и http_client.acquire_timeout_ms
+         * @throws std::runtime_error для недопустимых значений
+         */
+        static Options fromEnvironment(const IEnvironment& env);
+    };
+
+    HttpClient();
+    explicit HttpClient(Options options);
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
     /**
      * @brief Отправить HTTP запрос
      * @param request IRequest с методом, IP, портом, путём, телом и заголовками
@@ -19,4 +72,60 @@ public:
      * @return true если успешно, false в случае ошибки
      */
     bool send(const IRequest& request, IResponse& response) override;
+
+    /**
+     * @brief Простаивающие соединения во всех пулах
+     */
+    std::size_t idleConnections() const;
+
+    /**
+     * @brief Открытые соединения во всех пулах (простаивающие и выданные)
+     */
+    std::size_t openConnections() const;
+
+    /**
+     * @brief Закрыть все простаивающие соединения
+     */
+    void closeIdle();
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Stream = boost::beast::tcp_stream;
+
+    struct Idle
+    {
+        std::unique_ptr<Stream> stream;
+        Clock::time_point since;
+    };
+
+    struct Pool
+    {
+        std::vector<Idle> idle;                                 ///< Последнее возвращённое - в конце
+        std::size_t open = 0;                                   ///< Простаивающие и выданные
+        boost::asio::ip::tcp::resolver::results_type endpoints; ///< Пусто - ещё не разрешён
+    };
+
+    /**
+     * @brief Соединение, взятое из пула; reused - уже отправляло запросы
+     */
+    struct Lease
+    {
+        std::unique_ptr<Stream> stream;
+        bool reused = false;
+    };
+
+    Lease acquire(const std::string& key, const std::string& host, const std::string& port);
+    void release(const std::string& key, std::unique_ptr<Stream> stream, bool reusable);
+    void evictExpired(Pool& pool, Clock::time_point now);
+    void sweepIfDue(Clock::time_point now);
+
+    static bool healthy(Stream& stream);
+
+    Options options_;
+    boost::asio::io_context ioc_; ///< Только для синхронных операций сокетов
+
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+    std::unordered_map<std::string, Pool> pools_;
+    Clock::time_point nextSweep_; ///< Когда обойти пулы всех адресатов
 };
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "AdmissionControl.hpp"
+#include "RequestCycle.hpp"
+#include "SessionRegistry.hpp"
+#include "TimerWheel.hpp"
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <chrono>
+#include <memory>
+
+/**
+ * @file HttpSession.hpp
+ * @brief Асинхронная HTTP-сессия для режима пула потоков
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class HttpSession
+ * @brief Обслуживает одно TCP-соединение через async_read/async_write
+ *
+ * Поддерживает HTTP/1.1 keep-alive: после ответа сессия читает следующий
+ * запрос из того же сокета и буфера, пока клиент не пришлёт
+ * "Connection: close", не будет исчерпан лимит запросов или не истечёт
+ * таймаут простоя.
+ *
+ * Что делать с запросом между операциями ввода-вывода, решает
+ * RequestCycle - общий для всех режимов сервера; сессия только читает и
+ * пишет сокет асинхронно.
+ *
+ * Сначала читаются только заголовки: по ним выбирается лимит тела маршрута
+ * (запрос с Content-Length больше лимита сразу получает 413) и способ
+ * чтения - в строку или порциями для IStreamingHttpHandler. Потоковый
+ * обработчик читает тело синхронно, обработчик со streamsResponse() так же
+ * пишет ответ, поэтому оба вызываются в пуле Options::blocking, а не на
+ * потоке io_context; сессия тем временем не трогает сокет, а drain будит
+ * их чтение и запись shutdown() вместо close().
+ *
+ * Остальные обработчики тоже могут отправлять ответ порциями
+ * (IResponse::write): поток ответа (BeastResponseStream в режиме Deferred)
+ * собирает заголовки и chunk-и - не больше maxPending неотправленных байт,
+ * а сессия после обработчика отправляет остаток одной асинхронной записью
+ * под одним сроком writeTimeout.
+ * Тело из файла уходит под тем же сроком: sendfile(2), пока сокет
+ * принимает данные, затем async_wait(wait_write).
+ *
+ * Ожидание запроса, чтение заголовков, чтение тела и запись ответа
+ * ограничены сроками из Options; сроки ведутся в общем TimerWheel, по
+ * истечении срока сокет закрывается.
+ *
+ * При остановке сервера (graceful drain) сессия, ждущая следующего запроса,
+ * закрывается сразу, а обрабатывающая запрос - после отправки ответа.
+ *
+ * Сессия живёт, пока на неё ссылается хотя бы одна незавершённая
+ * асинхронная операция (shared_from_this). Сокет должен быть создан
+ * на strand, чтобы обработчики одной сессии не выполнялись параллельно.
+ */
+class HttpSession : public std::enable_shared_from_this<HttpSession>
+{
+public:
+    using Request = RequestCycle::Request;
+    using StreamRequest = RequestCycle::StreamRequest;
+    using Response = RequestCycle::Response;
+    using HeaderParser = RequestCycle::HeaderParser;
+    using Parser = RequestCycle::Parser;
+    using StreamParser = RequestCycle::StreamParser;
+    using BodyPlan = RequestCycle::BodyPlan;
+    using Exchange = RequestCycle::Exchange;
+    using RequestHandler = RequestCycle::RequestHandler;
+    using BodyPlanner = RequestCycle::BodyPlanner;
+    using StreamHandler = RequestCycle::StreamHandler;
+    using CompletionHandler = RequestCycle::CompletionHandler;
+    using Callbacks = RequestCycle::Callbacks;
+    using Options = RequestCycle::Options;
+
+    /**
+     * @param connectionSlot Слот соединения, освобождается вместе с сессией
+     */
+    HttpSession(boost::asio::ip::tcp::socket socket, Callbacks callbacks, Options options,
+                AdmissionControl::Slot connectionSlot = {});
+
+    /**
+     * @brief Запустить чтение первого запроса
+     */
+    void run();
+
+private:
+    void doWait();
+    void doReadHeader();
+    void onReadHeader(boost::beast::error_code ec);
+    void onRead(boost::beast::error_code ec);
+    void onStream();
+    void runHandler(bool stream);
+    void respond(RequestCycle::Reply reply);
+    void sendFile(boost::beast::error_code ec);
+    void onWrite(boost::beast::error_code ec);
+    void reject();
+    void doClose();
+    void closeForDrain(bool force);
+    bool stopping() const;
+    void arm(std::chrono::steady_clock::duration timeout);
+    void disarm();
+    void onDeadline();
+
+    boost::asio::ip::tcp::socket socket_;
+    boost::beast::flat_buffer buffer_;
+    Options options_;
+    RequestCycle cycle_;                                 ///< Ссылается на options_, поток ответа - на socket_
+    std::chrono::steady_clock::time_point accepted_;
+    SessionRegistry::Registration registration_; ///< Снимается после возврата слота
+    AdmissionControl::Slot connectionSlot_;
+    TimerWheel::Timer deadline_;
+    std::chrono::steady_clock::time_point deadlineAt_ = std::chrono::steady_clock::time_point::max();
+    bool idle_ = false;                                  ///< Ждёт первый байт следующего запроса
+    bool offloaded_ = false;                             ///< Обработчик работает в пуле blocking
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#ifdef MICROSERVICE_COROUTINES
+
+#include "IHttpHandler.hpp"
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <exception>
+
+/**
+ * @file IAsyncHttpHandler.hpp
+ * @brief Интерфейс обработчика HTTP запросов на корутинах C++20
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class IAsyncHttpHandler
+ * @brief Обработчик, который может co_await-ить вызовы других сервисов
+ *
+ * В режиме server.mode = "coroutine" сервер вызывает handleAsync() и не
+ * блокирует поток, пока обработчик ждёт ввода-вывода. Регистрируется в
+ * handlers_ так же, как обычный IHttpHandler.
+ *
+ * Доступен только в сборке с MICROSERVICE_ENABLE_COROUTINES.
+ */
+class IAsyncHttpHandler : public IHttpHandler
+{
+public:
+    /**
+     * @brief Обработать HTTP запрос асинхронно
+     * @param req HTTP запрос (живёт до завершения корутины)
+     * @param res HTTP ответ
+     */
+    virtual boost::asio::awaitable<void> handleAsync(IRequest& req, IResponse& res) = 0;
+
+    /**
+     * @brief Синхронный вызов для режимов без корутин
+     *
+     * Выполняет handleAsync() до завершения на собственном io_context
+     * и пробрасывает исключения обработчика.
+     */
+    void handle(IRequest& req, IResponse& res) override
+    {
+        boost::asio::io_context ioContext;
+        boost::asio::co_spawn(ioContext, handleAsync(req, res),
+            [](std::exception_ptr e) {
+                if (e)
+                {
+                    std::rethrow_exception(e);
+                }
+            });
+        ioContext.run();
+    }
+};
+
+#endif // MICROSERVICE_COROUTINES
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fcntl.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @file OpenFileCache.hpp
+ * @brief Ограниченный кэш открытых файлов и результатов stat
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class OpenFileCache
+ * @brief LRU-кэш дескрипторов файлов для раздачи статики
+ *
+ * Повторный запрос того же файла не делает open() и stat(): запись
+ * перепроверяется stat() не чаще раза в validity и переоткрывается, если
+ * файл заменили или изменили. Вытесненная запись закрывает дескриптор,
+ * когда её отпустят все ответы, которые его ещё отправляют.
+ *
+ * Методы потокобезопасны.
+ */
+class OpenFileCache
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Открытый файл и его метаданные
+     */
+    struct Entry
+    {
+        Entry(int descriptor, const struct stat& st) : fd(descriptor), info(st) {}
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+
+        ~Entry()
+        {
+            ::close(fd);
+        }
+
+        std::uint64_t size() const { return static_cast<std::uint64_t>(info.st_size); }
+
+        const int fd;
+        const struct stat info;
+        Clock::time_point checked; ///< Последняя проверка stat (под блокировкой кэша)
+    };
+
+    /**
+     * @param capacity Максимум открытых файлов в кэше
+     * @param validity Как долго запись считается актуальной без stat()
+     */
+    explicit OpenFileCache(std::size_t capacity = 256,
+                           Clock::duration validity = std::chrono::seconds(1))
+        : capacity_(capacity), validity_(validity)
+    {
+    }
+
+    OpenFileCache(const OpenFileCache&) = delete;
+    OpenFileCache& operator=(const OpenFileCache&) = delete;
+
+    /**
+     * @brief Открыть обычный файл (или взять из кэша)
+     * @return nullptr если файла нет или это не обычный файл
+     */
+    std::shared_ptr<const Entry> open(const std::string& path, Clock::time_point now = Clock::now())
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = index_.find(path);
+        if (it != index_.end())
+        {
+            auto node = it->second;
+            auto& entry = node->second;
+            if (now - entry->checked < validity_ || unchanged(path, *entry))
+            {
+                entry->checked = now;
+                lru_.splice(lru_.begin(), lru_, node);
+                return entry;
+            }
+            lru_.erase(node);
+            index_.erase(it);
+        }
+
+        auto entry = openFile(path);
+        if (!entry)
+        {
+            return nullptr;
+        }
+        entry->checked = now;
+
+        if (capacity_ == 0)
+        {
+            return entry;
+        }
+        if (lru_.size() >= capacity_)
+        {
+            index_.erase(lru_.back().first);
+            lru_.pop_back();
+        }
+        lru_.emplace_front(path, entry);
+        index_.emplace(path, lru_.begin());
+        return entry;
+    }
+
+    /**
+     * @brief Число файлов в кэше
+     */
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lru_.size();
+    }
+
+private:
+    static std::shared_ptr<Entry> openFile(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            ::close(fd);
+            return nullptr;
+        }
+        return std::make_shared<Entry>(fd, st);
+    }
+
+    static bool unchanged(const std::string& path, const Entry& entry)
+    {
+        struct stat st{};
+        return ::stat(path.c_str(), &st) == 0 &&
+               st.st_ino == entry.info.st_ino &&
+               st.st_dev == entry.info.st_dev &&
+               st.st_size == entry.info.st_size &&
+               st.st_mtim.tv_sec == entry.info.st_mtim.tv_sec &&
+               st.st_mtim.tv_nsec == entry.info.st_mtim.tv_nsec;
+    }
+
+    using Node = std::pair<std::string, std::shared_ptr<Entry>>;
+
+    const std::size_t capacity_;
+    const Clock::duration validity_;
+
+    mutable std::mutex mutex_;
+    std::list<Node> lru_; ///< В начале - недавно использованные
+    std::unordered_map<std::string, std::list<Node>::iterator> index_;
+};
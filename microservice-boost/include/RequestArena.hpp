@@ -0,0 +1,93 @@
+#pragma once
+
+#include <boost/beast/http.hpp>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+/**
+ * @file RequestArena.hpp
+ * @brief Память одного запроса и типы сообщений Beast поверх неё
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class RequestArena
+ * @brief Монотонная арена: выделение - сдвиг указателя, освобождение - reset()
+ *
+ * Соединение держит одну арену и сбрасывает её перед каждым запросом.
+ * Заголовки запроса и ответа, тело запроса и временные данные
+ * обработчиков (IRequest::arena()) берутся из начального блока; malloc
+ * нужен только запросу, который в блок не поместился, и только до reset().
+ *
+ * Всё, что выделено из арены, должно быть уничтожено до reset().
+ * Не потокобезопасна: одна арена - одно соединение.
+ */
+class RequestArena
+{
+public:
+    using Allocator = std::pmr::polymorphic_allocator<char>;
+
+    static constexpr std::size_t defaultSize = 16 * 1024;
+
+    /**
+     * @param initialSize Размер начального блока, выделяется один раз
+     * @param upstream Откуда брать память сверх начального блока
+     */
+    explicit RequestArena(std::size_t initialSize = defaultSize,
+                          std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : initial_(std::make_unique<std::byte[]>(initialSize)),
+          resource_(initial_.get(), initialSize, upstream)
+    {
+    }
+
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    std::pmr::memory_resource* resource()
+    {
+        return &resource_;
+    }
+
+    Allocator allocator()
+    {
+        return Allocator(&resource_);
+    }
+
+    /**
+     * @brief Освободить всё выделенное с прошлого reset(), кроме начального блока
+     */
+    void reset()
+    {
+        resource_.release();
+    }
+
+private:
+    std::unique_ptr<std::byte[]> initial_;
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+/// Поля HTTP (заголовки) в арене запроса
+using ArenaFields = boost::beast::http::basic_fields<RequestArena::Allocator>;
+
+/// Тело запроса в арене: std::pmr::string
+using ArenaStringBody = boost::beast::http::basic_string_body<char, std::char_traits<char>, RequestArena::Allocator>;
+
+using ArenaRequest = boost::beast::http::request<ArenaStringBody, ArenaFields>;
+using ArenaRequestHeader = boost::beast::http::request_header<ArenaFields>;
+
+/// Тело ответа - обычная строка: setBody(std::string&&) переносит её без копирования
+using ArenaResponse = boost::beast::http::response<boost::beast::http::string_body, ArenaFields>;
+using ArenaResponseHeader = boost::beast::http::response_header<ArenaFields>;
+
+/**
+ * @brief Пустой ответ с заголовками в арене
+ */
+inline ArenaResponse makeArenaResponse(RequestArena& arena, unsigned version)
+{
+    ArenaResponse res{std::piecewise_construct, std::make_tuple(), std::make_tuple(arena.allocator())};
+    res.result(boost::beast::http::status::ok);
+    res.version(version);
+    return res;
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "AdmissionControl.hpp"
+#include "BeastResponseStream.hpp"
+#include "IBodyReader.hpp"
+#include "IStreamingHttpHandler.hpp"
+#include "RequestArena.hpp"
+#include "RequestTiming.hpp"
+#include "SessionRegistry.hpp"
+#include "TimerWheel.hpp"
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * @file RequestCycle.hpp
+ * @brief Обработка запросов соединения, общая для всех режимов сервера
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class RequestCycle
+ * @brief Шаги обработки запроса между операциями ввода-вывода
+ *
+ * Режимы сервера отличаются только тем, как читают и пишут сокет: поток
+ * на соединение - синхронно, HttpSession - через обработчики завершения,
+ * корутина - через co_await. Всё остальное делает RequestCycle: лимит
+ * тела и 413, лимит запросов в обработке и 503, ответ и поток ответа,
+ * отметки RequestTiming, учёт отправленного ответа и keep-alive.
+ *
+ * Транспорт вызывает шаги по порядку:
+ *
+ *   startRequest() -> прочитать заголовки в headerParser -> onHeader()
+ *     ReadBody: прочитать тело в parser() -> onBody()
+ *   admit() для Handle и Stream
+ *     Reject: отправить rejection(), completeRequest(), закрыть соединение
+ *     Handle: handle() или свой вызов обработчика с request(), response(), stream()
+ *     Stream: handleStream() - тело читает сам обработчик
+ *   reply() -> отправить response() или stream().output() и файл -> completeRequest()
+ *   keepAlive() - читать ли следующий запрос
+ *
+ * Объекты запроса живут в арене цикла до следующего startRequest().
+ * Цикл не потокобезопасен: шаги одного соединения вызываются по очереди
+ * (обработчик может выполняться в другом потоке, пока транспорт ждёт его).
+ */
+class RequestCycle
+{
+public:
+    using Request = ArenaRequest;
+    using StreamRequest = boost::beast::http::request<boost::beast::http::buffer_body, ArenaFields>;
+    using Response = ArenaResponse;
+    using HeaderParser = boost::beast::http::request_parser<boost::beast::http::empty_body, RequestArena::Allocator>;
+    using Parser = boost::beast::http::request_parser<ArenaStringBody, RequestArena::Allocator>;
+    using StreamParser = boost::beast::http::request_parser<boost::beast::http::buffer_body, RequestArena::Allocator>;
+
+    /**
+     * @brief Как читать тело запроса, выбирается по заголовкам
+     */
+    struct BodyPlan
+    {
+        std::uint64_t limit = 0;                       ///< Лимит тела в байтах
+        std::shared_ptr<IStreamingHttpHandler> stream; ///< Не nullptr - читать тело потоком
+        bool streamsResponse = false;                  ///< Обработчик пишет ответ порциями
+    };
+
+    /**
+     * @brief Обслуживаемый запрос: отметки времени и то, что учитывается после отправки ответа
+     */
+    struct Exchange
+    {
+        RequestTiming timing;
+        std::string method;      ///< Имя метода короткое - без выделения памяти
+        std::string_view route;  ///< Паттерн маршрута (в Router или в пути запроса), пусто - не найден
+        std::string_view ip;     ///< IP клиента, строка соединения (не адаптера запроса)
+        int status = 0;
+        std::uint64_t bytesIn = 0;
+        std::uint64_t bytesOut = 0;
+    };
+
+    /**
+     * @brief Функция обработки запроса: (запрос, ответ, IP клиента, потоковая запись ответа,
+     * обслуживаемый запрос)
+     */
+    using RequestHandler = std::function<void(const Request&, Response&, const std::string&,
+                                              BeastResponseStream&, Exchange&)>;
+
+    /**
+     * @brief Функция выбора BodyPlan по прочитанным заголовкам
+     */
+    using BodyPlanner = std::function<BodyPlan(const HeaderParser&)>;
+
+    /**
+     * @brief Функция потоковой обработки: (обработчик, заголовки, тело, ответ, IP клиента,
+     * потоковая запись ответа, обслуживаемый запрос)
+     */
+    using StreamHandler = std::function<void(IStreamingHttpHandler&, const StreamRequest&,
+                                             IBodyReader&, Response&, const std::string&,
+                                             BeastResponseStream&, Exchange&)>;
+
+    /**
+     * @brief Функция, которой передаётся запрос после отправки ответа (отметка Written стоит)
+     */
+    using CompletionHandler = std::function<void(Exchange&)>;
+
+    /**
+     * @brief Обработчики запросов соединения
+     */
+    struct Callbacks
+    {
+        RequestHandler request;
+        BodyPlanner planBody;   ///< Пусто - лимит maxBodySize, без потоковых маршрутов
+        StreamHandler stream;
+        CompletionHandler complete; ///< Пусто - не вызывается
+    };
+
+    /**
+     * @brief Параметры соединения
+     */
+    struct Options
+    {
+        int maxRequests = 100;                              ///< 0 - без ограничения
+        std::chrono::steady_clock::duration idleTimeout = std::chrono::seconds(5);
+        std::chrono::steady_clock::duration headerTimeout = std::chrono::seconds(10);
+        std::chrono::steady_clock::duration bodyTimeout = std::chrono::seconds(30);
+        std::chrono::steady_clock::duration writeTimeout = std::chrono::seconds(30);
+        TimerWheel* deadlines = nullptr;                    ///< nullptr - без сроков
+        AdmissionControl* admission = nullptr;              ///< Лимит запросов в обработке
+        std::string_view overloadResponse;                  ///< Готовый ответ 503
+        std::uint64_t maxBodySize = 1024 * 1024;            ///< Лимит тела по умолчанию
+        std::string_view tooLargeResponse;                  ///< Готовый ответ 413
+        SessionRegistry* sessions = nullptr;                ///< Учёт сессий для drain
+        const std::atomic<bool>* running = nullptr;         ///< false - сервер останавливается
+        boost::asio::thread_pool* blocking = nullptr;       ///< Пул для offloaded(), nullptr - на strand
+    };
+
+    /**
+     * @brief Следующий шаг транспорта после onHeader(), onBody() и admit()
+     */
+    enum class Step
+    {
+        ReadBody, ///< Прочитать тело в parser() и вызвать onBody()
+        Handle,   ///< Тело прочитано: admit(), затем обработчик
+        Stream,   ///< Тело читает потоковый обработчик: admit(), затем handleStream()
+        Reject    ///< Отправить rejection() и закрыть соединение
+    };
+
+    /**
+     * @brief Что отправить после обработчика
+     */
+    enum class Reply
+    {
+        Message, ///< response() целиком (http::write)
+        Stream,  ///< stream().output(), затем файл через stream().sendFileSome()
+        Failed   ///< Потоковая запись уже не удалась - закрыть соединение
+    };
+
+    /**
+     * @param options Должны пережить цикл
+     */
+    RequestCycle(Callbacks callbacks, const Options& options, std::string clientIp);
+
+    RequestCycle(const RequestCycle&) = delete;
+    RequestCycle& operator=(const RequestCycle&) = delete;
+
+    /**
+     * @brief IP клиента соединения, "0.0.0.0" если сокет его уже не знает
+     */
+    static std::string remoteIp(const boost::asio::ip::tcp::socket& socket);
+
+    /**
+     * @brief Запасти в buffer место под тело запроса перед его чтением
+     *
+     * Beast читает тело порциями не больше свободного места в буфере: без
+     * запаса большое тело приходит сотнями чтений по 512 байт. Запас - по
+     * Content-Length, но не больше лимита тела и одной порции чтения (64 КиБ).
+     */
+    static void reserveBody(boost::beast::flat_buffer& buffer, boost::optional<std::uint64_t> length,
+                            std::uint64_t limit);
+
+    /**
+     * @brief Начать следующий запрос: уничтожить прошлый, сбросить арену
+     * @param accepted Когда принято соединение (отметка Accepted)
+     * @return Парсер, в который читаются заголовки
+     */
+    HeaderParser& startRequest(std::chrono::steady_clock::time_point accepted);
+
+    /**
+     * @brief Заголовки прочитаны: выбрать лимит и способ чтения тела
+     *
+     * Для ReadBody в buffer запасено место под тело.
+     */
+    Step onHeader(boost::beast::flat_buffer& buffer);
+
+    /**
+     * @brief Тело прочитано в parser()
+     * @param ec Результат чтения: body_limit - Reject, прочие ошибки транспорт обрабатывает сам
+     */
+    Step onBody(boost::beast::error_code ec);
+
+    /**
+     * @brief Занять слот запроса и создать ответ
+     * @param step Handle или Stream из onHeader()/onBody()
+     * @param mode Как поток ответа отправляет данные; для offloaded() - всегда Blocking
+     * @return step или Reject, если запросов в обработке слишком много
+     */
+    Step admit(Step step, boost::asio::ip::tcp::socket& socket, BeastResponseStream::Mode mode);
+
+    /**
+     * @brief Готовый ответ 413 или 503 после Reject, учтённый в exchange()
+     */
+    std::string_view rejection();
+
+    /**
+     * @brief Вызвать Callbacks::request
+     * @return false - обработчик выбросил исключение, соединение закрыть
+     */
+    bool handle();
+
+    /**
+     * @brief Вызвать Callbacks::stream; тело читается из socket и buffer синхронно
+     * @return false - чтение или обработчик завершились ошибкой, соединение закрыть
+     */
+    bool handleStream(boost::asio::ip::tcp::socket& socket, boost::beast::flat_buffer& buffer);
+
+    /**
+     * @brief Обработчик завершён: вернуть слот запроса и подготовить ответ к отправке
+     * @param stopping Сервер останавливается - соединение закрыть после ответа
+     */
+    Reply reply(bool stopping);
+
+    /**
+     * @brief Ответ отправлен (или отправка не удалась): отметка Written и Callbacks::complete
+     */
+    void completeRequest();
+
+    /**
+     * @brief Читать ли следующий запрос после отправленного ответа
+     */
+    bool keepAlive() const;
+
+    /**
+     * @brief Сколько запросов соединения дошло до admit()
+     */
+    int served() const { return served_; }
+
+    /**
+     * @brief Обработчик выполнять в пуле Options::blocking (после onHeader())
+     *
+     * Потоковый обработчик читает тело, а обработчик со streamsResponse()
+     * пишет ответ синхронно: оба ждут клиента и не должны занимать поток
+     * io_context. Транспорт с собственным потоком на соединение это не
+     * учитывает. reply() такого обработчика тоже вызывается в пуле: в
+     * режиме Blocking finish() дописывает ответ в сокет.
+     */
+    bool offloaded() const { return offloaded_; }
+
+    const Request& request() const { return parser_->get(); }
+    Parser& parser() { return *parser_; }
+    Response& response() { return *res_; }
+    BeastResponseStream& stream() { return *stream_; }
+    Exchange& exchange() { return exchange_; }
+    const std::string& clientIp() const { return clientIp_; }
+
+private:
+    Callbacks callbacks_;
+    const Options& options_;
+    std::string clientIp_;
+    RequestArena arena_;                          ///< Объявлена раньше всего, что в ней живёт
+    std::optional<HeaderParser> headerParser_;
+    std::optional<Parser> parser_;
+    std::optional<StreamParser> streamParser_;
+    std::shared_ptr<IStreamingHttpHandler> streamHandler_;
+    AdmissionControl::Slot requestSlot_;
+    std::optional<Response> res_;
+    std::optional<BeastResponseStream> stream_;   ///< Ответ запроса; пишет в *res_
+    std::string_view rejection_;                  ///< Готовый ответ после Reject
+    Exchange exchange_;
+    int served_ = 0;
+    bool offloaded_ = false;
+};
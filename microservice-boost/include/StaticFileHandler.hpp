@@ -0,0 +1,56 @@
+#pragma once
+
+#include "IHttpHandler.hpp"
+#include "OpenFileCache.hpp"
+#include <string>
+#include <string_view>
+
+/**
+ * @file StaticFileHandler.hpp
+ * @brief Обработчик раздачи файлов из каталога
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class StaticFileHandler
+ * @brief Отдаёт файлы каталога root по URL с префиксом prefix
+ *
+ * GET prefix/css/app.css отдаёт root/css/app.css. Тело отправляется через
+ * IResponse::setFileBody() (sendfile, без копирования в user space),
+ * дескрипторы и stat кэшируются в OpenFileCache. Ответ содержит
+ * Content-Length, Last-Modified и ETag; совпавший If-None-Match или
+ * If-Modified-Since даёт 304 без тела.
+ *
+ * Пути с сегментом ".." отклоняются (404), запрос каталога отдаёт его
+ * index.html. Wildcard маршрута совпадает с одним сегментом, поэтому для
+ * вложенных каталогов тот же обработчик регистрируется и на паттерны
+ * с большим числом сегментов.
+ */
+class StaticFileHandler : public IHttpHandler
+{
+public:
+    /**
+     * @param prefix URL-префикс маршрута (например, "/static")
+     * @param root Каталог с файлами
+     * @param cacheSize Максимум открытых файлов в кэше
+     */
+    StaticFileHandler(std::string prefix, std::string root, std::size_t cacheSize = 256);
+
+    void handle(IRequest& req, IResponse& res) override;
+
+    /**
+     * @brief MIME-тип по расширению файла
+     */
+    static std::string contentType(const std::string& path);
+
+private:
+    /**
+     * @brief Путь к файлу для URL (пусто - путь недопустим)
+     * @param encodedPath Путь запроса как есть, с %XX
+     */
+    std::string resolve(std::string_view encodedPath) const;
+
+    std::string prefix_;
+    std::string root_;
+    OpenFileCache files_;
+};
@@ -3,16 +3,80 @@
 #include <memory>
 #include <string>
 #include <stdexcept>
+#include <thread>
 #include "settings/IServerSettings.hpp"
 #include "IEnvironment.hpp"
 
+/**
+ * @brief Режим работы сетевого слоя сервера
+ *
+ * - ThreadPerConnection - блокирующий accept и отдельный поток на соединение
+ * - Pool - async_accept и асинхронные сессии на общем io_context,
+ *   который обслуживает фиксированный пул потоков
+ * - ReusePort - shared-nothing: у каждого потока свой io_context и свой
+ *   acceptor с SO_REUSEPORT, соединения распределяет ядро
+ * - Coroutine - сессии на корутинах C++20 поверх пула потоков
+ *   (только в сборке с MICROSERVICE_ENABLE_COROUTINES)
+ */
+enum class ServerMode
+{
+    ThreadPerConnection,
+    Pool,
+    ReusePort,
+    Coroutine
+};
+
+/**
+ * @brief Поведение сервера при исчерпании лимитов
+ *
+ * - Reject - сразу отвечать заранее подготовленным 503 с Retry-After
+ * - Pause - перестать принимать соединения (очередь копится в backlog ядра);
+ *   превышение лимита запросов в обработке всё равно отклоняется с 503
+ */
+enum class OverloadPolicy
+{
+    Reject,
+    Pause
+};
+
 /**
  * @brief Реализация настроек сервера
+ *
+ * Обязательные параметры: server.host, server.port.
+ * Необязательные: server.mode ("thread" | "pool" | "reuseport" | "coroutine", по умолчанию "thread"),
+ * server.threads (по умолчанию - число ядер),
+ * server.blocking_threads (потоки для IStreamingHttpHandler в асинхронных режимах, по умолчанию 4),
+ * server.keep_alive.max_requests (по умолчанию 100, 0 - без ограничения),
+ * server.keep_alive.timeout (секунды простоя между запросами, по умолчанию 5),
+ * server.max_connections, server.max_inflight (по умолчанию 0 - без ограничения),
+ * server.overload ("reject" | "pause", по умолчанию "reject"),
+ * server.retry_after (секунды для заголовка Retry-After, по умолчанию 1),
+ * server.drain_timeout (секунды на завершение запросов при остановке, по умолчанию 10),
+ * server.timeouts.header_read, server.timeouts.body_read, server.timeouts.write
+ * (секунды на чтение заголовков, тела и запись ответа, по умолчанию 10, 30 и 30),
+ * server.max_body_size (байты тела запроса, по умолчанию 1048576; маршрут может
+ * задать свой лимит через IHttpHandler::maxBodySize()),
+ * server.server_timing (заголовок Server-Timing с фазами запроса, по умолчанию false).
  */
 class ServerSettings : public IServerSettings {
 private:
     std::string host_;
     int port_;
+    ServerMode mode_ = ServerMode::ThreadPerConnection;
+    int threads_ = 1;
+    int blockingThreads_ = 4;
+    int keepAliveMaxRequests_ = 100;
+    int keepAliveTimeout_ = 5;
+    int maxConnections_ = 0;
+    int maxInflight_ = 0;
+    OverloadPolicy overloadPolicy_ = OverloadPolicy::Reject;
+    int retryAfter_ = 1;
+    int drainTimeout_ = 10;
+    int headerReadTimeout_ = 10;
+    int bodyReadTimeout_ = 30;
+    int writeTimeout_ = 30;
+    int maxBodySize_ = 1024 * 1024;
+    bool serverTiming_ = false;
 
 public:
     explicit ServerSettings(std::shared_ptr<IEnvironment> env) {
@@ -27,6 +91,83 @@ public:
         } catch (...) {
             throw std::runtime_error("Missing required setting: server.port");
         }
+
+        std::string mode = env->get<std::string>("server.mode", "thread");
+        if (mode == "thread") {
+            mode_ = ServerMode::ThreadPerConnection;
+        } else if (mode == "pool") {
+            mode_ = ServerMode::Pool;
+        } else if (mode == "reuseport") {
+            mode_ = ServerMode::ReusePort;
+        } else if (mode == "coroutine") {
+#ifdef MICROSERVICE_COROUTINES
+            mode_ = ServerMode::Coroutine;
+#else
+            throw std::runtime_error("Invalid setting: server.mode = coroutine requires MICROSERVICE_ENABLE_COROUTINES");
+#endif
+        } else {
+            throw std::runtime_error("Invalid setting: server.mode = " + mode);
+        }
+
+        int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+        threads_ = env->get<int>("server.threads", hardwareThreads > 0 ? hardwareThreads : 1);
+        if (threads_ <= 0) {
+            throw std::runtime_error("Invalid setting: server.threads must be positive");
+        }
+
+        blockingThreads_ = env->get<int>("server.blocking_threads", blockingThreads_);
+        if (blockingThreads_ <= 0) {
+            throw std::runtime_error("Invalid setting: server.blocking_threads must be positive");
+        }
+
+        keepAliveMaxRequests_ = env->get<int>("server.keep_alive.max_requests", keepAliveMaxRequests_);
+        if (keepAliveMaxRequests_ < 0) {
+            throw std::runtime_error("Invalid setting: server.keep_alive.max_requests must not be negative");
+        }
+
+        keepAliveTimeout_ = env->get<int>("server.keep_alive.timeout", keepAliveTimeout_);
+        if (keepAliveTimeout_ <= 0) {
+            throw std::runtime_error("Invalid setting: server.keep_alive.timeout must be positive");
+        }
+
+        maxConnections_ = env->get<int>("server.max_connections", maxConnections_);
+        maxInflight_ = env->get<int>("server.max_inflight", maxInflight_);
+        if (maxConnections_ < 0 || maxInflight_ < 0) {
+            throw std::runtime_error("Invalid setting: server.max_connections and server.max_inflight must not be negative");
+        }
+
+        std::string overload = env->get<std::string>("server.overload", "reject");
+        if (overload == "reject") {
+            overloadPolicy_ = OverloadPolicy::Reject;
+        } else if (overload == "pause") {
+            overloadPolicy_ = OverloadPolicy::Pause;
+        } else {
+            throw std::runtime_error("Invalid setting: server.overload = " + overload);
+        }
+
+        retryAfter_ = env->get<int>("server.retry_after", retryAfter_);
+        if (retryAfter_ < 0) {
+            throw std::runtime_error("Invalid setting: server.retry_after must not be negative");
+        }
+
+        drainTimeout_ = env->get<int>("server.drain_timeout", drainTimeout_);
+        if (drainTimeout_ < 0) {
+            throw std::runtime_error("Invalid setting: server.drain_timeout must not be negative");
+        }
+
+        headerReadTimeout_ = env->get<int>("server.timeouts.header_read", headerReadTimeout_);
+        bodyReadTimeout_ = env->get<int>("server.timeouts.body_read", bodyReadTimeout_);
+        writeTimeout_ = env->get<int>("server.timeouts.write", writeTimeout_);
+        if (headerReadTimeout_ <= 0 || bodyReadTimeout_ <= 0 || writeTimeout_ <= 0) {
+            throw std::runtime_error("Invalid setting: server.timeouts.* must be positive");
+        }
+
+        maxBodySize_ = env->get<int>("server.max_body_size", maxBodySize_);
+        if (maxBodySize_ <= 0) {
+            throw std::runtime_error("Invalid setting: server.max_body_size must be positive");
+        }
+
+        serverTiming_ = env->get<bool>("server.server_timing", serverTiming_);
     }
 
     std::string getHost() const override {
@@ -36,4 +177,100 @@ public:
     int getPort() const override {
         return port_;
     }
+
+    ServerMode getMode() const {
+        return mode_;
+    }
+
+    int getThreads() const {
+        return threads_;
+    }
+
+    /**
+     * @brief Потоки, на которых pool, reuseport и coroutine вызывают потоковые обработчики
+     */
+    int getBlockingThreads() const {
+        return blockingThreads_;
+    }
+
+    /**
+     * @brief Максимум запросов на одно keep-alive соединение (0 - без ограничения)
+     */
+    int getKeepAliveMaxRequests() const {
+        return keepAliveMaxRequests_;
+    }
+
+    /**
+     * @brief Таймаут простоя keep-alive соединения в секундах
+     */
+    int getKeepAliveTimeout() const {
+        return keepAliveTimeout_;
+    }
+
+    /**
+     * @brief Максимум одновременных соединений (0 - без ограничения)
+     */
+    int getMaxConnections() const {
+        return maxConnections_;
+    }
+
+    /**
+     * @brief Максимум запросов в обработке (0 - без ограничения)
+     */
+    int getMaxInflight() const {
+        return maxInflight_;
+    }
+
+    OverloadPolicy getOverloadPolicy() const {
+        return overloadPolicy_;
+    }
+
+    /**
+     * @brief Значение заголовка Retry-After для ответа 503, секунды
+     */
+    int getRetryAfter() const {
+        return retryAfter_;
+    }
+
+    /**
+     * @brief Время на завершение запросов в обработке при stop(), секунды
+     */
+    int getDrainTimeout() const {
+        return drainTimeout_;
+    }
+
+    /**
+     * @brief Срок получения заголовков запроса, секунды
+     */
+    int getHeaderReadTimeout() const {
+        return headerReadTimeout_;
+    }
+
+    /**
+     * @brief Срок получения тела запроса после заголовков, секунды
+     */
+    int getBodyReadTimeout() const {
+        return bodyReadTimeout_;
+    }
+
+    /**
+     * @brief Срок отправки ответа, секунды
+     */
+    int getWriteTimeout() const {
+        return writeTimeout_;
+    }
+
+    /**
+     * @brief Лимит тела запроса по умолчанию, байты
+     */
+    int getMaxBodySize() const {
+        return maxBodySize_;
+    }
+
+    /**
+     * @brief Добавлять в ответы заголовок Server-Timing (read, route, handle)
+     */
+    bool getServerTiming() const {
+        return serverTiming_;
+    }
 };
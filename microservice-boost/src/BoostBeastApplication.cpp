@@ -2,14 +2,31 @@
 #include "BeastRequestAdapter.hpp"
 #include "BeastResponseAdapter.hpp"
 #include "Environment.hpp"
+#include "Logger.hpp"
+#include "MetricsHandler.hpp"
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/asio/ip/tcp.hpp>
-#include <iostream>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
 #include <fstream>
+#include <optional>
 #include <thread>
-#include "RouteMatcher.hpp"
+#include <future>
+#include <poll.h>
+#include <sys/socket.h>
 #include "settings/ServerSettings.hpp"
+#ifdef MICROSERVICE_COROUTINES
+#include "IAsyncHttpHandler.hpp"
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#endif
 
 using json = nlohmann::json;
 
@@ -18,40 +35,231 @@ namespace http = beast::http;
 namespace asio = boost::asio;
 using tcp = asio::ip::tcp;
 
-BoostBeastApplication::BoostBeastApplication()
-    : running_(false)
+namespace
+{
+
+/**
+ * @brief Дождаться данных в блокирующем сокете
+ *
+ * Срок ожидания ограничивает колесо таймеров: по его истечении shutdown()
+ * делает сокет читаемым (EOF).
+ * @return true если сокет готов к чтению (данные или EOF)
+ */
+bool waitReadable(tcp::socket& socket)
 {
-    std::cout << "[App] BoostBeastApplication created" << std::endl;
+    pollfd pfd{};
+    pfd.fd = socket.native_handle();
+    pfd.events = POLLIN;
+
+    int rc;
+    do
+    {
+        rc = ::poll(&pfd, 1, -1);
+    } while (rc < 0 && errno == EINTR);
+
+    return rc > 0;
 }
 
-BoostBeastApplication::~BoostBeastApplication()
+/**
+ * @brief Продвигать колесо таймеров раз в тик на io_context таймера
+ */
+void tickDeadlines(asio::steady_timer& ticker, TimerWheel& wheel)
 {
-    stop();
-    std::cout << "[App] BoostBeastApplication destroyed" << std::endl;
+    ticker.expires_after(wheel.tick());
+    ticker.async_wait([&ticker, &wheel](beast::error_code ec) {
+        if (!ec)
+        {
+            wheel.advance();
+            tickDeadlines(ticker, wheel);
+        }
+    });
 }
 
-void BoostBeastApplication::stop()
+/**
+ * @brief Заранее собранный ответ 503, отправляется без маршрутизации
+ */
+std::string makeOverloadResponse(int retryAfter)
+{
+    const std::string body = R"({"error": "Service unavailable"})";
+    return "HTTP/1.1 503 Service Unavailable\r\n"
+           "Server: BoostBeast\r\n"
+           "Retry-After: " + std::to_string(retryAfter) + "\r\n"
+           "Content-Type: application/json\r\n"
+           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+           "Connection: close\r\n"
+           "\r\n" + body;
+}
+
+/**
+ * @brief Заранее собранный ответ 413, отправляется без чтения тела
+ */
+std::string makeTooLargeResponse()
+{
+    const std::string body = R"({"error": "Payload too large"})";
+    return "HTTP/1.1 413 Payload Too Large\r\n"
+           "Server: BoostBeast\r\n"
+           "Content-Type: application/json\r\n"
+           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+           "Connection: close\r\n"
+           "\r\n" + body;
+}
+
+/**
+ * @brief Значение Server-Timing: фазы до отправки ответа, миллисекунды
+ */
+std::string formatServerTiming(const RequestTiming& timing)
+{
+    auto millis = [](RequestTiming::Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+    char value[96];
+    int length = std::snprintf(value, sizeof(value), "read;dur=%.3f, route;dur=%.3f, handle;dur=%.3f",
+                               millis(timing.read()), millis(timing.route()), millis(timing.handle()));
+    return std::string(value, static_cast<std::size_t>(length));
+}
+
+#ifdef MICROSERVICE_COROUTINES
+/**
+ * @brief Состояние корутинной сессии, доступное обработчикам drain и сроков
+ *
+ * Все поля, кроме deadline, используются только на strand сессии.
+ */
+struct CoSessionState
 {
-    if (running_)
+    CoSessionState(tcp::socket s, TimerWheel& wheel) : socket(std::move(s)), deadlines(wheel) {}
+
+    tcp::socket socket;
+    TimerWheel& deadlines;
+    TimerWheel::Timer deadline;
+    std::chrono::steady_clock::time_point deadlineAt = std::chrono::steady_clock::time_point::max();
+    bool idle = false;
+    bool offloaded = false; ///< Сокет читает потоковый обработчик в пуле blocking
+
+    void arm(std::chrono::steady_clock::duration timeout)
     {
-        std::cout << "[App] Stopping application..." << std::endl;
-        running_ = false;
-        
-        if (acceptor_ && acceptor_->is_open())
+        auto now = std::chrono::steady_clock::now();
+        deadlineAt = now + timeout;
+        deadlines.schedule(deadline, timeout, now);
+    }
+
+    void disarm()
+    {
+        deadlineAt = std::chrono::steady_clock::time_point::max();
+        deadlines.cancel(deadline);
+    }
+
+    void onDeadline()
+    {
+        // Срабатывание могло устареть, пока ждало очереди strand
+        if (std::chrono::steady_clock::now() >= deadlineAt)
         {
-            acceptor_->close();
+            beast::error_code ec;
+            socket.close(ec);
         }
-        
-        if (ioContext_)
+    }
+
+    void closeForDrain(bool force)
+    {
+        // Дескриптор занят потоком пула: только будим его чтение
+        if (offloaded)
+        {
+            if (force)
+            {
+                ::shutdown(socket.native_handle(), SHUT_RDWR);
+            }
+            return;
+        }
+        if (force || idle)
         {
-            ioContext_->stop();
+            beast::error_code ec;
+            socket.close(ec);
         }
     }
+};
+#endif
+
+} // namespace
+
+BoostBeastApplication::BoostBeastApplication()
+    : drainTimeout_(std::chrono::seconds(10)),
+      overloadPolicy_(OverloadPolicy::Reject),
+      mode_(ServerMode::ThreadPerConnection),
+      running_(false),
+      stopRequested_(false)
+{
+    // Один раз на приложение: start() после stop() не должен дублировать серию
+    metrics_.addGauge("http_server_connections", "Open client connections",
+                      [this] { return static_cast<double>(sessions_.size()); });
+    MS_LOG_DEBUG("[App] BoostBeastApplication created");
+}
+
+BoostBeastApplication::~BoostBeastApplication()
+{
+    stop();
+    MS_LOG_DEBUG("[App] BoostBeastApplication destroyed");
+}
+
+void BoostBeastApplication::stop()
+{
+    // stop() до того, как start() начал приём, отменяет запуск (см. beginRunning)
+    stopRequested_ = true;
+    if (!running_.exchange(false))
+    {
+        return;
+    }
+
+    MS_LOG_INFO("[App] Stopping application, draining ", sessions_.size(), " session(s)...");
+
+    // Прекращаем приём: shutdown() слушающего сокета будит accept() во всех
+    // режимах, сам acceptor закрывается в своём потоке
+    if (acceptor_ && acceptor_->is_open())
+    {
+        ::shutdown(acceptor_->native_handle(), SHUT_RDWR);
+    }
+    for (auto& shard : shards_)
+    {
+        ::shutdown(shard.acceptor->native_handle(), SHUT_RDWR);
+    }
+
+    // Соединения без запроса в обработке закрываем сразу, остальные
+    // закроются сами после отправки ответа
+    sessions_.closeIdle();
+
+    if (!sessions_.waitEmpty(std::chrono::steady_clock::now() + drainTimeout_))
+    {
+        MS_LOG_WARN("[App] Drain timeout, closing ", sessions_.size(), " session(s)");
+        sessions_.closeAll();
+        sessions_.waitEmpty(std::chrono::steady_clock::now() + std::chrono::seconds(1));
+    }
+
+    if (ioContext_)
+    {
+        ioContext_->stop();
+    }
+
+    // Шард 0 обслуживает поток start(), который очищает shards_ после
+    // возврата из run() - останавливаем его последним и больше не трогаем вектор
+    for (std::size_t i = shards_.size(); i-- > 0; )
+    {
+        shards_[i].ioContext->stop();
+    }
+
+    if (accessLog_)
+    {
+        accessLog_->flush();
+    }
+    MS_LOG_INFO("[App] Application stopped");
+    Logger::flush();
+}
+
+std::size_t BoostBeastApplication::activeSessions() const
+{
+    return sessions_.size();
 }
 
 void BoostBeastApplication::loadEnvironment(int argc, char* argv[])
 {
-    std::cout << "[BoostBeastApplication] Loading environment..." << std::endl;
+    MS_LOG_INFO("[BoostBeastApplication] Loading environment...");
     
     // Игнорируем argc/argv (можно расширить позже)
     (void)argc;
@@ -67,27 +275,27 @@ void BoostBeastApplication::loadEnvironment(int argc, char* argv[])
         
         if (!configFile.is_open())
         {
-            std::cout << "[BoostBeastApplication] config.json not found" << std::endl;
+            MS_LOG_INFO("[BoostBeastApplication] config.json not found");
             return;
         }
         
-        std::cout << "[BoostBeastApplication] Reading config.json..." << std::endl;
+        MS_LOG_INFO("[BoostBeastApplication] Reading config.json...");
         
         json config = json::parse(configFile);
         
         // Рекурсивно загружаем весь JSON в Environment
         loadJsonToEnvironment(config);
         
-        std::cout << "[BoostBeastApplication] Configuration loaded from config.json" << std::endl;
+        MS_LOG_INFO("[BoostBeastApplication] Configuration loaded from config.json");
     }
     catch (const json::parse_error& e)
     {
-        std::cerr << "[BoostBeastApplication] JSON parse error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[BoostBeastApplication] JSON parse error: ", e.what());
         throw;
     }
     catch (const std::exception& e)
     {
-        std::cerr << "[BoostBeastApplication] Error loading config: " << e.what() << std::endl;
+        MS_LOG_ERROR("[BoostBeastApplication] Error loading config: ", e.what());
         throw;
     }
 }
@@ -106,7 +314,7 @@ void BoostBeastApplication::loadJsonToEnvironment(const json& j, const std::stri
         else if (it->is_string())
         {
             std::string value = it->get<std::string>();
-            std::cout << "[BoostBeastApplication] Setting: " << key << " = " << value << std::endl;
+            MS_LOG_DEBUG("[BoostBeastApplication] Setting: ", key, " = ", value);
             env_->setProperty(key, value);
         }
         else if (it->is_number_integer())
@@ -128,7 +336,7 @@ void BoostBeastApplication::loadJsonToEnvironment(const json& j, const std::stri
         else if (it->is_array())
         {
             // Массивы пока игнорируем (можно расширить)
-            std::cout << "[BoostBeastApplication] Skipping array: " << key << std::endl;
+            MS_LOG_DEBUG("[BoostBeastApplication] Skipping array: ", key);
         }
         else if (it->is_null())
         {
@@ -141,86 +349,554 @@ void BoostBeastApplication::start()
 {
     try
     {
+        Logger::configure(*env_);
+
+        auto accessLogOptions = AccessLog::Options::fromEnvironment(*env_);
+        if (!accessLogOptions.path.empty())
+        {
+            accessLog_ = std::make_unique<AccessLog>(std::move(accessLogOptions));
+        }
+
+        auto metricsOptions = MetricsRegistry::Options::fromEnvironment(*env_);
+        metricsEnabled_ = metricsOptions.enabled;
+        if (metricsEnabled_ && !metricsOptions.path.empty())
+        {
+            // Маршрут, уже занятый приложением, не перезаписываем
+            handlers_.emplace(getHandlerKey("GET", metricsOptions.path),
+                              std::make_shared<MetricsHandler>(metrics_));
+        }
+
         // Создаем ServerSettings вручную (без DI) с валидацией
         ServerSettings serverSettings(env_);
         std::string host = serverSettings.getHost();
         int port = serverSettings.getPort();
         
-        std::cout << "[App] Starting HTTP server..." << std::endl;
-        
-        // Создаем IO контекст
-        ioContext_ = std::make_unique<asio::io_context>();
+        MS_LOG_INFO("[App] Starting HTTP server...");
+
+        mode_ = serverSettings.getMode();
+        compileRoutes();
+        if (metricsEnabled_)
+        {
+            registerRouteMetrics();
+        }
+        sessionOptions_.maxRequests = serverSettings.getKeepAliveMaxRequests();
+        sessionOptions_.idleTimeout = std::chrono::seconds(serverSettings.getKeepAliveTimeout());
+        sessionOptions_.headerTimeout = std::chrono::seconds(serverSettings.getHeaderReadTimeout());
+        sessionOptions_.bodyTimeout = std::chrono::seconds(serverSettings.getBodyReadTimeout());
+        sessionOptions_.writeTimeout = std::chrono::seconds(serverSettings.getWriteTimeout());
+
+        admission_.setLimits(serverSettings.getMaxConnections(), serverSettings.getMaxInflight());
+        overloadPolicy_ = serverSettings.getOverloadPolicy();
+        overloadResponse_ = makeOverloadResponse(serverSettings.getRetryAfter());
+        sessionOptions_.admission = &admission_;
+        sessionOptions_.overloadResponse = overloadResponse_;
+        tooLargeResponse_ = makeTooLargeResponse();
+        sessionOptions_.maxBodySize = static_cast<std::uint64_t>(serverSettings.getMaxBodySize());
+        sessionOptions_.tooLargeResponse = tooLargeResponse_;
+        sessionOptions_.sessions = &sessions_;
+        sessionOptions_.running = &running_;
+        drainTimeout_ = std::chrono::seconds(serverSettings.getDrainTimeout());
+        serverTiming_ = serverSettings.getServerTiming();
+
+        // Потоковые обработчики читают тело синхронно - в асинхронных режимах
+        // их вызывает отдельный пул, а не потоки io_context
+        if (mode_ != ServerMode::ThreadPerConnection)
+        {
+            blockingPool_ = std::make_unique<asio::thread_pool>(serverSettings.getBlockingThreads());
+        }
+        sessionOptions_.blocking = blockingPool_.get();
 
         // Создаем endpoint
         auto const address = asio::ip::make_address(host);
         tcp::endpoint endpoint{address, static_cast<unsigned short>(port)};
 
-        // Создаем acceptor
-        acceptor_ = std::make_unique<tcp::acceptor>(*ioContext_, endpoint);
-
-        std::cout << "[Server] Listening on " << host << ":" << port << std::endl;
-        std::cout << "[Server] Server is ready to accept connections!" << std::endl;
+        if (mode_ == ServerMode::ReusePort)
+        {
+            runReusePort(endpoint, serverSettings.getThreads(),
+                         serverSettings.getMaxConnections(), serverSettings.getMaxInflight());
+        }
+        else
+        {
+            // Сроки всех соединений - в одном колесе таймеров
+            deadlines_ = std::make_unique<TimerWheel>();
+            sessionOptions_.deadlines = deadlines_.get();
 
-        running_ = true;
+            // Создаем IO контекст
+            ioContext_ = std::make_unique<asio::io_context>();
 
-        // Accept loop
-        while (running_)
-        {
-            tcp::socket socket{*ioContext_};
-            acceptor_->accept(socket);
+            // Создаем acceptor
+            acceptor_ = std::make_unique<tcp::acceptor>(*ioContext_, endpoint);
 
-            std::cout << "[Server] New connection accepted" << std::endl;
+            MS_LOG_INFO("[Server] Listening on ", host, ":", port);
 
-            std::thread([this](tcp::socket socket) {
-                handleSession(std::move(socket));
-            }, std::move(socket)).detach();
+            if (!beginRunning())
+            {
+                beast::error_code ec;
+                acceptor_->close(ec);
+            }
+            else if (mode_ == ServerMode::Pool || mode_ == ServerMode::Coroutine)
+            {
+                MS_LOG_INFO("[Server] Server is ready to accept connections!");
+                runPool(serverSettings.getThreads());
+            }
+            else
+            {
+                MS_LOG_INFO("[Server] Server is ready to accept connections!");
+                runThreadPerConnection();
+            }
         }
     }
     catch (const std::exception& e)
     {
-        std::cerr << "[Server] Error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[Server] Error: ", e.what());
         running_ = false;
     }
+    if (blockingPool_)
+    {
+        // Drain уже разбудил чтение оставшихся потоковых обработчиков
+        blockingPool_->join();
+        blockingPool_.reset();
+        sessionOptions_.blocking = nullptr;
+    }
+    stopRequested_ = false;
 }
 
-void BoostBeastApplication::handleSession(tcp::socket socket)
+bool BoostBeastApplication::beginRunning()
 {
-    try
+    running_ = true;
+    if (!stopRequested_)
     {
-        // Извлекаем IP клиента из сокета
-        std::string clientIp = "0.0.0.0";
-        try
+        return true;
+    }
+    // stop() уже вызван. Если он успел увидеть running_, то останавливает
+    // сервер сам и run() сразу вернётся; иначе не запускаемся
+    if (!running_.exchange(false))
+    {
+        return true;
+    }
+    MS_LOG_INFO("[Server] Stop requested before start, not serving");
+    return false;
+}
+
+void BoostBeastApplication::runThreadPerConnection()
+{
+    // Колесо таймеров продвигает отдельный поток
+    std::atomic<bool> tickerDone{false};
+    std::thread ticker([this, &tickerDone] {
+        while (!tickerDone)
         {
-            auto endpoint = socket.remote_endpoint();
-            clientIp = endpoint.address().to_string();
-            std::cout << "[Session] Client connected from: " << clientIp << std::endl;
+            std::this_thread::sleep_for(deadlines_->tick());
+            deadlines_->advance();
         }
-        catch (const std::exception& e)
+    });
+
+    // Accept loop
+    while (running_)
+    {
+        // В режиме паузы не принимаем соединение, пока нет свободного слота
+        AdmissionControl::Slot slot;
+        if (overloadPolicy_ == OverloadPolicy::Pause)
         {
-            std::cerr << "[Session] Failed to get client IP: " << e.what() << std::endl;
+            slot = waitConnectionSlot();
         }
-        
+
+        tcp::socket socket{*ioContext_};
+        beast::error_code ec;
+        acceptor_->accept(socket, ec);
+
+        if (!running_)
+        {
+            break;
+        }
+        if (ec)
+        {
+            MS_LOG_ERROR("[Server] Accept error: ", ec.message());
+            break;
+        }
+
+        if (!slot)
+        {
+            slot = admission_.tryAcquireConnection();
+        }
+        if (!slot)
+        {
+            rejectConnection(socket);
+            continue;
+        }
+
+        MS_LOG_DEBUG("[Server] New connection accepted");
+
+        // Поток отсоединён, но учтён в sessions_: stop() дожидается его завершения
+        std::thread([this, slot = std::move(slot), accepted = std::chrono::steady_clock::now(),
+                     connection = std::make_unique<tcp::socket>(std::move(socket))]() mutable {
+            handleSession(std::move(connection), std::move(slot), accepted);
+        }).detach();
+    }
+
+    admission_.clearWaiters();
+
+    beast::error_code ec;
+    acceptor_->close(ec);
+
+    // Сроки соединений нужны, пока stop() дожидается их завершения
+    sessions_.waitEmpty(std::chrono::steady_clock::now() + drainTimeout_ + std::chrono::seconds(1));
+    tickerDone = true;
+    ticker.join();
+}
+
+AdmissionControl::Slot BoostBeastApplication::waitConnectionSlot()
+{
+    while (running_)
+    {
+        auto ready = std::make_shared<std::promise<void>>();
+        auto future = ready->get_future();
+
+        auto slot = admission_.acquireConnectionOrWait([ready] { ready->set_value(); });
+        if (slot)
+        {
+            return slot;
+        }
+
+        while (running_ && future.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready)
+        {
+        }
+    }
+    return {};
+}
+
+void BoostBeastApplication::rejectConnection(tcp::socket& socket)
+{
+    // Ответ маленький и целиком помещается в буфер сокета - пишем синхронно
+    beast::error_code ec;
+    asio::write(socket, asio::buffer(overloadResponse_), ec);
+    socket.shutdown(tcp::socket::shutdown_send, ec);
+    socket.close(ec);
+}
+
+void BoostBeastApplication::runPool(int threads)
+{
+    MS_LOG_INFO("[Server] Running async pool with ", threads, " thread(s)");
+
+#ifdef MICROSERVICE_COROUTINES
+    if (mode_ == ServerMode::Coroutine)
+    {
+        asio::co_spawn(*ioContext_, coAccept(), asio::detached);
+    }
+    else
+#endif
+    {
+        doAccept(*acceptor_, admission_, sessionOptions_);
+    }
+
+    // io_context работает до stop(), даже если соединений и accept нет
+    auto work = asio::make_work_guard(*ioContext_);
+
+    asio::steady_timer ticker(*ioContext_);
+    tickDeadlines(ticker, *deadlines_);
+
+    // Текущий поток тоже обслуживает io_context, поэтому запускаем threads - 1 дополнительных
+    workers_.reserve(threads - 1);
+    for (int i = 1; i < threads; ++i)
+    {
+        workers_.emplace_back([this] { ioContext_->run(); });
+    }
+
+    ioContext_->run();
+
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+    workers_.clear();
+    admission_.clearWaiters();
+
+    beast::error_code ec;
+    acceptor_->close(ec);
+}
+
+void BoostBeastApplication::runReusePort(const tcp::endpoint& endpoint, int threads,
+                                         std::size_t maxConnections, std::size_t maxInflight)
+{
+    using reuse_port = asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+
+    // Доля общего лимита на шард (с округлением вверх), 0 остаётся "без ограничения"
+    auto share = [threads](std::size_t limit) {
+        return (limit + threads - 1) / threads;
+    };
+
+    // Каждый шард - свой io_context и свой acceptor на том же порту,
+    // ядро само распределяет входящие соединения между ними
+    shards_.resize(threads);
+    for (auto& shard : shards_)
+    {
+        shard.admission = std::make_unique<AdmissionControl>();
+        shard.admission->setLimits(share(maxConnections), share(maxInflight));
+        shard.deadlines = std::make_unique<TimerWheel>();
+        shard.sessionOptions = sessionOptions_;
+        shard.sessionOptions.admission = shard.admission.get();
+        shard.sessionOptions.deadlines = shard.deadlines.get();
+
+        shard.ioContext = std::make_unique<asio::io_context>(1);
+        shard.acceptor = std::make_unique<tcp::acceptor>(*shard.ioContext);
+        shard.acceptor->open(endpoint.protocol());
+        shard.acceptor->set_option(asio::socket_base::reuse_address(true));
+        shard.acceptor->set_option(reuse_port(true));
+        shard.acceptor->bind(endpoint);
+        shard.acceptor->listen(asio::socket_base::max_listen_connections);
+        doAccept(*shard.acceptor, *shard.admission, shard.sessionOptions);
+    }
+
+    MS_LOG_INFO("[Server] Listening on ", endpoint.address().to_string(), ":", endpoint.port(),
+                " with ", threads, " SO_REUSEPORT shard(s)");
+
+    if (!beginRunning())
+    {
+        shards_.clear();
+        return;
+    }
+    MS_LOG_INFO("[Server] Server is ready to accept connections!");
+
+    std::vector<asio::executor_work_guard<asio::io_context::executor_type>> work;
+    std::vector<std::unique_ptr<asio::steady_timer>> tickers;
+    for (auto& shard : shards_)
+    {
+        work.push_back(asio::make_work_guard(*shard.ioContext));
+        tickers.push_back(std::make_unique<asio::steady_timer>(*shard.ioContext));
+        tickDeadlines(*tickers.back(), *shard.deadlines);
+    }
+
+    // Текущий поток обслуживает шард 0, остальные - по собственному потоку
+    workers_.reserve(threads - 1);
+    for (int i = 1; i < threads; ++i)
+    {
+        workers_.emplace_back([this, i] { shards_[i].ioContext->run(); });
+    }
+
+    shards_[0].ioContext->run();
+
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+    workers_.clear();
+    work.clear();
+    tickers.clear();
+    for (auto& shard : shards_)
+    {
+        shard.admission->clearWaiters();
+    }
+    shards_.clear();
+}
+
+void BoostBeastApplication::doAccept(tcp::acceptor& acceptor, AdmissionControl& admission,
+                                     const HttpSession::Options& options)
+{
+    // В режиме паузы слот занимается до accept; если его нет, приём
+    // возобновится, когда какое-нибудь соединение закроется
+    AdmissionControl::Slot slot;
+    if (overloadPolicy_ == OverloadPolicy::Pause)
+    {
+        slot = admission.acquireConnectionOrWait([this, &acceptor, &admission, &options] {
+            asio::post(acceptor.get_executor(), [this, &acceptor, &admission, &options] {
+                if (running_ && acceptor.is_open())
+                {
+                    doAccept(acceptor, admission, options);
+                }
+            });
+        });
+        if (!slot)
+        {
+            return;
+        }
+    }
+
+    auto onAccept = [this, &acceptor, &admission, &options, slot = std::move(slot)](
+                        beast::error_code ec, tcp::socket socket) mutable {
+        if (ec)
+        {
+            // При остановке accept завершается ошибкой shutdown() слушающего сокета
+            if (ec != asio::error::operation_aborted && running_)
+            {
+                MS_LOG_ERROR("[Server] Accept error: ", ec.message());
+            }
+        }
+        else if (!slot && !(slot = admission.tryAcquireConnection()))
+        {
+            rejectConnection(socket);
+        }
+        else
+        {
+            std::make_shared<HttpSession>(
+                std::move(socket),
+                makeCallbacks(),
+                options,
+                std::move(slot))->run();
+        }
+
+        if (running_ && acceptor.is_open())
+        {
+            doAccept(acceptor, admission, options);
+        }
+    };
+
+    if (mode_ == ServerMode::Pool)
+    {
+        // Каждое соединение получает свой strand: обработчики одной сессии
+        // не выполняются параллельно, разные сессии распределяются по пулу
+        acceptor.async_accept(asio::make_strand(acceptor.get_executor()), std::move(onAccept));
+    }
+    else
+    {
+        // В шарде io_context однопоточный - strand не нужен
+        acceptor.async_accept(std::move(onAccept));
+    }
+}
+
+HttpSession::Callbacks BoostBeastApplication::makeCallbacks()
+{
+    return HttpSession::Callbacks{
+        [this](const HttpSession::Request& req,
+               HttpSession::Response& res,
+               const std::string& clientIp,
+               BeastResponseStream& stream,
+               HttpSession::Exchange& exchange) {
+            handleBeastRequest(req, res, clientIp, exchange, &stream);
+        },
+        [this](const HttpSession::HeaderParser& parser) {
+            return planBody(parser);
+        },
+        [this](IStreamingHttpHandler& handler,
+               const HttpSession::StreamRequest& req,
+               IBodyReader& body,
+               HttpSession::Response& res,
+               const std::string& clientIp,
+               BeastResponseStream& stream,
+               HttpSession::Exchange& exchange) {
+            handleBeastStream(handler, req, body, res, clientIp, exchange, &stream);
+        },
+        [this](HttpSession::Exchange& exchange) {
+            completeRequest(exchange);
+        }};
+}
+
+void BoostBeastApplication::handleSession(std::unique_ptr<tcp::socket> connection, AdmissionControl::Slot slot,
+                                          std::chrono::steady_clock::time_point accepted)
+{
+    // Простаивающее соединение stop() закрывает через shutdown(): poll() и
+    // read() в этом потоке сразу завершаются. Регистрация снимается после
+    // закрытия сокета, поэтому дескриптор не может быть уже переиспользован
+    std::atomic<bool> idle{true};
+    auto registration = sessions_.add([fd = connection->native_handle(), &idle](bool force) {
+        if (force || idle.load())
+        {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    });
+    // Сокет и слот освобождаются раньше снятия регистрации: после неё
+    // stop() может вернуться, и приложение вместе с io_context будет уничтожено
+    auto owned = std::move(connection);
+    AdmissionControl::Slot connectionSlot = std::move(slot);
+    tcp::socket& socket = *owned;
+
+    // Истёкший срок будит заблокированные poll()/read()/write() тем же shutdown();
+    // таймер снимается с колеса раньше, чем закрывается сокет
+    TimerWheel::Timer deadline([fd = socket.native_handle()] { ::shutdown(fd, SHUT_RDWR); });
+
+    try
+    {
+        RequestCycle cycle(makeCallbacks(), sessionOptions_, RequestCycle::remoteIp(socket));
+        MS_LOG_DEBUG("[Session] Client connected from: ", cycle.clientIp());
         beast::flat_buffer buffer;
 
-        // Читаем HTTP запрос
-        http::request<http::string_body> req;
-        http::read(socket, buffer, req);
+        // Keep-alive: обслуживаем запросы на одном сокете и буфере,
+        // пока клиент не закроет соединение или не сработает лимит
+        for (bool first = true; running_; first = false)
+        {
+            // Новое соединение должно прислать запрос за headerTimeout, keep-alive -
+            // простаивать не дольше idleTimeout (pipelined-данные уже в буфере)
+            if (buffer.size() == 0)
+            {
+                deadlines_->schedule(deadline, first ? sessionOptions_.headerTimeout
+                                                     : sessionOptions_.idleTimeout);
+                idle = true;
+                if (!waitReadable(socket))
+                {
+                    break;
+                }
+            }
+            idle = false;
+
+            auto& headerParser = cycle.startRequest(accepted);
+            beast::error_code ec;
+            deadlines_->schedule(deadline, sessionOptions_.headerTimeout);
+            http::read_header(socket, buffer, headerParser, ec);
+            deadlines_->cancel(deadline);
 
-        std::cout << "[Session] Received request: " 
-                  << req.method_string() << " " << req.target() << std::endl;
+            if (ec == http::error::end_of_stream)
+            {
+                break;
+            }
+            if (ec)
+            {
+                throw beast::system_error{ec};
+            }
 
-        // Создаем HTTP ответ
-        http::response<http::string_body> res{http::status::ok, req.version()};
-        res.set(http::field::server, "BoostBeast");
-        res.keep_alive(req.keep_alive());
+            auto step = cycle.onHeader(buffer);
+            if (step == RequestCycle::Step::ReadBody)
+            {
+                deadlines_->schedule(deadline, sessionOptions_.bodyTimeout);
+                http::read(socket, buffer, cycle.parser(), ec);
+                deadlines_->cancel(deadline);
+                if (ec && ec != http::error::body_limit)
+                {
+                    throw beast::system_error{ec};
+                }
+                step = cycle.onBody(ec);
+            }
+            if (step != RequestCycle::Step::Reject)
+            {
+                step = cycle.admit(step, socket, BeastResponseStream::Mode::Blocking);
+            }
 
-        handleBeastRequest(req, res, clientIp);
+            // Готовый ответ 413/503 без обработчика; учитывается как обычный ответ
+            if (step == RequestCycle::Step::Reject)
+            {
+                auto response = cycle.rejection();
+                deadlines_->schedule(deadline, sessionOptions_.writeTimeout);
+                asio::write(socket, asio::buffer(response.data(), response.size()), ec);
+                deadlines_->cancel(deadline);
+                cycle.completeRequest();
+                break;
+            }
 
-        // Отправляем ответ
-        http::write(socket, res);
+            bool handled = step == RequestCycle::Step::Stream ? cycle.handleStream(socket, buffer)
+                                                              : cycle.handle();
+            if (!handled)
+            {
+                break;
+            }
 
-        std::cout << "[Session] Response sent with status: " 
-                  << res.result_int() << std::endl;
+            // Ответ, отправленный порциями, поток ответа завершает сам
+            auto reply = cycle.reply(!running_);
+            if (reply == RequestCycle::Reply::Message)
+            {
+                deadlines_->schedule(deadline, sessionOptions_.writeTimeout);
+                http::write(socket, cycle.response(), ec);
+                deadlines_->cancel(deadline);
+            }
+            cycle.completeRequest();
+            if (ec)
+            {
+                throw beast::system_error{ec};
+            }
+
+            MS_LOG_DEBUG("[Session] Response sent with status: ", cycle.response().result_int());
+
+            if (reply == RequestCycle::Reply::Failed || !cycle.keepAlive())
+            {
+                break;
+            }
+        }
 
         // Закрываем соединение
         beast::error_code ec;
@@ -228,7 +904,7 @@ void BoostBeastApplication::handleSession(tcp::socket socket)
 
         if (ec && ec != beast::errc::not_connected)
         {
-            std::cerr << "[Session] Shutdown error: " << ec.message() << std::endl;
+            MS_LOG_WARN("[Session] Shutdown error: ", ec.message());
         }
     }
     catch (const beast::system_error& se)
@@ -236,48 +912,69 @@ void BoostBeastApplication::handleSession(tcp::socket socket)
         if (se.code() != http::error::end_of_stream &&
             se.code() != beast::errc::not_connected)
         {
-            std::cerr << "[Session] Error: " << se.what() << std::endl;
+            MS_LOG_WARN("[Session] Error: ", se.what());
         }
     }
     catch (const std::exception& e)
     {
-        std::cerr << "[Session] Unexpected error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[Session] Unexpected error: ", e.what());
     }
 }
 
 // метод создает адаптеры и вызывает виртуальный handleRequest
 void BoostBeastApplication::handleBeastRequest(
-    const http::request<http::string_body>& req,
-    http::response<http::string_body>& res,
-    const std::string& clientIp)
+    const HttpSession::Request& req,
+    HttpSession::Response& res,
+    const std::string& clientIp,
+    HttpSession::Exchange& exchange,
+    BeastResponseStream* stream)
 {
+    auto inflight = metricsEnabled_ ? metrics_.trackRequest() : MetricsRegistry::Inflight();
+
     // Создаем адаптеры
     BeastRequestAdapter requestAdapter(req, clientIp);
-    BeastResponseAdapter responseAdapter(res);
+    requestAdapter.setTiming(&exchange.timing);
+    exchange.ip = clientIp;
+    BeastResponseAdapter responseAdapter(res, stream);
     
     // Вызываем виртуальный метод
     handleRequest(requestAdapter, responseAdapter);
+
+    finishHandling(requestAdapter, res, stream, requestAdapter.body().size(), exchange);
 }
 
-void BoostBeastApplication::handleRequest(IRequest& req, IResponse& res)
+void BoostBeastApplication::handleRequest(BeastRequestAdapter& req, IResponse& res)
 {
-    std::string path = req.getPath();
-    std::string method = req.getMethod();
+    std::string_view path = req.path();
+    std::string_view method = req.methodName();
 
-    std::cout << "[BoostBeastApplication] " << method << " " << path
-              << " from " << req.getIp() << std::endl;
+    MS_LOG_DEBUG("[BoostBeastApplication] ", method, " ", path, " from ", req.getIp());
 
-    auto handler = findHandler(method, path);
+    StaticHandler staticHandler = staticRoutes_.find(req.method(), path);
+    auto handler = staticHandler ? nullptr : findHandler(req.method(), method, path, &req.pathParams());
+    if (staticHandler)
+    {
+        // Маршрут статической таблицы - точный путь, он же паттерн
+        req.pathParams().setPattern(path);
+    }
+    req.mark(RequestTiming::Routed);
 
-    if (handler)
+    if (staticHandler || handler)
     {
         try
         {
-            handler->handle(req, res);
+            if (staticHandler)
+            {
+                staticHandler(req, res);
+            }
+            else
+            {
+                handler->handle(req, res);
+            }
         }
         catch (const std::exception& e)
         {
-            std::cerr << "[BoostBeastApplication] Handler error: " << e.what() << std::endl;
+            MS_LOG_ERROR("[BoostBeastApplication] Handler error: ", e.what());
             res.setStatus(500);
             res.setHeader("Content-Type", "application/json");
             res.setBody(R"({"error": "Internal server error"})");
@@ -285,7 +982,7 @@ void BoostBeastApplication::handleRequest(IRequest& req, IResponse& res)
     }
     else
     {
-        std::cout << "[BoostBeastApplication] No handler found" << std::endl;
+        MS_LOG_DEBUG("[BoostBeastApplication] No handler found");
 
         res.setStatus(404);
         res.setHeader("Content-Type", "application/json");
@@ -293,36 +990,522 @@ void BoostBeastApplication::handleRequest(IRequest& req, IResponse& res)
     }
 }
 
+HttpSession::BodyPlan BoostBeastApplication::planBody(const HttpSession::HeaderParser& parser)
+{
+    HttpSession::BodyPlan plan{sessionOptions_.maxBodySize, nullptr};
+
+    // Запрос без тела маршрутизирует handleRequest, второй поиск не нужен,
+    // если только обработчик не придётся выполнить в пуле blocking
+    if (!responseStreams_ && !parser.chunked() && parser.content_length().value_or(0) == 0)
+    {
+        return plan;
+    }
+
+    const auto& header = parser.get();
+    auto target = header.target();
+    auto path = target.substr(0, target.find('?'));
+
+    auto method = header.method_string();
+    auto handler = findHandler(BeastRequestAdapter::toHttpMethod(header.method()),
+                               std::string_view(method.data(), method.size()),
+                               std::string_view(path.data(), path.size()));
+    if (!handler)
+    {
+        return plan;
+    }
+
+    if (auto limit = handler->maxBodySize())
+    {
+        plan.limit = limit;
+    }
+    plan.stream = std::dynamic_pointer_cast<IStreamingHttpHandler>(handler);
+    plan.streamsResponse = handler->streamsResponse();
+    return plan;
+}
+
+void BoostBeastApplication::handleBeastStream(
+    IStreamingHttpHandler& handler,
+    const HttpSession::StreamRequest& req,
+    IBodyReader& body,
+    HttpSession::Response& res,
+    const std::string& clientIp,
+    HttpSession::Exchange& exchange,
+    BeastResponseStream* stream)
+{
+    auto inflight = metricsEnabled_ ? metrics_.trackRequest() : MetricsRegistry::Inflight();
+    BeastRequestAdapter requestAdapter(req, clientIp);
+    requestAdapter.setTiming(&exchange.timing);
+    exchange.ip = clientIp;
+    BeastResponseAdapter responseAdapter(res, stream);
+
+    // Обработчик найден по заголовкам в planBody, здесь нужны только сегменты пути
+    findHandler(requestAdapter.method(), requestAdapter.methodName(), requestAdapter.path(),
+                &requestAdapter.pathParams());
+    requestAdapter.mark(RequestTiming::Routed);
+
+    MS_LOG_DEBUG("[BoostBeastApplication] ", requestAdapter.methodName(), " ", requestAdapter.path(),
+                 " from ", clientIp, " (streaming body)");
+
+    try
+    {
+        handler.handleStream(requestAdapter, body, responseAdapter);
+    }
+    catch (const beast::system_error& e)
+    {
+        // Остальные ошибки чтения означают, что соединение уже не пригодно
+        if (e.code() != http::error::body_limit)
+        {
+            throw;
+        }
+        responseAdapter.setStatus(413);
+        responseAdapter.setHeader("Content-Type", "application/json");
+        responseAdapter.setBody(R"({"error": "Payload too large"})");
+    }
+    catch (const std::exception& e)
+    {
+        MS_LOG_ERROR("[BoostBeastApplication] Handler error: ", e.what());
+        responseAdapter.setStatus(500);
+        responseAdapter.setHeader("Content-Type", "application/json");
+        responseAdapter.setBody(R"({"error": "Internal server error"})");
+    }
+
+    finishHandling(requestAdapter, res, stream, body.contentLength().value_or(0), exchange);
+}
+
+void BoostBeastApplication::finishHandling(const BeastRequestAdapter& req, HttpSession::Response& res,
+                                           const BeastResponseStream* stream, std::uint64_t bytesIn,
+                                           HttpSession::Exchange& exchange)
+{
+    exchange.timing.mark(RequestTiming::Handled);
+    exchange.method = req.methodName();
+    exchange.route = req.getPathParams().pattern();
+    exchange.status = res.result_int();
+    exchange.bytesIn = bytesIn;
+    exchange.bytesOut = stream ? stream->bodySize() : res.body().size();
+
+    // Заголовки ответа, отправленного порциями, уже ушли; файл и общий
+    // буфер отправляются с заголовками позже, при finish()
+    if (serverTiming_ && !(stream && stream->headersSent()))
+    {
+        res.set("Server-Timing", formatServerTiming(exchange.timing));
+    }
+}
+
+void BoostBeastApplication::completeRequest(HttpSession::Exchange& exchange)
+{
+    const RequestTiming& timing = exchange.timing;
+    if (metricsEnabled_)
+    {
+        metrics_.recordRequest(exchange.method, exchange.route, exchange.status, timing.total());
+    }
+
+    if (timingExporter_)
+    {
+        try
+        {
+            timingExporter_->exportTiming(timing, exchange.method, exchange.route, exchange.status);
+        }
+        catch (const std::exception& e)
+        {
+            MS_LOG_ERROR("[BoostBeastApplication] Timing exporter error: ", e.what());
+        }
+    }
+
+    if (!accessLog_)
+    {
+        return;
+    }
+
+    auto sinceStart = RequestTiming::Clock::now() - timing.marks[RequestTiming::ReadStarted];
+    auto startedAt = std::chrono::system_clock::now() -
+                     std::chrono::duration_cast<std::chrono::system_clock::duration>(sinceStart);
+    auto micros = [](RequestTiming::Clock::duration duration) {
+        return static_cast<std::uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    };
+
+    AccessRecord record{};
+    record.timeNs = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(startedAt.time_since_epoch()).count());
+    record.bytesIn = exchange.bytesIn;
+    record.bytesOut = exchange.bytesOut;
+    record.phaseUs[AccessRecord::Read] = micros(timing.read());
+    record.phaseUs[AccessRecord::Route] = micros(timing.route());
+    record.phaseUs[AccessRecord::Handle] = micros(timing.handle());
+    record.phaseUs[AccessRecord::Write] = micros(timing.write());
+    record.status = static_cast<std::uint16_t>(exchange.status);
+    record.setMethod(exchange.method);
+    record.setRoute(exchange.route);
+    record.setIp(exchange.ip);
+    accessLog_->record(record);
+}
+
+void BoostBeastApplication::setTimingExporter(std::shared_ptr<IRequestTimingExporter> exporter)
+{
+    timingExporter_ = std::move(exporter);
+}
+
 std::shared_ptr<IHttpHandler> BoostBeastApplication::findHandler(
-    const std::string& method,
-    const std::string& path)
+    std::string_view method,
+    std::string_view path,
+    PathParams* params) const
 {
-    std::string exactKey = getHandlerKey(method, path);
-    auto it = handlers_.find(exactKey);
-    if (it != handlers_.end())
+    return router_.find(method, path, params);
+}
+
+std::shared_ptr<IHttpHandler> BoostBeastApplication::findHandler(
+    HttpMethod method,
+    std::string_view methodName,
+    std::string_view path,
+    PathParams* params) const
+{
+    return router_.find(method, methodName, path, params);
+}
+
+void BoostBeastApplication::setStaticRoutes(StaticRoutes routes)
+{
+    staticRoutes_ = routes;
+}
+
+MetricsRegistry& BoostBeastApplication::metrics()
+{
+    return metrics_;
+}
+
+void BoostBeastApplication::registerRouteMetrics()
+{
+    for (const auto& [key, handler] : handlers_)
     {
-        return it->second;
+        size_t methodDelimiter = key.find(':');
+        if (methodDelimiter != std::string::npos)
+        {
+            std::string_view view = key;
+            metrics_.addRoute(view.substr(0, methodDelimiter), view.substr(methodDelimiter + 1));
+        }
     }
+    staticRoutes_.forEach([this](const StaticRoute& route) {
+        metrics_.addRoute(httpMethodName(route.method), route.path);
+    });
+}
 
+void BoostBeastApplication::compileRoutes()
+{
+    router_.clear();
+    responseStreams_ = false;
     for (const auto& [key, handler] : handlers_)
     {
         size_t methodDelimiter = key.find(':');
         if (methodDelimiter == std::string::npos)
             continue;
 
-        std::string handlerMethod = key.substr(0, methodDelimiter);
-        std::string handlerPattern = key.substr(methodDelimiter + 1);
+        std::string_view view = key;
+        router_.add(view.substr(0, methodDelimiter), view.substr(methodDelimiter + 1), handler);
+        responseStreams_ = responseStreams_ || handler->streamsResponse();
+    }
+}
+
+std::string BoostBeastApplication::getHandlerKey(const std::string& method, const std::string& pattern) const
+{
+    return method + ":" + pattern;
+}
+
+#ifdef MICROSERVICE_COROUTINES
+
+asio::awaitable<void> BoostBeastApplication::coAccept()
+{
+    while (running_ && acceptor_->is_open())
+    {
+        // В режиме паузы ждём освобождения слота: resume отменяет таймер
+        AdmissionControl::Slot slot;
+        while (overloadPolicy_ == OverloadPolicy::Pause && !slot && running_)
+        {
+            auto wakeup = std::make_shared<asio::steady_timer>(
+                acceptor_->get_executor(), asio::steady_timer::time_point::max());
+            slot = admission_.acquireConnectionOrWait([wakeup] {
+                asio::post(wakeup->get_executor(), [wakeup] { wakeup->cancel(); });
+            });
+            if (!slot)
+            {
+                beast::error_code waitEc;
+                co_await wakeup->async_wait(asio::redirect_error(asio::use_awaitable, waitEc));
+            }
+        }
+
+        // Каждая сессия - отдельная корутина на своём strand
+        beast::error_code ec;
+        tcp::socket socket = co_await acceptor_->async_accept(
+            asio::make_strand(*ioContext_), asio::redirect_error(asio::use_awaitable, ec));
+
+        if (ec)
+        {
+            if (ec == asio::error::operation_aborted || !running_)
+            {
+                co_return;
+            }
+            MS_LOG_ERROR("[Server] Accept error: ", ec.message());
+            continue;
+        }
+
+        if (!slot && !(slot = admission_.tryAcquireConnection()))
+        {
+            rejectConnection(socket);
+            continue;
+        }
+
+        asio::co_spawn(socket.get_executor(), coSession(std::move(socket), std::move(slot)), asio::detached);
+    }
+}
+
+asio::awaitable<void> BoostBeastApplication::coSession(tcp::socket socket, AdmissionControl::Slot slot)
+{
+    auto accepted = std::chrono::steady_clock::now();
+    // Состояние разделяется с обработчиками drain и сроков; сильную ссылку
+    // они берут только на strand, а не под блокировкой реестра или колеса
+    auto state = std::make_shared<CoSessionState>(std::move(socket), *deadlines_);
+    auto executor = state->socket.get_executor();
+    std::weak_ptr<CoSessionState> weak = state;
+
+    auto registration = sessions_.add([weak, executor](bool force) {
+        asio::post(executor, [weak, force] {
+            if (auto locked = weak.lock())
+            {
+                locked->closeForDrain(force);
+            }
+        });
+    });
+    state->deadline.setHandler([weak, executor] {
+        asio::post(executor, [weak] {
+            if (auto locked = weak.lock())
+            {
+                locked->onDeadline();
+            }
+        });
+    });
+
+    // Слот возвращается раньше снятия регистрации: после неё объект может быть уничтожен
+    AdmissionControl::Slot connectionSlot = std::move(slot);
+    tcp::socket& sock = state->socket;
+
+    RequestCycle cycle(makeCallbacks(), sessionOptions_, RequestCycle::remoteIp(sock));
+    beast::flat_buffer buffer;
+    beast::error_code ec;
+
+    for (bool first = true; running_; first = false)
+    {
+        // Новое соединение должно прислать запрос за headerTimeout, keep-alive -
+        // простаивать не дольше idleTimeout (pipelined-данные уже в буфере)
+        if (buffer.size() == 0)
+        {
+            state->idle = true;
+            state->arm(first ? sessionOptions_.headerTimeout : sessionOptions_.idleTimeout);
+            co_await sock.async_wait(tcp::socket::wait_read, asio::redirect_error(asio::use_awaitable, ec));
+            state->idle = false;
+            // Drain или срок могли закрыть сокет, пока корутина ждала strand
+            if (ec || !sock.is_open())
+            {
+                state->disarm();
+                co_return;
+            }
+        }
+
+        auto& headerParser = cycle.startRequest(accepted);
+        state->arm(sessionOptions_.headerTimeout);
+        co_await http::async_read_header(sock, buffer, headerParser, asio::redirect_error(asio::use_awaitable, ec));
+        state->disarm();
+
+        if (ec == http::error::end_of_stream)
+        {
+            break;
+        }
+        if (ec)
+        {
+            if (ec != asio::error::operation_aborted)
+            {
+                MS_LOG_WARN("[Session] Read error: ", ec.message());
+            }
+            co_return;
+        }
+
+        auto step = cycle.onHeader(buffer);
+        if (step == RequestCycle::Step::ReadBody)
+        {
+            state->arm(sessionOptions_.bodyTimeout);
+            co_await http::async_read(sock, buffer, cycle.parser(), asio::redirect_error(asio::use_awaitable, ec));
+            state->disarm();
+            if (ec && ec != http::error::body_limit)
+            {
+                if (ec != asio::error::operation_aborted)
+                {
+                    MS_LOG_WARN("[Session] Read error: ", ec.message());
+                }
+                co_return;
+            }
+            step = cycle.onBody(ec);
+        }
+        if (step != RequestCycle::Step::Reject)
+        {
+            // Ответ обработчик только собирает, отправляет его корутина (кроме offloaded())
+            step = cycle.admit(step, sock, BeastResponseStream::Mode::Deferred);
+        }
+
+        // Готовый ответ 413/503 без обработчика; учитывается как обычный ответ
+        if (step == RequestCycle::Step::Reject)
+        {
+            auto response = cycle.rejection();
+            state->arm(sessionOptions_.writeTimeout);
+            co_await asio::async_write(sock, asio::buffer(response.data(), response.size()),
+                                       asio::redirect_error(asio::use_awaitable, ec));
+            state->disarm();
+            cycle.completeRequest();
+            break;
+        }
+
+        // Вызвать обработчик и подготовить ответ; пусто - закрыть соединение
+        auto runHandler = [&]() -> asio::awaitable<std::optional<RequestCycle::Reply>> {
+            if (step == RequestCycle::Step::Stream)
+            {
+                if (!cycle.handleStream(sock, buffer))
+                {
+                    co_return std::nullopt;
+                }
+            }
+            else
+            {
+                co_await handleBeastRequestAsync(cycle.request(), cycle.response(), cycle.clientIp(),
+                                                 cycle.exchange(), &cycle.stream());
+            }
+            co_return cycle.reply(!running_);
+        };
 
-        if (handlerMethod == method && RouteMatcher::matches(handlerPattern, path))
+        std::optional<RequestCycle::Reply> reply;
+        if (cycle.offloaded())
         {
-            return handler;
+            // Обработчик читает тело или пишет ответ синхронно - он
+            // выполняется в пуле blocking, корутина ждёт его завершения
+            state->offloaded = true;
+            reply = co_await asio::co_spawn(*blockingPool_, runHandler, asio::use_awaitable);
+            state->offloaded = false;
+        }
+        else
+        {
+            reply = co_await runHandler();
+        }
+        if (!reply)
+        {
+            co_return;
+        }
+        if (*reply == RequestCycle::Reply::Failed)
+        {
+            cycle.completeRequest();
+            co_return;
+        }
+
+        state->arm(sessionOptions_.writeTimeout);
+        if (*reply == RequestCycle::Reply::Message)
+        {
+            co_await http::async_write(sock, cycle.response(), asio::redirect_error(asio::use_awaitable, ec));
+        }
+        else
+        {
+            // Ответ порциями, из общего буфера или файла: собранное уходит одной
+            // записью, файл - sendfile(2) по готовности сокета, всё под одним сроком
+            co_await asio::async_write(sock, cycle.stream().output(), asio::redirect_error(asio::use_awaitable, ec));
+            while (!ec && cycle.stream().filePending())
+            {
+                cycle.stream().sendFileSome(ec);
+                if (ec == asio::error::would_block)
+                {
+                    ec = {};
+                    co_await sock.async_wait(tcp::socket::wait_write, asio::redirect_error(asio::use_awaitable, ec));
+                }
+            }
+        }
+        state->disarm();
+        cycle.completeRequest();
+        if (ec)
+        {
+            if (ec != asio::error::operation_aborted)
+            {
+                MS_LOG_WARN("[Session] Write error: ", ec.message());
+            }
+            co_return;
+        }
+
+        if (!cycle.keepAlive())
+        {
+            break;
         }
     }
 
-    return nullptr;
+    sock.shutdown(tcp::socket::shutdown_send, ec);
 }
 
-std::string BoostBeastApplication::getHandlerKey(const std::string& method, const std::string& pattern) const
+asio::awaitable<void> BoostBeastApplication::handleBeastRequestAsync(
+    const HttpSession::Request& req,
+    HttpSession::Response& res,
+    const std::string& clientIp,
+    HttpSession::Exchange& exchange,
+    BeastResponseStream* stream)
 {
-    return method + ":" + pattern;
+    auto inflight = metricsEnabled_ ? metrics_.trackRequest() : MetricsRegistry::Inflight();
+    BeastRequestAdapter requestAdapter(req, clientIp);
+    requestAdapter.setTiming(&exchange.timing);
+    exchange.ip = clientIp;
+    BeastResponseAdapter responseAdapter(res, stream);
+
+    co_await handleRequestAsync(requestAdapter, responseAdapter);
+
+    finishHandling(requestAdapter, res, stream, requestAdapter.body().size(), exchange);
 }
+
+asio::awaitable<void> BoostBeastApplication::handleRequestAsync(BeastRequestAdapter& req, IResponse& res)
+{
+    std::string_view path = req.path();
+    std::string_view method = req.methodName();
+
+    MS_LOG_DEBUG("[BoostBeastApplication] ", method, " ", path, " from ", req.getIp());
+
+    StaticHandler staticHandler = staticRoutes_.find(req.method(), path);
+    auto handler = staticHandler ? nullptr : findHandler(req.method(), method, path, &req.pathParams());
+    if (staticHandler)
+    {
+        req.pathParams().setPattern(path);
+    }
+    req.mark(RequestTiming::Routed);
+
+    if (!staticHandler && !handler)
+    {
+        MS_LOG_DEBUG("[BoostBeastApplication] No handler found");
+
+        res.setStatus(404);
+        res.setHeader("Content-Type", "application/json");
+        res.setBody(R"({"error": "Not found"})");
+        co_return;
+    }
+
+    try
+    {
+        // Синхронные IHttpHandler выполняются прямо в корутине
+        if (staticHandler)
+        {
+            staticHandler(req, res);
+        }
+        else if (auto* asyncHandler = dynamic_cast<IAsyncHttpHandler*>(handler.get()))
+        {
+            co_await asyncHandler->handleAsync(req, res);
+        }
+        else
+        {
+            handler->handle(req, res);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        MS_LOG_ERROR("[BoostBeastApplication] Handler error: ", e.what());
+        res.setStatus(500);
+        res.setHeader("Content-Type", "application/json");
+        res.setBody(R"({"error": "Internal server error"})");
+    }
+}
+
+#endif // MICROSERVICE_COROUTINES
@@ -1,26 +1,90 @@
 #include "HttpClient.hpp"
-#include <iostream>
+#include "Logger.hpp"
+#include <stdexcept>
 
 using tcp = boost::asio::ip::tcp;
 namespace beast = boost::beast;
 namespace http = beast::http;
 namespace asio = boost::asio;
 
+namespace
+{
+
+// Повтор на новом соединении безопасен, только если запрос можно выполнить дважды
+bool isIdempotent(http::verb method)
+{
+    switch (method)
+    {
+    case http::verb::get:
+    case http::verb::head:
+    case http::verb::options:
+    case http::verb::put:
+    case http::verb::delete_:
+    case http::verb::trace:
+        return true;
+    default:
+        return false;
+    }
+}
+
+int nonNegative(const IEnvironment& env, const std::string& key, int defaultValue)
+{
+    int value = env.get<int>(key, defaultValue);
+    if (value < 0)
+    {
+        throw std::runtime_error("Invalid setting: " + key + " must not be negative");
+    }
+    return value;
+}
+
+int positive(const IEnvironment& env, const std::string& key, int defaultValue)
+{
+    int value = env.get<int>(key, defaultValue);
+    if (value <= 0)
+    {
+        throw std::runtime_error("Invalid setting: " + key + " must be positive");
+    }
+    return value;
+}
+
+} // namespace
+
+HttpClient::Options HttpClient::Options::fromEnvironment(const IEnvironment& env)
+{
+    Options options;
+    options.maxIdlePerHost = static_cast<std::size_t>(
+        nonNegative(env, "http_client.max_idle_per_host", static_cast<int>(options.maxIdlePerHost)));
+    options.maxConnectionsPerHost = static_cast<std::size_t>(
+        nonNegative(env, "http_client.max_connections_per_host", static_cast<int>(options.maxConnectionsPerHost)));
+    options.idleTimeout = std::chrono::milliseconds(
+        positive(env, "http_client.idle_timeout_ms", static_cast<int>(options.idleTimeout.count())));
+    options.acquireTimeout = std::chrono::milliseconds(
+        positive(env, "http_client.acquire_timeout_ms", static_cast<int>(options.acquireTimeout.count())));
+    return options;
+}
+
+HttpClient::HttpClient() : HttpClient(Options{})
+{
+}
+
+HttpClient::HttpClient(Options options) : options_(options), nextSweep_(Clock::now() + options_.idleTimeout)
+{
+}
+
+HttpClient::~HttpClient()
+{
+    closeIdle();
+}
+
 bool HttpClient::send(const IRequest& request, IResponse& response)
 {
     try
     {
+        std::string host = request.getIp();
         std::string portStr = std::to_string(request.getPort());
+        std::string key = host + ":" + portStr;
 
-        std::cout << "[HttpClient] Sending " << request.getMethod() 
-                  << " " << request.getIp() << ":" << portStr << request.getPath() << std::endl;
-
-        asio::io_context ioc;
-        tcp::resolver resolver(ioc);
-        auto results = resolver.resolve(request.getIp(), portStr);
-
-        beast::tcp_stream stream(ioc);
-        stream.connect(results);
+        MS_LOG_DEBUG("[HttpClient] Sending ", request.getMethod(), " ", key, request.getPath());
 
         // Формируем HTTP запрос
         http::request<http::string_body> req;
@@ -29,13 +93,13 @@ bool HttpClient::send(const IRequest& request, IResponse& response)
         req.version(11);
 
         // Базовые хэдеры
-        req.set(http::field::host, request.getIp());
+        req.set(http::field::host, host);
         req.set(http::field::user_agent, "microservices/1.0");
 
         // Копируем хэдеры из IRequest
-        for (const auto& [key, value] : request.getHeaders())
+        for (const auto& [name, value] : request.getHeaders())
         {
-            req.set(key, value);
+            req.set(name, value);
         }
 
         // Устанавливаем body если есть
@@ -48,24 +112,44 @@ bool HttpClient::send(const IRequest& request, IResponse& response)
 
         req.prepare_payload();
 
-        // Отправляем запрос
-        http::write(stream, req);
-
-        // Читаем ответ
-        beast::flat_buffer buffer;
         http::response<http::string_body> res;
-        http::read(stream, buffer, res);
+        for (int attempt = 0;; ++attempt)
+        {
+            Lease lease = acquire(key, host, portStr);
 
-        // Закрываем соединение
-        beast::error_code ec;
-        stream.socket().shutdown(tcp::socket::shutdown_both, ec);
+            beast::error_code ec;
+            beast::flat_buffer buffer;
+            res = {};
+            http::write(*lease.stream, req, ec);
+            if (!ec)
+            {
+                http::read(*lease.stream, buffer, res, ec);
+            }
 
-        std::cout << "[HttpClient] Received status: " << res.result_int() << std::endl;
+            if (ec)
+            {
+                release(key, std::move(lease.stream), false);
+                // Сервер мог закрыть простаивавшее соединение уже после проверки
+                if (lease.reused && attempt == 0 && isIdempotent(req.method()))
+                {
+                    MS_LOG_DEBUG("[HttpClient] Pooled connection to ", key, " failed (", ec.message(), "), retrying");
+                    continue;
+                }
+                throw beast::system_error(ec);
+            }
+
+            // Лишние байты после ответа означают, что поток рассинхронизирован
+            bool reusable = req.keep_alive() && res.keep_alive() && buffer.size() == 0;
+            release(key, std::move(lease.stream), reusable);
+            break;
+        }
+
+        MS_LOG_DEBUG("[HttpClient] Received status: ", res.result_int());
 
         // Заполняем response
         response.setStatus(res.result_int());
-        response.setBody(res.body());
-        
+        response.setBody(std::move(res.body()));
+
         for (const auto& field : res)
         {
             response.setHeader(std::string(field.name_string()), std::string(field.value()));
@@ -75,9 +159,176 @@ bool HttpClient::send(const IRequest& request, IResponse& response)
     }
     catch (const std::exception& e)
     {
-        std::cerr << "[HttpClient] Error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[HttpClient] Error: ", e.what());
         response.setStatus(500);
         response.setBody("Internal Server Error");
         return false;
     }
 }
+
+HttpClient::Lease HttpClient::acquire(const std::string& key, const std::string& host, const std::string& port)
+{
+    auto deadline = Clock::now() + options_.acquireTimeout;
+    std::unique_lock lock(mutex_);
+    while (true)
+    {
+        // Ссылки на элементы unordered_map переживают рехеширование
+        Pool& pool = pools_[key];
+        auto now = Clock::now();
+        evictExpired(pool, now);
+        sweepIfDue(now);
+
+        // Последнее возвращённое соединение - самое "тёплое"
+        while (!pool.idle.empty())
+        {
+            std::unique_ptr<Stream> stream = std::move(pool.idle.back().stream);
+            pool.idle.pop_back();
+            lock.unlock();
+            if (healthy(*stream))
+            {
+                return {std::move(stream), true};
+            }
+            MS_LOG_DEBUG("[HttpClient] Dropping closed pooled connection to ", key);
+            stream.reset();
+            lock.lock();
+            --pool.open;
+        }
+
+        if (options_.maxConnectionsPerHost == 0 || pool.open < options_.maxConnectionsPerHost)
+        {
+            ++pool.open;
+            auto endpoints = pool.endpoints;
+            lock.unlock();
+            try
+            {
+                if (endpoints.empty())
+                {
+                    tcp::resolver resolver(ioc_);
+                    endpoints = resolver.resolve(host, port);
+                    std::lock_guard guard(mutex_);
+                    pools_[key].endpoints = endpoints;
+                }
+                auto stream = std::make_unique<Stream>(ioc_);
+                stream->connect(endpoints);
+                stream->socket().set_option(tcp::no_delay(true));
+                return {std::move(stream), false};
+            }
+            catch (...)
+            {
+                {
+                    // Адрес мог смениться: в следующий раз разрешаем заново
+                    std::lock_guard guard(mutex_);
+                    Pool& failed = pools_[key];
+                    --failed.open;
+                    failed.endpoints = {};
+                }
+                released_.notify_all();
+                throw;
+            }
+        }
+
+        if (released_.wait_until(lock, deadline) == std::cv_status::timeout)
+        {
+            throw std::runtime_error("connection pool for " + key + " is exhausted");
+        }
+    }
+}
+
+void HttpClient::release(const std::string& key, std::unique_ptr<Stream> stream, bool reusable)
+{
+    {
+        std::lock_guard guard(mutex_);
+        Pool& pool = pools_[key];
+        auto now = Clock::now();
+        evictExpired(pool, now);
+        sweepIfDue(now);
+        if (reusable && pool.idle.size() < options_.maxIdlePerHost)
+        {
+            pool.idle.push_back({std::move(stream), now});
+        }
+        else
+        {
+            --pool.open;
+        }
+    }
+    // Ждущие потоки могут ждать разных адресатов
+    released_.notify_all();
+    // Не попавшее в пул соединение закрывается здесь, вне блокировки
+}
+
+void HttpClient::evictExpired(Pool& pool, Clock::time_point now)
+{
+    // Соединения возвращаются в конец, поэтому самые старые - в начале
+    auto fresh = pool.idle.begin();
+    while (fresh != pool.idle.end() && now - fresh->since >= options_.idleTimeout)
+    {
+        ++fresh;
+    }
+    auto expired = static_cast<std::size_t>(fresh - pool.idle.begin());
+    pool.idle.erase(pool.idle.begin(), fresh);
+    pool.open -= expired;
+}
+
+void HttpClient::sweepIfDue(Clock::time_point now)
+{
+    // Записи пулов не удаляются: acquire держит ссылку на пул, отпустив мьютекс
+    if (now < nextSweep_)
+    {
+        return;
+    }
+    nextSweep_ = now + options_.idleTimeout;
+    for (auto& [key, pool] : pools_)
+    {
+        evictExpired(pool, now);
+    }
+}
+
+bool HttpClient::healthy(Stream& stream)
+{
+    // Простаивающее соединение должно молчать: EOF значит, что сервер его
+    // закрыл, а данные - что поток рассинхронизирован
+    auto& socket = stream.socket();
+    beast::error_code ec;
+    socket.non_blocking(true, ec);
+    if (ec)
+    {
+        return false;
+    }
+    char byte;
+    socket.receive(asio::buffer(&byte, 1), tcp::socket::message_peek, ec);
+    bool idle = ec == asio::error::would_block;
+    socket.non_blocking(false, ec);
+    return idle && !ec;
+}
+
+std::size_t HttpClient::idleConnections() const
+{
+    std::lock_guard guard(mutex_);
+    std::size_t count = 0;
+    for (const auto& [key, pool] : pools_)
+    {
+        count += pool.idle.size();
+    }
+    return count;
+}
+
+std::size_t HttpClient::openConnections() const
+{
+    std::lock_guard guard(mutex_);
+    std::size_t count = 0;
+    for (const auto& [key, pool] : pools_)
+    {
+        count += pool.open;
+    }
+    return count;
+}
+
+void HttpClient::closeIdle()
+{
+    std::lock_guard guard(mutex_);
+    for (auto& [key, pool] : pools_)
+    {
+        pool.open -= pool.idle.size();
+        pool.idle.clear();
+    }
+}
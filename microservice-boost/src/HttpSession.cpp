@@ -0,0 +1,351 @@
+#include "HttpSession.hpp"
+#include "Logger.hpp"
+#include <boost/asio/post.hpp>
+#include <sys/socket.h>
+#include <optional>
+
+/**
+ * @file HttpSession.cpp
+ * @brief Реализация асинхронной HTTP-сессии
+ * @author Anton Tobolkin
+ */
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+HttpSession::HttpSession(tcp::socket socket, Callbacks callbacks, Options options,
+                         AdmissionControl::Slot connectionSlot)
+    : socket_(std::move(socket)),
+      options_(options),
+      cycle_(std::move(callbacks), options_, RequestCycle::remoteIp(socket_)),
+      accepted_(std::chrono::steady_clock::now()),
+      connectionSlot_(std::move(connectionSlot))
+{
+}
+
+void HttpSession::run()
+{
+    // Закрытие и сроки обрабатываются на strand сессии. Сильную ссылку берём
+    // только там: последняя ссылка в обработчике, вызванном под блокировкой
+    // реестра или колеса таймеров, уничтожила бы сессию под этой блокировкой
+    if (options_.sessions)
+    {
+        registration_ = options_.sessions->add(
+            [weak = weak_from_this(), executor = socket_.get_executor()](bool force) {
+                asio::post(executor, [weak, force] {
+                    if (auto self = weak.lock())
+                    {
+                        self->closeForDrain(force);
+                    }
+                });
+            });
+    }
+
+    deadline_.setHandler([weak = weak_from_this(), executor = socket_.get_executor()] {
+        asio::post(executor, [weak] {
+            if (auto self = weak.lock())
+            {
+                self->onDeadline();
+            }
+        });
+    });
+
+    if (stopping())
+    {
+        doClose();
+        return;
+    }
+
+    doWait();
+}
+
+void HttpSession::doWait()
+{
+    // Pipelined-запрос уже в буфере - сразу читаем его
+    if (buffer_.size() > 0)
+    {
+        doReadHeader();
+        return;
+    }
+
+    // Новое соединение должно прислать запрос за headerTimeout,
+    // keep-alive соединение - не дольше idleTimeout простаивать
+    idle_ = true;
+    arm(cycle_.served() > 0 ? options_.idleTimeout : options_.headerTimeout);
+
+    socket_.async_wait(tcp::socket::wait_read,
+        [self = shared_from_this()](beast::error_code ec) {
+            self->idle_ = false;
+            // Ожидание могло завершиться, когда drain или срок уже закрыли
+            // сокет, а этот обработчик ждал очереди strand
+            if (ec || !self->socket_.is_open())
+            {
+                self->disarm();
+                return;
+            }
+            self->doReadHeader();
+        });
+}
+
+void HttpSession::doReadHeader()
+{
+    auto& headerParser = cycle_.startRequest(accepted_);
+    arm(options_.headerTimeout);
+
+    http::async_read_header(socket_, buffer_, headerParser,
+        [self = shared_from_this()](beast::error_code ec, std::size_t) {
+            self->onReadHeader(ec);
+        });
+}
+
+void HttpSession::onReadHeader(beast::error_code ec)
+{
+    if (ec)
+    {
+        onRead(ec);
+        return;
+    }
+
+    switch (cycle_.onHeader(buffer_))
+    {
+    case RequestCycle::Step::ReadBody:
+        arm(options_.bodyTimeout);
+        http::async_read(socket_, buffer_, cycle_.parser(),
+            [self = shared_from_this()](beast::error_code ec, std::size_t) {
+                self->onRead(ec);
+            });
+        return;
+    case RequestCycle::Step::Stream:
+        disarm();
+        onStream();
+        return;
+    case RequestCycle::Step::Reject:
+        disarm();
+        reject();
+        return;
+    case RequestCycle::Step::Handle:
+        onRead(ec);
+        return;
+    }
+}
+
+void HttpSession::onRead(beast::error_code ec)
+{
+    disarm();
+
+    if (ec == http::error::end_of_stream)
+    {
+        doClose();
+        return;
+    }
+
+    if (ec && ec != http::error::body_limit)
+    {
+        if (ec != asio::error::operation_aborted)
+        {
+            MS_LOG_WARN("[Session] Read error: ", ec.message());
+        }
+        return;
+    }
+
+    auto step = cycle_.onBody(ec);
+    if (step != RequestCycle::Step::Reject)
+    {
+        step = cycle_.admit(step, socket_, BeastResponseStream::Mode::Deferred);
+    }
+    if (step == RequestCycle::Step::Reject)
+    {
+        reject();
+        return;
+    }
+
+    runHandler(false);
+}
+
+void HttpSession::onStream()
+{
+    if (cycle_.admit(RequestCycle::Step::Stream, socket_, BeastResponseStream::Mode::Deferred) ==
+        RequestCycle::Step::Reject)
+    {
+        reject();
+        return;
+    }
+    runHandler(true);
+}
+
+void HttpSession::runHandler(bool stream)
+{
+    if (!cycle_.offloaded())
+    {
+        if (!(stream ? cycle_.handleStream(socket_, buffer_) : cycle_.handle()))
+        {
+            doClose();
+            return;
+        }
+        respond(cycle_.reply(stopping()));
+        return;
+    }
+
+    // Обработчик читает тело или пишет ответ синхронно: он выполняется в
+    // пуле blocking, а поток io_context тем временем обслуживает другие сессии
+    offloaded_ = true;
+    asio::post(*options_.blocking, [self = shared_from_this(), stream] {
+        std::optional<RequestCycle::Reply> reply;
+        if (stream ? self->cycle_.handleStream(self->socket_, self->buffer_) : self->cycle_.handle())
+        {
+            reply = self->cycle_.reply(self->stopping());
+        }
+        asio::post(self->socket_.get_executor(), [self, reply] {
+            self->offloaded_ = false;
+            if (!reply)
+            {
+                self->doClose();
+                return;
+            }
+            self->respond(*reply);
+        });
+    });
+}
+
+void HttpSession::respond(RequestCycle::Reply reply)
+{
+    if (reply == RequestCycle::Reply::Failed)
+    {
+        cycle_.completeRequest();
+        doClose();
+        return;
+    }
+
+    arm(options_.writeTimeout);
+    if (reply == RequestCycle::Reply::Message)
+    {
+        http::async_write(socket_, cycle_.response(),
+            [self = shared_from_this()](beast::error_code ec, std::size_t) {
+                self->onWrite(ec);
+            });
+        return;
+    }
+
+    // Обработчик писал порциями или отдал общий буфер или файл: собранное
+    // уходит асинхронной записью, файл - следом, всё под одним сроком
+    asio::async_write(socket_, cycle_.stream().output(),
+        [self = shared_from_this()](beast::error_code ec, std::size_t) {
+            self->sendFile(ec);
+        });
+}
+
+void HttpSession::sendFile(beast::error_code ec)
+{
+    if (!ec && cycle_.stream().filePending())
+    {
+        cycle_.stream().sendFileSome(ec);
+        if (ec == asio::error::would_block)
+        {
+            socket_.async_wait(tcp::socket::wait_write,
+                [self = shared_from_this()](beast::error_code ec) {
+                    self->sendFile(ec);
+                });
+            return;
+        }
+    }
+    onWrite(ec);
+}
+
+void HttpSession::onWrite(beast::error_code ec)
+{
+    disarm();
+    cycle_.completeRequest();
+
+    if (ec)
+    {
+        if (ec != asio::error::operation_aborted)
+        {
+            MS_LOG_WARN("[Session] Write error: ", ec.message());
+        }
+        return;
+    }
+
+    if (!cycle_.keepAlive() || stopping())
+    {
+        doClose();
+        return;
+    }
+
+    doWait();
+}
+
+void HttpSession::reject()
+{
+    auto response = cycle_.rejection();
+    arm(options_.writeTimeout);
+    asio::async_write(socket_, asio::buffer(response.data(), response.size()),
+        [self = shared_from_this()](beast::error_code, std::size_t) {
+            self->disarm();
+            self->cycle_.completeRequest();
+            self->doClose();
+        });
+}
+
+void HttpSession::doClose()
+{
+    beast::error_code ec;
+    socket_.shutdown(tcp::socket::shutdown_send, ec);
+}
+
+void HttpSession::closeForDrain(bool force)
+{
+    // Сокет читает поток пула blocking: закрытый дескриптор мог бы
+    // достаться другому соединению, поэтому только будим чтение
+    if (offloaded_)
+    {
+        if (force)
+        {
+            ::shutdown(socket_.native_handle(), SHUT_RDWR);
+        }
+        return;
+    }
+    if (force || idle_)
+    {
+        beast::error_code ec;
+        socket_.close(ec);
+    }
+}
+
+bool HttpSession::stopping() const
+{
+    return options_.running && !options_.running->load(std::memory_order_relaxed);
+}
+
+void HttpSession::arm(std::chrono::steady_clock::duration timeout)
+{
+    if (options_.deadlines)
+    {
+        auto now = std::chrono::steady_clock::now();
+        deadlineAt_ = now + timeout;
+        options_.deadlines->schedule(deadline_, timeout, now);
+    }
+}
+
+void HttpSession::disarm()
+{
+    if (options_.deadlines)
+    {
+        deadlineAt_ = std::chrono::steady_clock::time_point::max();
+        options_.deadlines->cancel(deadline_);
+    }
+}
+
+void HttpSession::onDeadline()
+{
+    // Срабатывание могло устареть, пока ждало очереди strand: операция
+    // успела завершиться и сессия перешла к следующему сроку
+    if (std::chrono::steady_clock::now() < deadlineAt_)
+    {
+        return;
+    }
+
+    beast::error_code ec;
+    socket_.close(ec);
+}
@@ -0,0 +1,251 @@
+#include "RequestCycle.hpp"
+#include "BeastBodyReader.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <limits>
+
+/**
+ * @file RequestCycle.cpp
+ * @brief Реализация шагов обработки запроса
+ * @author Anton Tobolkin
+ */
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+namespace
+{
+
+// Больше за одно чтение http::read не запрашивает
+constexpr std::uint64_t kBodyReadChunk = 64 * 1024;
+
+} // namespace
+
+RequestCycle::RequestCycle(Callbacks callbacks, const Options& options, std::string clientIp)
+    : callbacks_(std::move(callbacks)),
+      options_(options),
+      clientIp_(std::move(clientIp))
+{
+}
+
+std::string RequestCycle::remoteIp(const tcp::socket& socket)
+{
+    beast::error_code ec;
+    auto endpoint = socket.remote_endpoint(ec);
+    return ec ? std::string("0.0.0.0") : endpoint.address().to_string();
+}
+
+void RequestCycle::reserveBody(beast::flat_buffer& buffer, boost::optional<std::uint64_t> length,
+                               std::uint64_t limit)
+{
+    // Chunked-тело без длины читается той же порцией
+    std::uint64_t expected = std::min({length.value_or(kBodyReadChunk), limit, kBodyReadChunk});
+    std::size_t wanted = buffer.size() + static_cast<std::size_t>(expected);
+    if (wanted > buffer.capacity())
+    {
+        buffer.reserve(wanted);
+    }
+}
+
+RequestCycle::HeaderParser& RequestCycle::startRequest(std::chrono::steady_clock::time_point accepted)
+{
+    // Прошлый запрос полностью отправлен: всё, что было в арене, уничтожаем
+    // до её сброса
+    stream_.reset();
+    res_.reset();
+    parser_.reset();
+    streamParser_.reset();
+    streamHandler_.reset();
+    headerParser_.reset();
+    arena_.reset();
+
+    exchange_ = Exchange{};
+    exchange_.timing.mark(RequestTiming::Accepted, accepted);
+    exchange_.timing.mark(RequestTiming::ReadStarted);
+    rejection_ = {};
+    offloaded_ = false;
+
+    // Лимит тела проверяется по маршруту после заголовков
+    headerParser_.emplace(std::piecewise_construct, std::make_tuple(), std::make_tuple(arena_.allocator()));
+    headerParser_->body_limit(std::numeric_limits<std::uint64_t>::max());
+    return *headerParser_;
+}
+
+RequestCycle::Step RequestCycle::onHeader(beast::flat_buffer& buffer)
+{
+    exchange_.timing.mark(RequestTiming::HeaderRead);
+    // Нужны и отклонённому запросу, который не дойдёт до обработчика
+    auto method = headerParser_->get().method_string();
+    exchange_.method.assign(method.data(), method.size());
+    exchange_.ip = clientIp_;
+
+    MS_LOG_DEBUG("[Session] Received request: ", exchange_.method, " ", headerParser_->get().target());
+
+    BodyPlan plan = callbacks_.planBody ? callbacks_.planBody(*headerParser_)
+                                        : BodyPlan{options_.maxBodySize, nullptr};
+    bool stream = plan.stream && callbacks_.stream;
+    offloaded_ = options_.blocking && (stream || plan.streamsResponse);
+
+    // Заявленное тело больше лимита - отвечаем 413, не читая его
+    auto length = headerParser_->content_length();
+    if (length && *length > plan.limit)
+    {
+        rejection_ = options_.tooLargeResponse;
+        return Step::Reject;
+    }
+
+    if (stream)
+    {
+        streamParser_.emplace(std::move(*headerParser_));
+        streamParser_->body_limit(plan.limit);
+        streamHandler_ = std::move(plan.stream);
+        exchange_.timing.mark(RequestTiming::BodyRead);
+        return Step::Stream;
+    }
+
+    parser_.emplace(std::move(*headerParser_), arena_.allocator());
+    parser_->body_limit(plan.limit);
+    if (parser_->is_done())
+    {
+        return onBody({});
+    }
+    reserveBody(buffer, parser_->content_length(), plan.limit);
+    return Step::ReadBody;
+}
+
+RequestCycle::Step RequestCycle::onBody(beast::error_code ec)
+{
+    // Chunked-тело оказалось больше лимита
+    if (ec == http::error::body_limit)
+    {
+        rejection_ = options_.tooLargeResponse;
+        return Step::Reject;
+    }
+    exchange_.timing.mark(RequestTiming::BodyRead);
+    return Step::Handle;
+}
+
+RequestCycle::Step RequestCycle::admit(Step step, tcp::socket& socket, BeastResponseStream::Mode mode)
+{
+    ++served_;
+    bool limitReached = options_.maxRequests > 0 && served_ >= options_.maxRequests;
+
+    // Слишком много запросов в обработке - 503 без маршрутизации
+    if (options_.admission && !(requestSlot_ = options_.admission->tryAcquireRequest()))
+    {
+        rejection_ = options_.overloadResponse;
+        return Step::Reject;
+    }
+
+    unsigned version = streamParser_ ? streamParser_->get().version() : parser_->get().version();
+    bool keepAlive = streamParser_ ? streamParser_->get().keep_alive() : parser_->get().keep_alive();
+    res_.emplace(makeArenaResponse(arena_, version));
+    res_->set(http::field::server, "BoostBeast");
+    res_->keep_alive(keepAlive && !limitReached);
+    stream_.emplace(socket, *res_, options_.deadlines, options_.writeTimeout,
+                    offloaded_ ? BeastResponseStream::Mode::Blocking : mode);
+    return step;
+}
+
+std::string_view RequestCycle::rejection()
+{
+    // "HTTP/1.1 503 ...": статус - три цифры после версии
+    constexpr std::size_t statusAt = sizeof("HTTP/1.1 ") - 1;
+    exchange_.status = 0;
+    for (std::size_t i = statusAt; i < statusAt + 3 && i < rejection_.size(); ++i)
+    {
+        exchange_.status = exchange_.status * 10 + (rejection_[i] - '0');
+    }
+    auto headerEnd = rejection_.find("\r\n\r\n");
+    exchange_.bytesOut = headerEnd == std::string_view::npos ? 0 : rejection_.size() - headerEnd - 4;
+    exchange_.bytesIn = 0;
+    return rejection_;
+}
+
+bool RequestCycle::handle()
+{
+    try
+    {
+        callbacks_.request(parser_->get(), *res_, clientIp_, *stream_, exchange_);
+    }
+    catch (const std::exception& e)
+    {
+        MS_LOG_ERROR("[Session] Unexpected error: ", e.what());
+        return false;
+    }
+    return true;
+}
+
+bool RequestCycle::handleStream(tcp::socket& socket, beast::flat_buffer& buffer)
+{
+    BeastBodyReader body(socket, buffer, *streamParser_, options_.deadlines, options_.bodyTimeout);
+    try
+    {
+        callbacks_.stream(*streamHandler_, streamParser_->get(), body, *res_, clientIp_, *stream_, exchange_);
+    }
+    catch (const beast::system_error& e)
+    {
+        if (e.code() != http::error::end_of_stream && e.code() != asio::error::operation_aborted)
+        {
+            MS_LOG_WARN("[Session] Read error: ", e.what());
+        }
+        return false;
+    }
+    catch (const std::exception& e)
+    {
+        MS_LOG_ERROR("[Session] Unexpected error: ", e.what());
+        return false;
+    }
+
+    // Недочитанное тело не даёт разобрать следующий запрос
+    if (!streamParser_->is_done())
+    {
+        res_->keep_alive(false);
+    }
+    return true;
+}
+
+RequestCycle::Reply RequestCycle::reply(bool stopping)
+{
+    requestSlot_.reset();
+    if (stopping)
+    {
+        res_->keep_alive(false);
+    }
+
+    if (!stream_->started())
+    {
+        res_->prepare_payload();
+        return Reply::Message;
+    }
+
+    // Обработчик писал порциями или отдал общий буфер или файл: в режиме
+    // Blocking finish() отправляет остаток сам, в Deferred - собирает его в output()
+    try
+    {
+        stream_->finish();
+    }
+    catch (const std::exception& e)
+    {
+        MS_LOG_WARN("[Session] Write error: ", e.what());
+        return Reply::Failed;
+    }
+    return stream_->failed() ? Reply::Failed : Reply::Stream;
+}
+
+void RequestCycle::completeRequest()
+{
+    exchange_.timing.mark(RequestTiming::Written);
+    if (callbacks_.complete)
+    {
+        callbacks_.complete(exchange_);
+    }
+}
+
+bool RequestCycle::keepAlive() const
+{
+    // Handler мог сам выставить "Connection: close"
+    return res_ && res_->keep_alive();
+}
@@ -0,0 +1,241 @@
+#include "StaticFileHandler.hpp"
+#include "IRequest.hpp"
+#include "IResponse.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <map>
+
+/**
+ * @file StaticFileHandler.cpp
+ * @brief Реализация обработчика раздачи файлов
+ * @author Anton Tobolkin
+ */
+
+namespace
+{
+
+/**
+ * @brief Дата в формате HTTP (RFC 7231, IMF-fixdate)
+ */
+std::string httpDate(std::time_t time)
+{
+    std::tm tm{};
+    ::gmtime_r(&time, &tm);
+    char buffer[64];
+    std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    return buffer;
+}
+
+/**
+ * @brief ETag из времени изменения и размера файла, как у nginx
+ */
+std::string makeEtag(const struct stat& info)
+{
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "\"%llx-%llx\"",
+                  static_cast<unsigned long long>(info.st_mtim.tv_sec),
+                  static_cast<unsigned long long>(info.st_size));
+    return buffer;
+}
+
+bool etagMatches(std::string_view ifNoneMatch, std::string_view etag)
+{
+    if (ifNoneMatch == "*")
+    {
+        return true;
+    }
+
+    // Список через запятую, сравнение слабое (W/ игнорируется)
+    std::size_t start = 0;
+    while (start < ifNoneMatch.size())
+    {
+        std::size_t end = ifNoneMatch.find(',', start);
+        if (end == std::string_view::npos)
+        {
+            end = ifNoneMatch.size();
+        }
+        std::string_view tag = ifNoneMatch.substr(start, end - start);
+        tag.remove_prefix(std::min(tag.size(), tag.find_first_not_of(" \t")));
+        tag = tag.substr(0, tag.find_last_not_of(" \t") + 1);
+        if (tag.substr(0, 2) == "W/")
+        {
+            tag.remove_prefix(2);
+        }
+        if (tag == etag)
+        {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+int hexDigit(char ch)
+{
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief Percent-декодирование пути URL ('+' в пути - сам символ, не пробел)
+ * @return false, если %XX неверный
+ */
+bool decodePath(std::string_view encoded, std::string& path)
+{
+    path.reserve(encoded.size());
+    for (std::size_t i = 0; i < encoded.size(); ++i)
+    {
+        if (encoded[i] != '%')
+        {
+            path += encoded[i];
+            continue;
+        }
+        if (i + 2 >= encoded.size())
+        {
+            return false;
+        }
+        int high = hexDigit(encoded[i + 1]);
+        int low = hexDigit(encoded[i + 2]);
+        if (high < 0 || low < 0)
+        {
+            return false;
+        }
+        path += static_cast<char>(high * 16 + low);
+        i += 2;
+    }
+    return true;
+}
+
+} // namespace
+
+StaticFileHandler::StaticFileHandler(std::string prefix, std::string root, std::size_t cacheSize)
+    : prefix_(std::move(prefix)), root_(std::move(root)), files_(cacheSize)
+{
+    while (!prefix_.empty() && prefix_.back() == '/')
+    {
+        prefix_.pop_back();
+    }
+    while (root_.size() > 1 && root_.back() == '/')
+    {
+        root_.pop_back();
+    }
+}
+
+void StaticFileHandler::handle(IRequest& req, IResponse& res)
+{
+    std::string path = resolve(req.path());
+    auto file = path.empty() ? nullptr : files_.open(path);
+    if (!file)
+    {
+        res.setStatus(404);
+        res.setHeader("Content-Type", "application/json");
+        res.setBody(R"({"error": "Not found"})");
+        return;
+    }
+
+    std::string etag = makeEtag(file->info);
+    std::string lastModified = httpDate(file->info.st_mtim.tv_sec);
+    res.setHeader("ETag", etag);
+    res.setHeader("Last-Modified", lastModified);
+
+    // If-Modified-Since учитывается, только если нет If-None-Match (RFC 7232)
+    std::string_view ifNoneMatch = req.header(HttpField::IfNoneMatch);
+    bool notModified = !ifNoneMatch.empty() ? etagMatches(ifNoneMatch, etag)
+                                            : req.header(HttpField::IfModifiedSince) == lastModified;
+    if (notModified)
+    {
+        res.setStatus(304);
+        return;
+    }
+
+    res.setStatus(200);
+    res.setHeader("Content-Type", contentType(path));
+    res.setFileBody(std::shared_ptr<const int>(file, &file->fd), file->size());
+}
+
+std::string StaticFileHandler::resolve(std::string_view encodedPath) const
+{
+    // Проверки ниже - над декодированным путём, иначе %2e%2e обошёл бы запрет ".."
+    std::string urlPath;
+    if (!decodePath(encodedPath, urlPath))
+    {
+        return {};
+    }
+    if (urlPath.compare(0, prefix_.size(), prefix_) != 0)
+    {
+        return {};
+    }
+
+    std::string relative = urlPath.substr(prefix_.size());
+    if (!relative.empty() && relative.front() != '/')
+    {
+        return {};
+    }
+
+    // Выход за пределы root через ".." недопустим
+    std::size_t start = 0;
+    while (start <= relative.size())
+    {
+        std::size_t end = relative.find('/', start);
+        if (end == std::string::npos)
+        {
+            end = relative.size();
+        }
+        if (relative.compare(start, end - start, "..") == 0)
+        {
+            return {};
+        }
+        start = end + 1;
+    }
+    if (relative.find('\0') != std::string::npos)
+    {
+        return {};
+    }
+
+    if (relative.empty() || relative.back() == '/')
+    {
+        relative += relative.empty() ? "/index.html" : "index.html";
+    }
+    return root_ + relative;
+}
+
+std::string StaticFileHandler::contentType(const std::string& path)
+{
+    static const std::map<std::string, std::string> types = {
+        {"css", "text/css; charset=utf-8"},
+        {"gif", "image/gif"},
+        {"htm", "text/html; charset=utf-8"},
+        {"html", "text/html; charset=utf-8"},
+        {"ico", "image/x-icon"},
+        {"jpeg", "image/jpeg"},
+        {"jpg", "image/jpeg"},
+        {"js", "application/javascript"},
+        {"json", "application/json"},
+        {"pdf", "application/pdf"},
+        {"png", "image/png"},
+        {"svg", "image/svg+xml"},
+        {"txt", "text/plain; charset=utf-8"},
+        {"wasm", "application/wasm"},
+        {"webp", "image/webp"},
+        {"woff", "font/woff"},
+        {"woff2", "font/woff2"},
+        {"xml", "application/xml"},
+    };
+
+    auto slash = path.rfind('/');
+    auto dot = path.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    {
+        return "application/octet-stream";
+    }
+
+    std::string ext = path.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    auto it = types.find(ext);
+    return it != types.end() ? it->second : "application/octet-stream";
+}
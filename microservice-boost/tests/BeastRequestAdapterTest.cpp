@@ -40,6 +40,64 @@ TEST(BeastRequestAdapterTest, GetMethod)
     EXPECT_EQ(adapter.getMethod(), "POST");
 }
 
+// Тест: метод без копирования строки, нестандартный - Other
+TEST(BeastRequestAdapterTest, MethodWithoutCopy)
+{
+    namespace http = boost::beast::http;
+
+    ArenaRequest del{http::verb::delete_, "/items/1", 11};
+    BeastRequestAdapter deleteAdapter(del, "127.0.0.1");
+    EXPECT_EQ(deleteAdapter.method(), HttpMethod::Delete);
+    EXPECT_EQ(deleteAdapter.methodName(), "DELETE");
+
+    ArenaRequest propfind{http::verb::propfind, "/dav", 11};
+    BeastRequestAdapter propfindAdapter(propfind, "127.0.0.1");
+    EXPECT_EQ(propfindAdapter.method(), HttpMethod::Other);
+    EXPECT_EQ(propfindAdapter.methodName(), "PROPFIND");
+}
+
+// Тест: view-методы указывают в сам запрос, без копирования
+TEST(BeastRequestAdapterTest, ViewAccessors)
+{
+    namespace http = boost::beast::http;
+
+    ArenaRequest req{http::verb::post, "/api/users?id=10", 11};
+    req.set(http::field::content_type, "application/json");
+    req.body() = R"({"name": "John"})";
+    BeastRequestAdapter adapter(req, "127.0.0.1");
+
+    EXPECT_EQ(adapter.path(), "/api/users");
+    EXPECT_EQ(adapter.path().data(), req.target().data());
+    EXPECT_EQ(adapter.body(), R"({"name": "John"})");
+    EXPECT_EQ(adapter.body().data(), req.body().data());
+    EXPECT_EQ(adapter.header("content-type"), "application/json");
+    EXPECT_EQ(adapter.header("X-Missing"), "");
+
+    BeastRequestAdapter headerOnly(static_cast<const ArenaRequestHeader&>(req), "127.0.0.1");
+    EXPECT_EQ(headerOnly.body(), "");
+}
+
+// Тест: заголовок по полю без копирования, имя без учёта регистра
+TEST(BeastRequestAdapterTest, HeaderByField)
+{
+    namespace http = boost::beast::http;
+
+    ArenaRequest req{http::verb::get, "/api/users", 11};
+    req.set(http::field::authorization, "Bearer token");
+    req.set("x-request-id", "req-42");
+    req.set("traceparent", "00-abc-def-01");
+    BeastRequestAdapter adapter(req, "127.0.0.1");
+    const IRequest& request = adapter;
+
+    EXPECT_EQ(adapter.header(http::field::authorization), "Bearer token");
+    EXPECT_EQ(adapter.header(http::field::authorization).data(), req[http::field::authorization].data());
+    EXPECT_EQ(adapter.header(http::field::cookie), "");
+    EXPECT_EQ(adapter.header(HttpField::Authorization), "Bearer token");
+    EXPECT_EQ(request.header(HttpField::XRequestId), "req-42");
+    EXPECT_EQ(request.header(HttpField::Traceparent), "00-abc-def-01");
+    EXPECT_EQ(request.header(HttpField::Origin), "");
+}
+
 // Тест: тело запроса
 TEST(BeastRequestAdapterTest, GetBody)
 {
@@ -81,6 +139,54 @@ TEST(BeastRequestAdapterTest, GetParamsEmpty)
     EXPECT_TRUE(params.empty());
 }
 
+// Тест: percent-декодирование, ключи без '=' и повторы в query()
+TEST(BeastRequestAdapterTest, QueryDecoded)
+{
+    namespace http = boost::beast::http;
+
+    ArenaRequest req{http::verb::get, "/search?flag&q=a+b%26c&q=second&x=1", 11};
+    BeastRequestAdapter adapter(req, "127.0.0.1");
+
+    EXPECT_EQ(adapter.param("flag"), "");
+    EXPECT_EQ(adapter.param("q"), "a b&c");
+    EXPECT_EQ(adapter.param("x"), "1");
+    auto all = adapter.query().getAll("q");
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_EQ(all[1], "second");
+}
+
+// Тест: getParams() - значения как есть, при повторе ключа последнее
+TEST(BeastRequestAdapterTest, GetParamsRawLastWins)
+{
+    namespace http = boost::beast::http;
+
+    ArenaRequest req{http::verb::get, "/search?q=a+b%26c&q=second&x=1", 11};
+    BeastRequestAdapter adapter(req, "127.0.0.1");
+
+    auto params = adapter.getParams();
+    ASSERT_EQ(params.size(), 2u);
+    EXPECT_EQ(params["q"], "second");
+    EXPECT_EQ(params["x"], "1");
+
+    ArenaRequest encoded{http::verb::get, "/search?name=J%C3%B6rg+M", 11};
+    EXPECT_EQ(BeastRequestAdapter(encoded, "127.0.0.1").getParams()["name"], "J%C3%B6rg+M");
+}
+
+// Тест: один параметр без построения map
+TEST(BeastRequestAdapterTest, SingleParam)
+{
+    namespace http = boost::beast::http;
+
+    ArenaRequest req{http::verb::get, "/search?q=test&tag=a&tag=b", 11};
+    BeastRequestAdapter adapter(req, "127.0.0.1");
+    const IRequest& request = adapter;
+
+    EXPECT_EQ(request.param("q"), "test");
+    EXPECT_EQ(request.param("tag"), "a");
+    EXPECT_FALSE(request.param("page").has_value());
+    EXPECT_EQ(adapter.query().getAll("tag").size(), 2u);
+}
+
 // Тест: получение заголовков
 TEST(BeastRequestAdapterTest, GetHeaders)
 {
@@ -119,3 +225,22 @@ TEST(BeastRequestAdapterTest, GetPort)
 
     EXPECT_EQ(adapter.getPort(), 80);
 }
+
+// Тест: обычный запрос Beast без арены - те же view-методы, arena() - куча
+TEST(BeastRequestAdapterTest, PlainRequestViews)
+{
+    namespace http = boost::beast::http;
+
+    http::request<http::string_body> req{http::verb::put, "/items/7?force=1", 11};
+    req.set(http::field::content_type, "text/plain");
+    req.body() = "payload";
+    BeastRequestAdapter adapter(req, "127.0.0.1");
+
+    EXPECT_EQ(adapter.path(), "/items/7");
+    EXPECT_EQ(adapter.path().data(), req.target().data());
+    EXPECT_EQ(adapter.body().data(), req.body().data());
+    EXPECT_EQ(adapter.method(), HttpMethod::Put);
+    EXPECT_EQ(adapter.header(http::field::content_type), "text/plain");
+    EXPECT_EQ(adapter.param("force"), "1");
+    EXPECT_EQ(adapter.arena(), std::pmr::get_default_resource());
+}
@@ -1,6 +1,13 @@
 #include <gtest/gtest.h>
+#include <boost/asio.hpp>
 #include <boost/beast/http.hpp>
 #include "BeastResponseAdapter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <unistd.h>
 
 /**
  * @file BeastResponseAdapterTest.cpp
@@ -64,3 +71,221 @@ TEST(BeastResponseAdapterTest, Combined)
     EXPECT_EQ(res["Server"], "MyServer");
     EXPECT_EQ(res.body(), "OK");
 }
+
+// Тест: без потока соединения порции копятся в теле ответа
+TEST(BeastResponseAdapterTest, WriteWithoutStreamAppendsToBody)
+{
+    namespace http = boost::beast::http;
+
+    ArenaResponse res;
+    BeastResponseAdapter adapter(res);
+
+    adapter.write("chunk1 ");
+    adapter.write("chunk2");
+    adapter.end();
+
+    EXPECT_EQ(res.body(), "chunk1 chunk2");
+}
+
+// Тест: тело переносится в ответ без копирования
+TEST(BeastResponseAdapterTest, MoveBody)
+{
+    namespace http = boost::beast::http;
+
+    ArenaResponse res;
+    BeastResponseAdapter adapter(res);
+
+    std::string body(4096, 'x');
+    const char* data = body.data();
+    adapter.setBody(std::move(body));
+
+    EXPECT_EQ(res.body().size(), 4096u);
+    EXPECT_EQ(res.body().data(), data);
+}
+
+// Тест: дописывание в зарезервированное тело
+TEST(BeastResponseAdapterTest, AppendBody)
+{
+    namespace http = boost::beast::http;
+
+    ArenaResponse res;
+    BeastResponseAdapter adapter(res);
+
+    adapter.reserveBody(1024);
+    const char* data = res.body().data();
+    adapter.appendBody("[");
+    adapter.appendBody("1,2");
+    adapter.appendBody("]");
+
+    EXPECT_EQ(res.body(), "[1,2]");
+    EXPECT_GE(res.body().capacity(), 1024u);
+    EXPECT_EQ(res.body().data(), data);
+}
+
+// Тест: без потока соединения общий буфер копируется в тело
+TEST(BeastResponseAdapterTest, SharedBodyWithoutStream)
+{
+    namespace http = boost::beast::http;
+
+    ArenaResponse res;
+    BeastResponseAdapter adapter(res);
+
+    auto shared = std::make_shared<const std::string>("cached");
+    adapter.setSharedBody(shared);
+
+    EXPECT_EQ(res.body(), "cached");
+}
+
+// Тест: nullptr в setSharedBody очищает тело
+TEST(BeastResponseAdapterTest, NullSharedBodyClears)
+{
+    ArenaResponse res;
+    BeastResponseAdapter adapter(res);
+
+    adapter.setBody("old");
+    adapter.setSharedBody(nullptr);
+
+    EXPECT_EQ(res.body(), "");
+}
+
+namespace
+{
+
+// Соединение через loopback: ответ пишется в server, читается из client
+struct Loopback
+{
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::socket server{ioc};
+    boost::asio::ip::tcp::socket client{ioc};
+
+    Loopback()
+    {
+        using tcp = boost::asio::ip::tcp;
+        tcp::acceptor acceptor(ioc, {boost::asio::ip::make_address("127.0.0.1"), 0});
+        client.connect(acceptor.local_endpoint());
+        acceptor.accept(server);
+    }
+
+    std::string send(const std::function<void(BeastResponseAdapter&)>& fill)
+    {
+        namespace http = boost::beast::http;
+
+        RequestArena arena;
+        ArenaResponse res = makeArenaResponse(arena, 11);
+        BeastResponseStream stream(server, res, nullptr, std::chrono::seconds(1));
+        BeastResponseAdapter adapter(res, &stream);
+        fill(adapter);
+        if (stream.started())
+        {
+            stream.finish();
+        }
+        else
+        {
+            res.prepare_payload();
+            http::write(server, res);
+        }
+
+        boost::beast::flat_buffer buffer;
+        http::response<http::string_body> received;
+        http::read(client, buffer, received);
+        return received.body();
+    }
+};
+
+// Временный файл с содержимым, дескриптор закрывается последней ссылкой
+std::shared_ptr<const int> fileWith(const std::string& content)
+{
+    std::FILE* file = std::tmpfile();
+    std::fputs(content.c_str(), file);
+    std::fflush(file);
+    int fd = ::dup(fileno(file));
+    std::fclose(file);
+    return std::shared_ptr<const int>(new int(fd), [](const int* p) {
+        ::close(*p);
+        delete p;
+    });
+}
+
+} // namespace
+
+// Тест: каждый setter тела отменяет ранее заданные общий буфер и файл
+TEST(BeastResponseAdapterTest, BodySettersReplaceSharedAndFileBodies)
+{
+    Loopback loopback;
+    auto shared = std::make_shared<const std::string>("shared");
+
+    EXPECT_EQ(loopback.send([&](BeastResponseAdapter& res) {
+        res.setSharedBody(shared);
+        res.setBody("plain");
+    }), "plain");
+
+    EXPECT_EQ(loopback.send([&](BeastResponseAdapter& res) {
+        res.setFileBody(fileWith("from file"), 9);
+        res.setBody("plain");
+    }), "plain");
+
+    EXPECT_EQ(loopback.send([&](BeastResponseAdapter& res) {
+        res.setSharedBody(shared);
+        res.reserveBody(16);
+        res.appendBody("appended");
+    }), "appended");
+
+    EXPECT_EQ(loopback.send([&](BeastResponseAdapter& res) {
+        res.setFileBody(fileWith("from file"), 9);
+        res.write("chunk");
+    }), "chunk");
+
+    EXPECT_EQ(loopback.send([&](BeastResponseAdapter& res) {
+        res.setSharedBody(shared);
+        res.setFileBody(fileWith("from file"), 9);
+    }), "from file");
+
+    EXPECT_EQ(loopback.send([&](BeastResponseAdapter& res) {
+        res.setFileBody(fileWith("from file"), 9);
+        res.setSharedBody(shared);
+    }), "shared");
+
+    EXPECT_EQ(loopback.send([&](BeastResponseAdapter& res) {
+        res.setSharedBody(shared);
+        res.setSharedBody(nullptr);
+    }), "");
+}
+
+// Тест: клиент не читает большой потоковый ответ - в режиме Deferred
+// неотправленное не растёт больше maxPending, write() ждёт клиента
+TEST(BeastResponseAdapterTest, DeferredStreamWaitsForSlowReader)
+{
+    namespace http = boost::beast::http;
+
+    Loopback loopback;
+    const std::size_t chunkSize = 64 * 1024;
+    const std::size_t chunks = 256;
+
+    std::size_t received = 0;
+    std::thread reader([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        boost::beast::flat_buffer buffer;
+        http::response_parser<http::string_body> parser;
+        parser.body_limit(boost::none);
+        http::read(loopback.client, buffer, parser);
+        received = parser.get().body().size();
+    });
+
+    RequestArena arena;
+    ArenaResponse res = makeArenaResponse(arena, 11);
+    BeastResponseStream stream(loopback.server, res, nullptr, std::chrono::seconds(5),
+                               BeastResponseStream::Mode::Deferred);
+    const std::string chunk(chunkSize, 'd');
+    std::size_t maxUnsent = 0;
+    for (std::size_t i = 0; i < chunks; ++i)
+    {
+        stream.write(chunk);
+        maxUnsent = std::max(maxUnsent, boost::asio::buffer_size(stream.output()));
+    }
+    stream.finish();
+    boost::asio::write(loopback.server, stream.output());
+    reader.join();
+
+    EXPECT_LE(maxUnsent, BeastResponseStream::maxPending);
+    EXPECT_EQ(received, chunks * chunkSize);
+}
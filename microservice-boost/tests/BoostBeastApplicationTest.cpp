@@ -0,0 +1,1486 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+
+#include "BoostBeastApplication.hpp"
+#include "Environment.hpp"
+#include "HttpClient.hpp"
+#include "IStreamingHttpHandler.hpp"
+#include "SimpleRequest.hpp"
+#include "SimpleResponse.hpp"
+#include "StaticFileHandler.hpp"
+#ifdef MICROSERVICE_COROUTINES
+#include "IAsyncHttpHandler.hpp"
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#endif
+
+/**
+ * @file BoostBeastApplicationTest.cpp
+ * @brief Интеграционные тесты BoostBeastApplication на loopback
+ */
+
+namespace
+{
+
+class EchoHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest& req, IResponse& res) override
+    {
+        res.setStatus(200);
+        res.setHeader("Content-Type", "text/plain");
+        res.setBody(req.getMethod() + " " + req.getPath());
+    }
+};
+
+// Отвечает захваченными сегментами пути
+class OrderHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest& req, IResponse& res) override
+    {
+        res.setStatus(200);
+        res.setBody("user=" + std::to_string(*req.getPathParams().getInt("id")) +
+                    " order=" + std::string(req.getPathParam("orderId")));
+    }
+};
+
+// Обработчик, который проверяет отметки времени, видимые ему
+class TimingHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest& req, IResponse& res) override
+    {
+        const RequestTiming* timing = req.timing();
+        bool ordered = timing && timing->has(RequestTiming::Routed) &&
+                       timing->marks[RequestTiming::Accepted] <= timing->marks[RequestTiming::ReadStarted] &&
+                       timing->marks[RequestTiming::ReadStarted] <= timing->marks[RequestTiming::HeaderRead] &&
+                       timing->marks[RequestTiming::HeaderRead] <= timing->marks[RequestTiming::BodyRead] &&
+                       timing->marks[RequestTiming::BodyRead] <= timing->marks[RequestTiming::Routed] &&
+                       !timing->has(RequestTiming::Handled);
+        res.setStatus(200);
+        res.setBody(ordered ? "ordered" : "unordered");
+    }
+};
+
+// Получатель отметок: запоминает запросы для проверки в тесте
+class RecordingExporter : public IRequestTimingExporter
+{
+public:
+    struct Entry
+    {
+        RequestTiming timing;
+        std::string method;
+        std::string route;
+        int status;
+    };
+
+    void exportTiming(const RequestTiming& timing, std::string_view method,
+                      std::string_view route, int status) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.push_back(Entry{timing, std::string(method), std::string(route), status});
+    }
+
+    std::mutex mutex;
+    std::vector<Entry> entries;
+};
+
+// Обработчик, который держит запрос "в обработке", пока тест не откроет gate
+class GateHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest&, IResponse& res) override
+    {
+        entered.set_value();
+        opened.wait();
+        res.setStatus(200);
+        res.setBody("released");
+    }
+
+    std::promise<void> entered;
+    std::shared_future<void> opened;
+};
+
+// Возвращает тело запроса (буферизованный маршрут)
+class BodyHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest& req, IResponse& res) override
+    {
+        res.setStatus(200);
+        res.setBody(req.getBody());
+    }
+};
+
+// Читает тело порциями и отвечает его размером
+class UploadHandler : public IStreamingHttpHandler
+{
+public:
+    std::uint64_t maxBodySize() const override
+    {
+        return 1024 * 1024;
+    }
+
+    void handleStream(IRequest&, IBodyReader& body, IResponse& res) override
+    {
+        char chunk[4096];
+        std::size_t total = 0;
+        while (std::size_t n = body.read(chunk, sizeof(chunk)))
+        {
+            total += n;
+        }
+        res.setStatus(200);
+        res.setBody(std::to_string(total));
+    }
+};
+
+// Отдаёт ответ порциями: первая уходит до того, как тест откроет gate
+class ExportHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest&, IResponse& res) override
+    {
+        res.setStatus(200);
+        res.setHeader("Content-Type", "text/plain");
+        res.write("first;");
+        proceed.wait();
+        for (int i = 0; i < 100; ++i)
+        {
+            res.write(std::string(1024, 'e'));
+        }
+    }
+
+    std::shared_future<void> proceed;
+};
+
+// Отдаёт большой ответ порциями, больше буферов сокетов; в асинхронных
+// режимах выполняется в пуле blocking
+class BulkHandler : public IHttpHandler
+{
+public:
+    static constexpr std::size_t kChunks = 256;
+    static constexpr std::size_t kChunkSize = 64 * 1024;
+
+    void handle(IRequest&, IResponse& res) override
+    {
+        res.setStatus(200);
+        const std::string chunk(kChunkSize, 'b');
+        for (std::size_t i = 0; i < kChunks; ++i)
+        {
+            res.write(chunk);
+        }
+    }
+
+    bool streamsResponse() const override
+    {
+        return true;
+    }
+};
+
+// Отдаёт один общий буфер всем запросам
+class SharedBodyHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest&, IResponse& res) override
+    {
+        res.setStatus(200);
+        res.setSharedBody(body);
+    }
+
+    std::shared_ptr<const std::string> body = std::make_shared<const std::string>(200 * 1024, 's');
+};
+
+// Строит тело дописыванием в зарезервированный буфер ответа
+class ReportHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest&, IResponse& res) override
+    {
+        res.setStatus(200);
+        res.reserveBody(1000 * 6);
+        for (int i = 0; i < 1000; ++i)
+        {
+            res.appendBody("line;\n");
+        }
+    }
+};
+
+#ifdef MICROSERVICE_COROUTINES
+// Обработчик, который ждёт таймер через co_await, не блокируя поток
+class DelayedHandler : public IAsyncHttpHandler
+{
+public:
+    boost::asio::awaitable<void> handleAsync(IRequest& req, IResponse& res) override
+    {
+        boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+        timer.expires_after(std::chrono::milliseconds(10));
+        co_await timer.async_wait(boost::asio::use_awaitable);
+
+        res.setStatus(200);
+        res.setBody("delayed " + req.getPath());
+    }
+};
+#endif
+
+void health(IRequest&, IResponse& res)
+{
+    res.setStatus(200);
+    res.setBody("healthy");
+}
+
+constexpr auto kStaticRoutes = makeStaticRoutes({
+    route("GET", "/health", &health),
+});
+
+class TestApplication : public BoostBeastApplication
+{
+public:
+    explicit TestApplication(std::shared_ptr<IEnvironment> env)
+    {
+        env_ = std::move(env);
+        gate = std::make_shared<GateHandler>();
+        exporter = std::make_shared<ExportHandler>();
+        shared = std::make_shared<SharedBodyHandler>();
+        setStaticRoutes(kStaticRoutes.view());
+    }
+
+    std::shared_ptr<GateHandler> gate;
+    std::shared_ptr<ExportHandler> exporter;
+    std::shared_ptr<SharedBodyHandler> shared;
+
+    using BoostBeastApplication::setTimingExporter;
+
+    void serveStatic(const std::string& root)
+    {
+        handlers_[getHandlerKey("GET", "/static/*")] = std::make_shared<StaticFileHandler>("/static", root);
+    }
+
+    void configureInjection() override
+    {
+        handlers_[getHandlerKey("GET", "/echo")] = std::make_shared<EchoHandler>();
+        handlers_[getHandlerKey("GET", "/items/*")] = std::make_shared<EchoHandler>();
+        handlers_[getHandlerKey("GET", "/users/{id:int}/orders/{orderId}")] = std::make_shared<OrderHandler>();
+        handlers_[getHandlerKey("GET", "/gate")] = gate;
+        handlers_[getHandlerKey("POST", "/body")] = std::make_shared<BodyHandler>();
+        handlers_[getHandlerKey("POST", "/upload")] = std::make_shared<UploadHandler>();
+        handlers_[getHandlerKey("GET", "/export")] = exporter;
+        handlers_[getHandlerKey("GET", "/bulk")] = std::make_shared<BulkHandler>();
+        handlers_[getHandlerKey("GET", "/shared")] = shared;
+        handlers_[getHandlerKey("GET", "/report")] = std::make_shared<ReportHandler>();
+        handlers_[getHandlerKey("GET", "/timing/{step}")] = std::make_shared<TimingHandler>();
+#ifdef MICROSERVICE_COROUTINES
+        handlers_[getHandlerKey("GET", "/delayed")] = std::make_shared<DelayedHandler>();
+#endif
+    }
+};
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+std::shared_ptr<Environment> makeEnv(int port, const std::string& mode, int threads)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", port);
+    env->setProperty("server.mode", mode);
+    env->setProperty("server.threads", threads);
+    return env;
+}
+
+// Ждём, пока сервер начнёт отвечать
+bool waitForServer(int port)
+{
+    HttpClient client;
+    for (int attempt = 0; attempt < 200; ++attempt)
+    {
+        SimpleRequest request("GET", "/echo", "", "127.0.0.1", port);
+        SimpleResponse response;
+        if (client.send(request, response) && response.getStatus() == 200)
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+// Отправить запрос по уже открытому соединению и прочитать ответ
+http::response<http::string_body> roundTrip(tcp::socket& socket, beast::flat_buffer& buffer,
+                                            const std::string& target, bool keepAlive = true)
+{
+    http::request<http::string_body> req{http::verb::get, target, 11};
+    req.set(http::field::host, "127.0.0.1");
+    req.keep_alive(keepAlive);
+    http::write(socket, req);
+
+    http::response<http::string_body> res;
+    http::read(socket, buffer, res);
+    return res;
+}
+
+// Сервер закрыл соединение: следующее чтение возвращает EOF
+bool peerClosed(tcp::socket& socket, beast::flat_buffer& buffer)
+{
+    http::response<http::string_body> res;
+    beast::error_code ec;
+    http::read(socket, buffer, res, ec);
+    return ec == http::error::end_of_stream || ec == asio::error::eof ||
+           ec == asio::error::connection_reset;
+}
+
+// Уникальный порт для пары (тест, режим), чтобы тесты не мешали друг другу
+int portFor(int base, const std::string& mode)
+{
+    if (mode == "pool")
+        return base + 1;
+    if (mode == "reuseport")
+        return base + 2;
+    if (mode == "coroutine")
+        return base + 3;
+    return base;
+}
+
+class KeepAliveTest : public ::testing::TestWithParam<std::string>
+{
+};
+
+class ServerModeTest : public ::testing::TestWithParam<std::string>
+{
+};
+
+// В режиме reuseport лимиты делятся между шардами, поэтому для точной
+// проверки лимита 1 используем один шард
+class OverloadTest : public ::testing::TestWithParam<std::string>
+{
+protected:
+    int threads() const { return GetParam() == "reuseport" ? 1 : 2; }
+};
+
+class DrainTest : public ::testing::TestWithParam<std::string>
+{
+};
+
+class TimeoutTest : public ::testing::TestWithParam<std::string>
+{
+};
+
+class BodyLimitTest : public ::testing::TestWithParam<std::string>
+{
+};
+
+tcp::socket connectTo(asio::io_context& ioc, int port)
+{
+    tcp::socket socket(ioc);
+    socket.connect({asio::ip::make_address("127.0.0.1"), static_cast<unsigned short>(port)});
+    return socket;
+}
+
+// Отправить сырой запрос по новому соединению и прочитать ответ
+http::response<http::string_body> rawRequest(int port, const std::string& request)
+{
+    asio::io_context ioc;
+    auto socket = connectTo(ioc, port);
+    asio::write(socket, asio::buffer(request));
+
+    beast::flat_buffer buffer;
+    http::response<http::string_body> res;
+    http::read(socket, buffer, res);
+    return res;
+}
+
+// Дождаться, пока сервер учтёт ровно count соединений
+bool waitForSessions(const BoostBeastApplication& app, std::size_t count)
+{
+    for (int attempt = 0; attempt < 500; ++attempt)
+    {
+        if (app.activeSessions() == count)
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+// Занять единственный слот соединения: сервер освобождает слот предыдущего
+// клиента чуть позже, чем тот закрывает сокет, поэтому повторяем попытку
+tcp::socket holdConnection(asio::io_context& ioc, int port, beast::flat_buffer& buffer)
+{
+    for (int attempt = 0; attempt < 100; ++attempt)
+    {
+        auto socket = connectTo(ioc, port);
+        if (roundTrip(socket, buffer, "/echo").result_int() == 200)
+        {
+            return socket;
+        }
+        buffer.clear();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    throw std::runtime_error("server did not release connection slot");
+}
+
+} // namespace
+
+// Режим пула: маршрутизация, wildcard, статическая таблица и 404 работают через async-сессии
+TEST(BoostBeastApplicationTest, PoolModeServesRequests)
+{
+    const int port = 18091;
+    TestApplication app(makeEnv(port, "pool", 2));
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    HttpClient client;
+
+    SimpleRequest wildcard("GET", "/items/42", "", "127.0.0.1", port);
+    SimpleResponse wildcardResponse;
+    ASSERT_TRUE(client.send(wildcard, wildcardResponse));
+    EXPECT_EQ(wildcardResponse.getStatus(), 200);
+    EXPECT_EQ(wildcardResponse.getBody(), "GET /items/42");
+
+    SimpleRequest staticRoute("GET", "/health", "", "127.0.0.1", port);
+    SimpleResponse staticResponse;
+    ASSERT_TRUE(client.send(staticRoute, staticResponse));
+    EXPECT_EQ(staticResponse.getStatus(), 200);
+    EXPECT_EQ(staticResponse.getBody(), "healthy");
+
+    SimpleRequest missing("GET", "/missing", "", "127.0.0.1", port);
+    SimpleResponse missingResponse;
+    ASSERT_TRUE(client.send(missing, missingResponse));
+    EXPECT_EQ(missingResponse.getStatus(), 404);
+
+    app.stop();
+    serverThread.join();
+}
+
+// Параллельные клиенты обслуживаются фиксированным числом потоков / шардов
+TEST_P(ServerModeTest, ConcurrentClients)
+{
+    const int port = portFor(18120, GetParam());
+    TestApplication app(makeEnv(port, GetParam(), 4));
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    std::atomic<int> succeeded{0};
+    std::vector<std::thread> clients;
+    for (int i = 0; i < 8; ++i)
+    {
+        clients.emplace_back([&] {
+            HttpClient client;
+            for (int j = 0; j < 10; ++j)
+            {
+                SimpleRequest request("GET", "/echo", "", "127.0.0.1", port);
+                SimpleResponse response;
+                if (client.send(request, response) && response.getBody() == "GET /echo")
+                {
+                    ++succeeded;
+                }
+            }
+        });
+    }
+    for (auto& client : clients)
+    {
+        client.join();
+    }
+
+    EXPECT_EQ(succeeded.load(), 80);
+
+    app.stop();
+    serverThread.join();
+}
+
+// Keep-alive: несколько запросов по одному соединению и закрытие по лимиту
+TEST_P(KeepAliveTest, ServesSeveralRequestsPerConnection)
+{
+    const int port = portFor(18100, GetParam());
+    auto env = makeEnv(port, GetParam(), 2);
+    env->setProperty("server.keep_alive.max_requests", 3);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    {
+        asio::io_context ioc;
+        tcp::socket socket(ioc);
+        socket.connect({asio::ip::make_address("127.0.0.1"), static_cast<unsigned short>(port)});
+        beast::flat_buffer buffer;
+
+        auto first = roundTrip(socket, buffer, "/echo");
+        EXPECT_EQ(first.body(), "GET /echo");
+        EXPECT_TRUE(first.keep_alive());
+
+        auto second = roundTrip(socket, buffer, "/items/7");
+        EXPECT_EQ(second.body(), "GET /items/7");
+        EXPECT_TRUE(second.keep_alive());
+
+        // Третий запрос исчерпывает лимит: сервер отвечает "Connection: close"
+        auto third = roundTrip(socket, buffer, "/echo");
+        EXPECT_EQ(third.result_int(), 200);
+        EXPECT_FALSE(third.keep_alive());
+        EXPECT_TRUE(peerClosed(socket, buffer));
+    }
+
+    {
+        // Клиент просит закрыть соединение
+        asio::io_context ioc;
+        tcp::socket socket(ioc);
+        socket.connect({asio::ip::make_address("127.0.0.1"), static_cast<unsigned short>(port)});
+        beast::flat_buffer buffer;
+
+        auto res = roundTrip(socket, buffer, "/echo", false);
+        EXPECT_FALSE(res.keep_alive());
+        EXPECT_TRUE(peerClosed(socket, buffer));
+    }
+
+    app.stop();
+    serverThread.join();
+}
+
+// Keep-alive: соединение без запросов закрывается по таймауту простоя
+TEST_P(KeepAliveTest, ClosesIdleConnection)
+{
+    const int port = portFor(18110, GetParam());
+    auto env = makeEnv(port, GetParam(), 2);
+    env->setProperty("server.keep_alive.timeout", 1);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    {
+        asio::io_context ioc;
+        tcp::socket socket(ioc);
+        socket.connect({asio::ip::make_address("127.0.0.1"), static_cast<unsigned short>(port)});
+        beast::flat_buffer buffer;
+
+        auto res = roundTrip(socket, buffer, "/echo");
+        EXPECT_TRUE(res.keep_alive());
+
+        auto started = std::chrono::steady_clock::now();
+        EXPECT_TRUE(peerClosed(socket, buffer));
+        EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(3));
+    }
+
+    app.stop();
+    serverThread.join();
+}
+
+// Лимит соединений, политика reject: лишнее соединение сразу получает 503
+TEST_P(OverloadTest, RejectsConnectionsOverLimit)
+{
+    const int port = portFor(18140, GetParam());
+    auto env = makeEnv(port, GetParam(), threads());
+    env->setProperty("server.max_connections", 1);
+    env->setProperty("server.retry_after", 2);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    {
+        asio::io_context ioc;
+        beast::flat_buffer heldBuffer;
+        auto held = holdConnection(ioc, port, heldBuffer);
+
+        auto extra = connectTo(ioc, port);
+        beast::flat_buffer extraBuffer;
+        http::response<http::string_body> res;
+        http::read(extra, extraBuffer, res);
+        EXPECT_EQ(res.result_int(), 503);
+        EXPECT_EQ(res[http::field::retry_after], "2");
+        EXPECT_FALSE(res.keep_alive());
+    }
+
+    // Слот освободился - сервер снова принимает соединения
+    EXPECT_TRUE(waitForServer(port));
+
+    app.stop();
+    serverThread.join();
+}
+
+// Лимит соединений, политика pause: лишнее соединение ждёт в backlog
+TEST_P(OverloadTest, PausesAcceptingOverLimit)
+{
+    const int port = portFor(18150, GetParam());
+    auto env = makeEnv(port, GetParam(), threads());
+    env->setProperty("server.max_connections", 1);
+    env->setProperty("server.overload", std::string("pause"));
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    asio::io_context ioc;
+    beast::flat_buffer heldBuffer;
+    auto held = holdConnection(ioc, port, heldBuffer);
+
+    // Второе соединение ставится в очередь ядра, ответ приходит после закрытия первого
+    auto waiting = std::async(std::launch::async, [port] {
+        asio::io_context clientIoc;
+        auto socket = connectTo(clientIoc, port);
+        beast::flat_buffer buffer;
+        return roundTrip(socket, buffer, "/echo").result_int();
+    });
+
+    EXPECT_EQ(waiting.wait_for(std::chrono::milliseconds(300)), std::future_status::timeout);
+
+    beast::error_code ec;
+    held.shutdown(tcp::socket::shutdown_both, ec);
+    held.close(ec);
+
+    ASSERT_EQ(waiting.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(waiting.get(), 200u);
+
+    app.stop();
+    serverThread.join();
+}
+
+// Лимит запросов в обработке: лишний запрос получает 503 без вызова обработчика
+TEST_P(OverloadTest, RejectsRequestsOverInflightLimit)
+{
+    if (GetParam() == "reuseport")
+    {
+        // Синхронный обработчик блокирует весь однопоточный шард
+        GTEST_SKIP();
+    }
+
+    const int port = portFor(18160, GetParam());
+    auto env = makeEnv(port, GetParam(), threads());
+    env->setProperty("server.max_inflight", 1);
+    env->setProperty("metrics.enabled", true);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::promise<void> open;
+    app.gate->opened = open.get_future().share();
+    auto entered = app.gate->entered.get_future();
+
+    std::thread serverThread([&] { app.start(); });
+
+    // Пока сервер не готов, waitForServer сам занимает слот на время запроса,
+    // поэтому ждём его до того, как заблокировать обработчик
+    ASSERT_TRUE(waitForServer(port));
+
+    auto blocked = std::async(std::launch::async, [port] {
+        asio::io_context clientIoc;
+        auto socket = connectTo(clientIoc, port);
+        beast::flat_buffer buffer;
+        return roundTrip(socket, buffer, "/gate").result_int();
+    });
+    ASSERT_EQ(entered.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    {
+        asio::io_context ioc;
+        auto socket = connectTo(ioc, port);
+        beast::flat_buffer buffer;
+        auto res = roundTrip(socket, buffer, "/echo");
+        EXPECT_EQ(res.result_int(), 503);
+    }
+
+    open.set_value();
+    EXPECT_EQ(blocked.get(), 200u);
+
+    // Отклонённый запрос учтён в гистограмме несопоставленных маршрутов.
+    // Сервер учитывает запрос уже после отправки ответа, поэтому ждём
+    const std::string rejected = "{method=\"\",route=\"\",status=\"5xx\"} 1\n";
+    HttpClient client;
+    SimpleResponse response;
+    for (int attempt = 0; attempt < 100; ++attempt)
+    {
+        SimpleRequest request("GET", "/metrics", "", "127.0.0.1", port);
+        response = SimpleResponse();
+        EXPECT_TRUE(client.send(request, response));
+        if (response.getBody().find(rejected) != std::string::npos)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_NE(response.getBody().find(rejected), std::string::npos) << response.getBody();
+
+    app.stop();
+    serverThread.join();
+}
+
+// Graceful drain: простаивающее соединение закрывается сразу,
+// запрос в обработке получает ответ, после чего stop() возвращается
+TEST_P(DrainTest, FinishesInflightAndClosesIdle)
+{
+    const int port = portFor(18170, GetParam());
+    auto env = makeEnv(port, GetParam(), 2);
+    env->setProperty("server.drain_timeout", 5);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::promise<void> open;
+    app.gate->opened = open.get_future().share();
+    auto entered = app.gate->entered.get_future();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    asio::io_context ioc;
+    auto idle = connectTo(ioc, port);
+    beast::flat_buffer idleBuffer;
+    EXPECT_EQ(roundTrip(idle, idleBuffer, "/echo").result_int(), 200);
+
+    auto blocked = std::async(std::launch::async, [port] {
+        asio::io_context clientIoc;
+        auto socket = connectTo(clientIoc, port);
+        beast::flat_buffer buffer;
+        return roundTrip(socket, buffer, "/gate");
+    });
+    ASSERT_EQ(entered.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_TRUE(waitForSessions(app, 2));
+
+    auto stopped = std::async(std::launch::async, [&] { app.stop(); });
+
+    // Шард reuseport может быть занят заблокированным обработчиком,
+    // тогда простаивающее соединение закроется только после него
+    if (GetParam() != "reuseport")
+    {
+        EXPECT_TRUE(peerClosed(idle, idleBuffer));
+    }
+    EXPECT_EQ(stopped.wait_for(std::chrono::milliseconds(200)), std::future_status::timeout);
+
+    open.set_value();
+    auto res = blocked.get();
+    EXPECT_EQ(res.result_int(), 200);
+    EXPECT_FALSE(res.keep_alive());
+
+    ASSERT_EQ(stopped.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(app.activeSessions(), 0u);
+    serverThread.join();
+}
+
+// Истёк server.drain_timeout: соединение с запросом в обработке закрывается
+TEST(BoostBeastApplicationTest, DrainTimeoutClosesInflightConnection)
+{
+    const int port = 18092;
+    auto env = makeEnv(port, "thread", 1);
+    env->setProperty("server.drain_timeout", 0);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::promise<void> open;
+    app.gate->opened = open.get_future().share();
+    auto entered = app.gate->entered.get_future();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    asio::io_context ioc;
+    auto socket = connectTo(ioc, port);
+    beast::flat_buffer buffer;
+    http::request<http::string_body> req{http::verb::get, "/gate", 11};
+    req.set(http::field::host, "127.0.0.1");
+    http::write(socket, req);
+    ASSERT_EQ(entered.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    app.stop();
+    serverThread.join();
+    EXPECT_TRUE(peerClosed(socket, buffer));
+
+    // Поток сессии завершается, как только обработчик вернёт управление
+    open.set_value();
+    EXPECT_TRUE(waitForSessions(app, 0));
+}
+
+// Медленный клиент: соединение без запроса и с недописанными заголовками
+// закрывается по server.timeouts.header_read
+TEST_P(TimeoutTest, ClosesSlowHeader)
+{
+    const int port = portFor(18180, GetParam());
+    auto env = makeEnv(port, GetParam(), 2);
+    env->setProperty("server.timeouts.header_read", 1);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    {
+        asio::io_context ioc;
+        auto silent = connectTo(ioc, port);
+        auto partial = connectTo(ioc, port);
+        asio::write(partial, asio::buffer(std::string("GET /echo HTTP/1.1\r\nHost: 127.0.0.1\r\n")));
+
+        auto started = std::chrono::steady_clock::now();
+        beast::flat_buffer buffer;
+        EXPECT_TRUE(peerClosed(silent, buffer));
+        EXPECT_GE(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(900));
+        buffer.clear();
+        EXPECT_TRUE(peerClosed(partial, buffer));
+        EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(3));
+    }
+
+    app.stop();
+    serverThread.join();
+}
+
+// Медленный клиент: тело не дописано за server.timeouts.body_read
+TEST_P(TimeoutTest, ClosesSlowBody)
+{
+    const int port = portFor(18190, GetParam());
+    auto env = makeEnv(port, GetParam(), 2);
+    env->setProperty("server.timeouts.body_read", 1);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    {
+        asio::io_context ioc;
+        auto socket = connectTo(ioc, port);
+        asio::write(socket, asio::buffer(std::string(
+            "GET /echo HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Length: 10\r\n\r\nabc")));
+
+        auto started = std::chrono::steady_clock::now();
+        beast::flat_buffer buffer;
+        EXPECT_TRUE(peerClosed(socket, buffer));
+        EXPECT_GE(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(900));
+        EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(3));
+    }
+
+    app.stop();
+    serverThread.join();
+}
+
+// Тело больше server.max_body_size: 413 по Content-Length до чтения тела
+// и по факту для chunked-тела
+TEST_P(BodyLimitTest, RejectsOversizedBody)
+{
+    const int port = portFor(18200, GetParam());
+    char dir[] = "/tmp/access-log-limit-XXXXXX";
+    ASSERT_NE(::mkdtemp(dir), nullptr);
+    const std::string path = std::string(dir) + "/access.bin";
+
+    auto env = makeEnv(port, GetParam(), 2);
+    env->setProperty("server.max_body_size", 1024);
+    env->setProperty("access_log.path", path);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    auto small = rawRequest(port,
+        "POST /body HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Length: 5\r\n\r\nhello");
+    EXPECT_EQ(small.result_int(), 200);
+    EXPECT_EQ(small.body(), "hello");
+
+    // Тело не отправляется: ответ приходит по одним заголовкам
+    auto declared = rawRequest(port,
+        "POST /body HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Length: 4096\r\n\r\n");
+    EXPECT_EQ(declared.result_int(), 413);
+    EXPECT_FALSE(declared.keep_alive());
+
+    auto chunked = rawRequest(port,
+        "POST /body HTTP/1.1\r\nHost: 127.0.0.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "800\r\n" + std::string(2048, 'x') + "\r\n0\r\n\r\n");
+    EXPECT_EQ(chunked.result_int(), 413);
+
+    app.stop();
+    serverThread.join();
+
+    // Отклонённые запросы попадают в журнал как обычные ответы
+    auto records = AccessLog::read(path);
+    std::system(("rm -rf " + std::string(dir)).c_str());
+    int rejected = 0;
+    for (const auto& record : records)
+    {
+        if (record.status == 413)
+        {
+            ++rejected;
+            EXPECT_EQ(record.method(), "POST");
+            EXPECT_EQ(record.route(), "");
+            EXPECT_EQ(record.ip(), "127.0.0.1");
+        }
+    }
+    EXPECT_EQ(rejected, 2);
+}
+
+// Потоковый маршрут со своим лимитом принимает тело больше server.max_body_size,
+// а соединение остаётся пригодным для следующего запроса
+TEST_P(BodyLimitTest, StreamsUploadWithRouteLimit)
+{
+    const int port = portFor(18210, GetParam());
+    auto env = makeEnv(port, GetParam(), 2);
+    env->setProperty("server.max_body_size", 1024);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    {
+        asio::io_context ioc;
+        auto socket = connectTo(ioc, port);
+        beast::flat_buffer buffer;
+
+        http::request<http::string_body> upload{http::verb::post, "/upload", 11};
+        upload.set(http::field::host, "127.0.0.1");
+        upload.body() = std::string(256 * 1024, 'u');
+        upload.prepare_payload();
+        http::write(socket, upload);
+
+        http::response<http::string_body> res;
+        http::read(socket, buffer, res);
+        EXPECT_EQ(res.result_int(), 200);
+        EXPECT_EQ(res.body(), std::to_string(256 * 1024));
+        EXPECT_TRUE(res.keep_alive());
+
+        EXPECT_EQ(roundTrip(socket, buffer, "/echo").body(), "GET /echo");
+    }
+
+    auto tooLarge = rawRequest(port,
+        "POST /upload HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Length: 2097152\r\n\r\n");
+    EXPECT_EQ(tooLarge.result_int(), 413);
+
+    app.stop();
+    serverThread.join();
+}
+
+// Потоковый ответ: заголовки приходят до завершения обработчика,
+// тело передаётся chunked, а соединение остаётся keep-alive
+TEST_P(ServerModeTest, StreamsChunkedResponse)
+{
+    const int port = portFor(18220, GetParam());
+    TestApplication app(makeEnv(port, GetParam(), 2));
+    app.configureInjection();
+
+    std::promise<void> proceed;
+    app.exporter->proceed = proceed.get_future().share();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    {
+        asio::io_context ioc;
+        auto socket = connectTo(ioc, port);
+        beast::flat_buffer buffer;
+
+        http::request<http::string_body> req{http::verb::get, "/export", 11};
+        req.set(http::field::host, "127.0.0.1");
+        http::write(socket, req);
+
+        // Обработчик ещё ждёт proceed, а статус и заголовки уже пришли
+        http::response_parser<http::string_body> parser;
+        parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+        http::read_header(socket, buffer, parser);
+        EXPECT_EQ(parser.get().result_int(), 200);
+        EXPECT_TRUE(parser.chunked());
+
+        proceed.set_value();
+        http::read(socket, buffer, parser);
+        EXPECT_EQ(parser.get().body(), "first;" + std::string(100 * 1024, 'e'));
+        EXPECT_TRUE(parser.get().keep_alive());
+
+        EXPECT_EQ(roundTrip(socket, buffer, "/echo").body(), "GET /echo");
+    }
+
+    app.stop();
+    serverThread.join();
+}
+
+// Клиенты, которые не читают потоковый ответ и файл, не занимают поток
+// сервера: с одним потоком другое соединение обслуживается, пока ответы ждут
+TEST_P(ServerModeTest, SlowReaderDoesNotBlockOtherConnections)
+{
+    const int port = portFor(18290, GetParam());
+
+    char dir[] = "/tmp/static-slow-XXXXXX";
+    ASSERT_NE(::mkdtemp(dir), nullptr);
+    const std::string root = dir;
+    const std::size_t fileSize = 16 * 1024 * 1024;
+    std::ofstream(root + "/big.bin", std::ios::binary) << std::string(fileSize, 'f');
+
+    TestApplication app(makeEnv(port, GetParam(), 1));
+    app.configureInjection();
+    app.serveStatic(root);
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    asio::io_context ioc;
+    auto send = [&](const char* target) {
+        auto socket = connectTo(ioc, port);
+        http::request<http::string_body> req{http::verb::get, target, 11};
+        req.set(http::field::host, "127.0.0.1");
+        http::write(socket, req);
+        return socket;
+    };
+    auto bulk = send("/bulk");
+    auto file = send("/static/big.bin");
+
+    auto other = std::async(std::launch::async, [port] {
+        asio::io_context clientIoc;
+        auto socket = connectTo(clientIoc, port);
+        beast::flat_buffer buffer;
+        return roundTrip(socket, buffer, "/echo").body();
+    });
+    ASSERT_EQ(other.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(other.get(), "GET /echo");
+
+    auto readAll = [](tcp::socket& socket) {
+        beast::flat_buffer buffer;
+        http::response_parser<http::string_body> parser;
+        parser.body_limit(boost::none);
+        http::read(socket, buffer, parser);
+        EXPECT_TRUE(parser.get().keep_alive());
+        return parser.get().body().size();
+    };
+    EXPECT_EQ(readAll(bulk), BulkHandler::kChunks * BulkHandler::kChunkSize);
+    EXPECT_EQ(readAll(file), fileSize);
+
+    app.stop();
+    serverThread.join();
+    std::system(("rm -rf " + root).c_str());
+}
+
+// Потоковый обработчик, ждущий тело, не занимает поток io_context
+TEST_P(ServerModeTest, SlowUploadDoesNotBlockOtherConnections)
+{
+    const int port = portFor(18294, GetParam());
+    TestApplication app(makeEnv(port, GetParam(), 1));
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    asio::io_context ioc;
+    auto upload = connectTo(ioc, port);
+    asio::write(upload, asio::buffer(std::string(
+        "POST /upload HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Length: 1000\r\n\r\n") + std::string(10, 'u')));
+
+    auto other = std::async(std::launch::async, [port] {
+        asio::io_context clientIoc;
+        auto socket = connectTo(clientIoc, port);
+        beast::flat_buffer buffer;
+        return roundTrip(socket, buffer, "/echo").body();
+    });
+    ASSERT_EQ(other.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(other.get(), "GET /echo");
+
+    asio::write(upload, asio::buffer(std::string(990, 'u')));
+    beast::flat_buffer buffer;
+    http::response<http::string_body> res;
+    http::read(upload, buffer, res);
+    EXPECT_EQ(res.body(), "1000");
+
+    app.stop();
+    serverThread.join();
+}
+
+// Статический файл отправляется sendfile с Content-Length и ETag,
+// повторный запрос с If-None-Match получает 304 по тому же соединению
+TEST_P(ServerModeTest, ServesStaticFile)
+{
+    const int port = portFor(18230, GetParam());
+
+    char dir[] = "/tmp/static-app-XXXXXX";
+    ASSERT_NE(::mkdtemp(dir), nullptr);
+    const std::string root = dir;
+    std::string content(2 * 1024 * 1024 + 17, '\0');
+    for (std::size_t i = 0; i < content.size(); ++i)
+    {
+        content[i] = static_cast<char>('a' + i % 26);
+    }
+    std::ofstream(root + "/big.txt", std::ios::binary) << content;
+
+    TestApplication app(makeEnv(port, GetParam(), 2));
+    app.configureInjection();
+    app.serveStatic(root);
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    {
+        asio::io_context ioc;
+        auto socket = connectTo(ioc, port);
+        beast::flat_buffer buffer;
+
+        http::request<http::string_body> req{http::verb::get, "/static/big.txt", 11};
+        req.set(http::field::host, "127.0.0.1");
+        http::write(socket, req);
+
+        http::response_parser<http::string_body> parser;
+        parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+        http::read(socket, buffer, parser);
+        const auto& res = parser.get();
+        EXPECT_EQ(res.result_int(), 200);
+        EXPECT_EQ(res[http::field::content_length], std::to_string(content.size()));
+        EXPECT_EQ(res[http::field::content_type], "text/plain; charset=utf-8");
+        EXPECT_TRUE(res.body() == content);
+        ASSERT_FALSE(res[http::field::etag].empty());
+
+        req.set(http::field::if_none_match, res[http::field::etag]);
+        http::write(socket, req);
+        http::response<http::string_body> cached;
+        http::read(socket, buffer, cached);
+        EXPECT_EQ(cached.result_int(), 304);
+    }
+
+    app.stop();
+    serverThread.join();
+    std::system(("rm -rf " + root).c_str());
+}
+
+// Именованные сегменты пути доступны обработчику, {id:int} не принимает не-число
+TEST_P(ServerModeTest, RoutesNamedPathParams)
+{
+    const int port = portFor(18240, GetParam());
+    TestApplication app(makeEnv(port, GetParam(), 2));
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    HttpClient client;
+
+    SimpleRequest order("GET", "/users/42/orders/a-17?expand=1", "", "127.0.0.1", port);
+    SimpleResponse orderResponse;
+    ASSERT_TRUE(client.send(order, orderResponse));
+    EXPECT_EQ(orderResponse.getStatus(), 200);
+    EXPECT_EQ(orderResponse.getBody(), "user=42 order=a-17");
+
+    SimpleRequest notNumber("GET", "/users/bob/orders/1", "", "127.0.0.1", port);
+    SimpleResponse notNumberResponse;
+    ASSERT_TRUE(client.send(notNumber, notNumberResponse));
+    EXPECT_EQ(notNumberResponse.getStatus(), 404);
+
+    app.stop();
+    serverThread.join();
+}
+
+// Общий буфер уходит без копирования и не мешает keep-alive; appendBody копит тело
+TEST_P(ServerModeTest, ServesSharedAndAppendedBodies)
+{
+    const int port = portFor(18250, GetParam());
+    TestApplication app(makeEnv(port, GetParam(), 2));
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    asio::io_context ioc;
+    tcp::socket socket(ioc);
+    socket.connect(tcp::endpoint(asio::ip::make_address("127.0.0.1"), static_cast<unsigned short>(port)));
+    beast::flat_buffer buffer;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        http::request<http::empty_body> req{http::verb::get, "/shared", 11};
+        req.set(http::field::host, "127.0.0.1");
+        http::write(socket, req);
+
+        http::response_parser<http::string_body> parser;
+        parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+        http::read(socket, buffer, parser);
+        auto res = parser.release();
+        EXPECT_EQ(res.result_int(), 200);
+        EXPECT_EQ(res[http::field::content_length], std::to_string(200 * 1024));
+        EXPECT_EQ(res.body(), *app.shared->body);
+        EXPECT_TRUE(res.keep_alive());
+    }
+
+    http::request<http::empty_body> report{http::verb::get, "/report", 11};
+    report.set(http::field::host, "127.0.0.1");
+    http::write(socket, report);
+    http::response<http::string_body> reportResponse;
+    http::read(socket, buffer, reportResponse);
+    EXPECT_EQ(reportResponse.body().size(), 6000u);
+    EXPECT_EQ(reportResponse.body().substr(0, 12), "line;\nline;\n");
+
+    socket.close();
+    app.stop();
+    serverThread.join();
+}
+
+// Журнал доступа: паттерн маршрута, статус и размеры тел каждого запроса
+TEST_P(ServerModeTest, WritesAccessLog)
+{
+    const int port = portFor(18260, GetParam());
+    char dir[] = "/tmp/access-log-app-XXXXXX";
+    ASSERT_NE(::mkdtemp(dir), nullptr);
+    const std::string path = std::string(dir) + "/access.bin";
+
+    auto env = makeEnv(port, GetParam(), 2);
+    env->setProperty("access_log.path", path);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    HttpClient client;
+    for (const auto& [method, target, body] : {std::tuple<std::string, std::string, std::string>{"GET", "/users/42/orders/7", ""},
+                                               {"GET", "/health", ""},
+                                               {"GET", "/missing", ""},
+                                               {"POST", "/body", "payload"},
+                                               {"GET", "/shared", ""}})
+    {
+        SimpleRequest request(method, target, body, "127.0.0.1", port);
+        SimpleResponse response;
+        ASSERT_TRUE(client.send(request, response));
+    }
+
+    app.stop();
+    serverThread.join();
+
+    auto records = AccessLog::read(path);
+    std::system(("rm -rf " + std::string(dir)).c_str());
+
+    auto find = [&](std::string_view route, int status) -> const AccessRecord* {
+        for (const auto& record : records)
+        {
+            if (record.route() == route && record.status == status)
+            {
+                return &record;
+            }
+        }
+        return nullptr;
+    };
+
+    const AccessRecord* order = find("/users/{id:int}/orders/{orderId}", 200);
+    ASSERT_NE(order, nullptr);
+    EXPECT_EQ(order->method(), "GET");
+    EXPECT_EQ(order->ip(), "127.0.0.1");
+    EXPECT_EQ(order->bytesOut, std::string("user=42 order=7").size());
+    EXPECT_GT(order->timeNs, 0u);
+
+    EXPECT_NE(find("/health", 200), nullptr);
+    EXPECT_NE(find("", 404), nullptr);
+
+    const AccessRecord* post = find("/body", 200);
+    ASSERT_NE(post, nullptr);
+    EXPECT_EQ(post->method(), "POST");
+    EXPECT_EQ(post->bytesIn, 7u);
+
+    const AccessRecord* shared = find("/shared", 200);
+    ASSERT_NE(shared, nullptr);
+    EXPECT_EQ(shared->bytesOut, 200u * 1024);
+}
+
+// Отметки времени: видны обработчику, уходят в Server-Timing и получателю отметок
+TEST_P(ServerModeTest, ExposesRequestTiming)
+{
+    const int port = portFor(18268, GetParam());
+    auto env = makeEnv(port, GetParam(), 2);
+    env->setProperty("server.server_timing", true);
+    TestApplication app(env);
+    app.configureInjection();
+    auto exporter = std::make_shared<RecordingExporter>();
+    app.setTimingExporter(exporter);
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    HttpClient client;
+    SimpleRequest request("GET", "/timing/1", "", "127.0.0.1", port);
+    SimpleResponse response;
+    ASSERT_TRUE(client.send(request, response));
+
+    // Общий буфер уходит с заголовками при finish() - Server-Timing тоже
+    SimpleRequest sharedRequest("GET", "/shared", "", "127.0.0.1", port);
+    SimpleResponse sharedResponse;
+    ASSERT_TRUE(client.send(sharedRequest, sharedResponse));
+
+    app.stop();
+    serverThread.join();
+
+    EXPECT_EQ(sharedResponse.getHeaders().count("Server-Timing"), 1u);
+    EXPECT_EQ(response.getBody(), "ordered");
+    auto headers = response.getHeaders();
+    ASSERT_EQ(headers.count("Server-Timing"), 1u);
+    EXPECT_EQ(headers["Server-Timing"].rfind("read;dur=", 0), 0u) << headers["Server-Timing"];
+    EXPECT_NE(headers["Server-Timing"].find(", route;dur="), std::string::npos);
+    EXPECT_NE(headers["Server-Timing"].find(", handle;dur="), std::string::npos);
+
+    std::lock_guard<std::mutex> lock(exporter->mutex);
+    const RecordingExporter::Entry* entry = nullptr;
+    for (const auto& candidate : exporter->entries)
+    {
+        if (candidate.route == "/timing/{step}")
+        {
+            entry = &candidate;
+        }
+    }
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->method, "GET");
+    EXPECT_EQ(entry->status, 200);
+    for (std::size_t mark = 0; mark < RequestTiming::MarkCount; ++mark)
+    {
+        EXPECT_TRUE(entry->timing.has(static_cast<RequestTiming::Mark>(mark))) << mark;
+    }
+    EXPECT_LE(entry->timing.marks[RequestTiming::Handled], entry->timing.marks[RequestTiming::Written]);
+    EXPECT_GE(entry->timing.total(), entry->timing.handle());
+}
+
+// Метрики: серии по паттерну маршрута и классу статуса, gauge соединений
+TEST_P(ServerModeTest, ExposesMetrics)
+{
+    const int port = portFor(18264, GetParam());
+    auto env = makeEnv(port, GetParam(), 2);
+    env->setProperty("metrics.enabled", true);
+    TestApplication app(env);
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    HttpClient client;
+    for (const char* target : {"/users/42/orders/7", "/users/43/orders/8", "/health", "/missing"})
+    {
+        SimpleRequest request("GET", target, "", "127.0.0.1", port);
+        SimpleResponse response;
+        ASSERT_TRUE(client.send(request, response));
+    }
+
+    SimpleRequest request("GET", "/metrics", "", "127.0.0.1", port);
+    SimpleResponse response;
+    ASSERT_TRUE(client.send(request, response));
+
+    app.stop();
+    serverThread.join();
+
+    EXPECT_EQ(response.getStatus(), 200);
+    std::string body = response.getBody();
+    EXPECT_NE(body.find("http_server_request_duration_seconds_count{method=\"GET\","
+                        "route=\"/users/{id:int}/orders/{orderId}\",status=\"2xx\"} 2\n"),
+              std::string::npos) << body;
+    EXPECT_NE(body.find("route=\"/health\",status=\"2xx\"} 1\n"), std::string::npos) << body;
+    EXPECT_NE(body.find("{method=\"\",route=\"\",status=\"4xx\"} 1\n"), std::string::npos) << body;
+    EXPECT_NE(body.find("quantile=\"0.99\""), std::string::npos);
+    EXPECT_NE(body.find("http_server_requests_in_flight 1\n"), std::string::npos) << body;
+    EXPECT_NE(body.find("\nhttp_server_connections "), std::string::npos) << body;
+}
+
+// Буфер чтения тела запасается по Content-Length, но не больше порции чтения и лимита
+TEST(BoostBeastApplicationTest, ReservesBodyBufferFromContentLength)
+{
+    beast::flat_buffer buffer;
+    buffer.commit(asio::buffer_copy(buffer.prepare(10), asio::buffer("0123456789", 10)));
+
+    RequestCycle::reserveBody(buffer, std::uint64_t{256 * 1024}, 1 << 20);
+    EXPECT_GE(buffer.capacity(), 10u + 64 * 1024);
+    EXPECT_EQ(buffer.size(), 10u);
+
+    beast::flat_buffer small;
+    RequestCycle::reserveBody(small, std::uint64_t{100}, 1 << 20);
+    EXPECT_GE(small.capacity(), 100u);
+    EXPECT_LT(small.capacity(), 64u * 1024);
+
+    beast::flat_buffer limited;
+    RequestCycle::reserveBody(limited, boost::none, 1000);
+    EXPECT_GE(limited.capacity(), 1000u);
+    EXPECT_LT(limited.capacity(), 64u * 1024);
+}
+
+// Повторный start() не дублирует gauge соединений в /metrics
+TEST(BoostBeastApplicationTest, RestartKeepsSingleConnectionsGauge)
+{
+    const int port = 18276;
+    auto env = makeEnv(port, "pool", 2);
+    env->setProperty("metrics.enabled", true);
+    TestApplication app(env);
+    app.configureInjection();
+
+    SimpleResponse response;
+    for (int run = 0; run < 2; ++run)
+    {
+        std::thread serverThread([&] { app.start(); });
+        ASSERT_TRUE(waitForServer(port));
+        SimpleRequest request("GET", "/metrics", "", "127.0.0.1", port);
+        response = SimpleResponse();
+        EXPECT_TRUE(HttpClient().send(request, response));
+        app.stop();
+        serverThread.join();
+    }
+
+    std::string body = response.getBody();
+    auto first = body.find("# TYPE http_server_connections");
+    ASSERT_NE(first, std::string::npos) << body;
+    EXPECT_EQ(body.find("# TYPE http_server_connections", first + 1), std::string::npos) << body;
+}
+
+// stop() до start() отменяет запуск, следующий start() работает как обычно
+TEST_P(ServerModeTest, StopBeforeStartCancelsStart)
+{
+    const int port = portFor(18272, GetParam());
+    TestApplication app(makeEnv(port, GetParam(), 2));
+    app.configureInjection();
+
+    app.stop();
+    auto cancelled = std::async(std::launch::async, [&] { app.start(); });
+    ASSERT_EQ(cancelled.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+    SimpleRequest request("GET", "/health", "", "127.0.0.1", port);
+    SimpleResponse response;
+    EXPECT_TRUE(HttpClient().send(request, response));
+    EXPECT_EQ(response.getStatus(), 200);
+
+    app.stop();
+    serverThread.join();
+}
+
+#ifdef MICROSERVICE_COROUTINES
+// Асинхронный обработчик: co_await в режиме coroutine, синхронный fallback в остальных
+TEST_P(ServerModeTest, AsyncHandler)
+{
+    const int port = portFor(18130, GetParam());
+    TestApplication app(makeEnv(port, GetParam(), 2));
+    app.configureInjection();
+
+    std::thread serverThread([&] { app.start(); });
+    ASSERT_TRUE(waitForServer(port));
+
+    HttpClient client;
+    SimpleRequest request("GET", "/delayed", "", "127.0.0.1", port);
+    SimpleResponse response;
+    ASSERT_TRUE(client.send(request, response));
+    EXPECT_EQ(response.getStatus(), 200);
+    EXPECT_EQ(response.getBody(), "delayed /delayed");
+
+    app.stop();
+    serverThread.join();
+}
+
+#define SERVER_MODES ::testing::Values("thread", "pool", "reuseport", "coroutine")
+#else
+#define SERVER_MODES ::testing::Values("thread", "pool", "reuseport")
+#endif
+
+INSTANTIATE_TEST_SUITE_P(Modes, KeepAliveTest, SERVER_MODES);
+INSTANTIATE_TEST_SUITE_P(Modes, ServerModeTest, SERVER_MODES);
+INSTANTIATE_TEST_SUITE_P(Modes, OverloadTest, SERVER_MODES);
+INSTANTIATE_TEST_SUITE_P(Modes, DrainTest, SERVER_MODES);
+INSTANTIATE_TEST_SUITE_P(Modes, TimeoutTest, SERVER_MODES);
+INSTANTIATE_TEST_SUITE_P(Modes, BodyLimitTest, SERVER_MODES);
@@ -1,9 +1,13 @@
 #include <gtest/gtest.h>
 #include <thread>
 #include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 
+#include "Environment.hpp"
 #include "HttpClient.hpp"
 #include "IRequest.hpp"
 #include "IResponse.hpp"
@@ -88,6 +92,108 @@ void runTestHttpServer(std::atomic<bool>& ready)
     }
 }
 
+// Сервер keep-alive: поток на соединение, считает принятые соединения.
+// closeAfterResponse - закрывать соединение после ответа, не предупреждая клиента
+class KeepAliveServer
+{
+public:
+    KeepAliveServer(unsigned short port, bool closeAfterResponse = false)
+        : acceptor_(ioc_, tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), port)),
+          closeAfterResponse_(closeAfterResponse)
+    {
+        acceptThread_ = std::thread([this] { acceptLoop(); });
+    }
+
+    ~KeepAliveServer()
+    {
+        stopping_ = true;
+        beast::error_code ec;
+        tcp::socket wakeup(ioc_);
+        wakeup.connect(acceptor_.local_endpoint(), ec);
+        acceptThread_.join();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& socket : sockets_)
+            {
+                socket.shutdown(tcp::socket::shutdown_both, ec);
+            }
+        }
+        for (auto& thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    std::atomic<int> accepted{0};
+    std::atomic<int> requests{0};
+
+private:
+    void acceptLoop()
+    {
+        while (true)
+        {
+            tcp::socket socket(ioc_);
+            beast::error_code ec;
+            acceptor_.accept(socket, ec);
+            if (stopping_ || ec)
+            {
+                return;
+            }
+            ++accepted;
+            std::lock_guard<std::mutex> lock(mutex_);
+            sockets_.push_back(std::move(socket));
+            threads_.emplace_back([this, &connection = sockets_.back()] { serve(connection); });
+        }
+    }
+
+    void serve(tcp::socket& socket)
+    {
+        beast::flat_buffer buffer;
+        while (true)
+        {
+            http::request<http::string_body> req;
+            beast::error_code ec;
+            http::read(socket, buffer, req, ec);
+            if (ec)
+            {
+                return;
+            }
+            ++requests;
+            if (req.target() == "/slow")
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            }
+
+            http::response<http::string_body> res{http::status::ok, 11};
+            res.body() = std::string(req.target());
+            res.prepare_payload();
+            http::write(socket, res, ec);
+            if (ec || closeAfterResponse_)
+            {
+                socket.shutdown(tcp::socket::shutdown_both, ec);
+                return;
+            }
+        }
+    }
+
+    boost::asio::io_context ioc_;
+    tcp::acceptor acceptor_;
+    bool closeAfterResponse_;
+    std::atomic<bool> stopping_{false};
+    std::mutex mutex_;
+    std::list<tcp::socket> sockets_;
+    std::vector<std::thread> threads_;
+    std::thread acceptThread_;
+};
+
+TestRequest requestTo(unsigned short port, const std::string& path)
+{
+    TestRequest request;
+    request.port = port;
+    request.path = path;
+    return request;
+}
+
 // -----------------------------------------------------------------------------
 //                                Т Е С Т
 // -----------------------------------------------------------------------------
@@ -118,3 +224,177 @@ TEST(HttpClientTest, SendRealHttpRequest)
     ASSERT_TRUE(headers.find("Server") != headers.end());
     ASSERT_EQ(headers["Server"], "TestServer");
 }
+
+// Тест: последовательные запросы идут по одному keep-alive соединению
+TEST(HttpClientTest, ReusesKeepAliveConnection)
+{
+    KeepAliveServer server(18280);
+    HttpClient client;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        TestRequest request = requestTo(18280, "/ping/" + std::to_string(i));
+        TestResponse response;
+        ASSERT_TRUE(client.send(request, response));
+        EXPECT_EQ(response.getStatus(), 200);
+        EXPECT_EQ(response.getBody(), "/ping/" + std::to_string(i));
+    }
+
+    EXPECT_EQ(server.accepted.load(), 1);
+    EXPECT_EQ(client.idleConnections(), 1u);
+    EXPECT_EQ(client.openConnections(), 1u);
+
+    client.closeIdle();
+    EXPECT_EQ(client.openConnections(), 0u);
+}
+
+// Тест: соединение, закрытое сервером, отбраковывается при выдаче из пула
+TEST(HttpClientTest, ReplacesConnectionClosedByServer)
+{
+    KeepAliveServer server(18281, true);
+    HttpClient client;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        TestRequest request = requestTo(18281, "/once");
+        TestResponse response;
+        ASSERT_TRUE(client.send(request, response));
+        EXPECT_EQ(response.getBody(), "/once");
+        // Даём серверу закрыть сокет до следующего запроса
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    EXPECT_EQ(server.accepted.load(), 3);
+    EXPECT_EQ(server.requests.load(), 3);
+}
+
+// Тест: простоявшие дольше idleTimeout соединения закрываются
+TEST(HttpClientTest, EvictsIdleConnections)
+{
+    KeepAliveServer server(18282);
+    HttpClient::Options options;
+    options.idleTimeout = std::chrono::milliseconds(50);
+    HttpClient client(options);
+
+    TestRequest request = requestTo(18282, "/idle");
+    TestResponse first;
+    ASSERT_TRUE(client.send(request, first));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    TestResponse second;
+    ASSERT_TRUE(client.send(request, second));
+
+    EXPECT_EQ(server.accepted.load(), 2);
+    EXPECT_EQ(client.openConnections(), 1u);
+}
+
+// Тест: простаивающие соединения к адресату, которому больше не пишут, тоже закрываются
+TEST(HttpClientTest, EvictsIdleConnectionsOfUnusedHosts)
+{
+    KeepAliveServer unused(18285);
+    KeepAliveServer active(18286);
+    HttpClient::Options options;
+    options.idleTimeout = std::chrono::milliseconds(50);
+    HttpClient client(options);
+
+    TestResponse first;
+    ASSERT_TRUE(client.send(requestTo(18285, "/idle"), first));
+    EXPECT_EQ(client.idleConnections(), 1u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    TestResponse second;
+    ASSERT_TRUE(client.send(requestTo(18286, "/active"), second));
+
+    EXPECT_EQ(client.idleConnections(), 1u);
+    EXPECT_EQ(client.openConnections(), 1u);
+}
+
+// Тест: конкурентные запросы укладываются в лимиты соединений
+TEST(HttpClientTest, LimitsConnectionsAcrossThreads)
+{
+    KeepAliveServer server(18283);
+    HttpClient::Options options;
+    options.maxConnectionsPerHost = 2;
+    options.maxIdlePerHost = 1;
+    HttpClient client(options);
+
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&client, &failures, t] {
+            for (int i = 0; i < 20; ++i)
+            {
+                TestRequest request = requestTo(18283, "/t" + std::to_string(t));
+                TestResponse response;
+                if (!client.send(request, response) || response.getBody() != request.path)
+                {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(server.requests.load(), 160);
+    EXPECT_LE(client.openConnections(), 1u);
+    EXPECT_EQ(client.idleConnections(), client.openConnections());
+}
+
+// Тест: при исчерпанном лимите запрос ждёт не дольше acquireTimeout
+TEST(HttpClientTest, FailsWhenPoolExhausted)
+{
+    KeepAliveServer server(18284);
+    HttpClient::Options options;
+    options.maxConnectionsPerHost = 1;
+    options.acquireTimeout = std::chrono::milliseconds(50);
+    HttpClient client(options);
+
+    std::atomic<bool> slowOk{false};
+    std::thread slow([&] {
+        TestRequest request = requestTo(18284, "/slow");
+        TestResponse response;
+        slowOk = client.send(request, response);
+    });
+    while (server.requests.load() == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    TestRequest request = requestTo(18284, "/fast");
+    TestResponse response;
+    EXPECT_FALSE(client.send(request, response));
+    EXPECT_EQ(response.getStatus(), 500);
+
+    slow.join();
+    EXPECT_TRUE(slowOk.load());
+    EXPECT_EQ(server.accepted.load(), 1);
+}
+
+TEST(HttpClientTest, ReadsOptionsFromEnvironment)
+{
+    Environment env;
+    auto defaults = HttpClient::Options::fromEnvironment(env);
+    EXPECT_EQ(defaults.maxIdlePerHost, 8u);
+    EXPECT_EQ(defaults.maxConnectionsPerHost, 64u);
+    EXPECT_EQ(defaults.idleTimeout, std::chrono::milliseconds(30000));
+
+    env.setProperty("http_client.max_idle_per_host", 2);
+    env.setProperty("http_client.max_connections_per_host", 0);
+    env.setProperty("http_client.idle_timeout_ms", 1500);
+    env.setProperty("http_client.acquire_timeout_ms", 100);
+    auto options = HttpClient::Options::fromEnvironment(env);
+    EXPECT_EQ(options.maxIdlePerHost, 2u);
+    EXPECT_EQ(options.maxConnectionsPerHost, 0u);
+    EXPECT_EQ(options.idleTimeout, std::chrono::milliseconds(1500));
+    EXPECT_EQ(options.acquireTimeout, std::chrono::milliseconds(100));
+
+    env.setProperty("http_client.idle_timeout_ms", 0);
+    EXPECT_THROW(HttpClient::Options::fromEnvironment(env), std::runtime_error);
+    env.setProperty("http_client.idle_timeout_ms", 1500);
+    env.setProperty("http_client.max_idle_per_host", -1);
+    EXPECT_THROW(HttpClient::Options::fromEnvironment(env), std::runtime_error);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <boost/beast/http.hpp>
+#include "BeastRequestAdapter.hpp"
+#include "HttpSession.hpp"
+#include "RequestArena.hpp"
+#include <memory_resource>
+#include <string>
+
+/**
+ * @file RequestArenaTest.cpp
+ * @brief Unit-тесты для RequestArena
+ */
+
+namespace
+{
+
+namespace http = boost::beast::http;
+
+/**
+ * @brief Upstream-ресурс, считающий выделения сверх начального блока арены
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    int allocated = 0;
+    int released = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocated;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        ++released;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+// Тест: запрос, поместившийся в начальный блок, не обращается к upstream
+TEST(RequestArenaTest, SmallRequestStaysInInitialBlock)
+{
+    CountingResource upstream;
+    RequestArena arena(RequestArena::defaultSize, &upstream);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        arena.reset();
+        ArenaRequest req{std::piecewise_construct, std::make_tuple(arena.allocator()),
+                         std::make_tuple(arena.allocator())};
+        req.method(http::verb::post);
+        req.target("/api/users?id=10");
+        req.set(http::field::host, "localhost");
+        req.set(http::field::content_type, "application/json");
+        req.body() = "{\"name\":\"Anton\"}";
+    }
+
+    EXPECT_EQ(upstream.allocated, 0);
+}
+
+// Тест: reset() возвращает upstream всё выделенное сверх начального блока
+TEST(RequestArenaTest, ResetReleasesOverflow)
+{
+    CountingResource upstream;
+    RequestArena arena(256, &upstream);
+
+    {
+        std::pmr::string large(std::string(4096, 'x'), arena.resource());
+        EXPECT_EQ(large.size(), 4096u);
+    }
+    EXPECT_GT(upstream.allocated, 0);
+    EXPECT_EQ(upstream.released, 0);
+
+    arena.reset();
+    EXPECT_EQ(upstream.released, upstream.allocated);
+}
+
+// Тест: обработчик получает арену запроса через IRequest::arena()
+TEST(RequestArenaTest, AdapterExposesArena)
+{
+    RequestArena arena;
+    ArenaRequest req{std::piecewise_construct, std::make_tuple(arena.allocator()),
+                     std::make_tuple(arena.allocator())};
+    req.target("/search?q=a+b");
+    BeastRequestAdapter adapter(req, "127.0.0.1");
+
+    EXPECT_EQ(adapter.arena(), arena.resource());
+    EXPECT_EQ(adapter.param("q"), "a b");
+
+    std::pmr::string scratch("temporary", adapter.arena());
+    EXPECT_EQ(scratch.get_allocator().resource(), arena.resource());
+}
+
+// Тест: парсер с аллокатором арены разбирает запрос целиком
+TEST(RequestArenaTest, ParserUsesArena)
+{
+    CountingResource upstream;
+    RequestArena arena(RequestArena::defaultSize, &upstream);
+
+    const std::string raw =
+        "POST /submit HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "Content-Length: 5\r\n"
+        "\r\n"
+        "hello";
+
+    HttpSession::Parser parser{std::piecewise_construct, std::make_tuple(arena.allocator()),
+                               std::make_tuple(arena.allocator())};
+    parser.eager(true);
+    boost::beast::error_code ec;
+    parser.put(boost::asio::buffer(raw), ec);
+
+    ASSERT_FALSE(ec);
+    ASSERT_TRUE(parser.is_done());
+    EXPECT_EQ(parser.get().body(), "hello");
+    EXPECT_EQ(parser.get()[http::field::host], "localhost");
+    EXPECT_EQ(upstream.allocated, 0);
+}
@@ -65,4 +65,194 @@ TEST(ServerSettingsTest, InvalidHostType)
     EXPECT_THROW({
         ServerSettings settings(env);
     }, std::runtime_error);
-}
\ No newline at end of file
+}
+// Необязательные параметры: режим и число потоков по умолчанию
+TEST(ServerSettingsTest, DefaultModeAndThreads)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+
+    ServerSettings settings(env);
+
+    EXPECT_EQ(settings.getMode(), ServerMode::ThreadPerConnection);
+    EXPECT_GE(settings.getThreads(), 1);
+}
+
+// Режим пула с явным числом потоков
+TEST(ServerSettingsTest, PoolMode)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+    env->setProperty("server.mode", std::string("pool"));
+    env->setProperty("server.threads", 4);
+
+    ServerSettings settings(env);
+
+    EXPECT_EQ(settings.getMode(), ServerMode::Pool);
+    EXPECT_EQ(settings.getThreads(), 4);
+}
+
+// Режим SO_REUSEPORT
+TEST(ServerSettingsTest, ReusePortMode)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+    env->setProperty("server.mode", std::string("reuseport"));
+    env->setProperty("server.threads", 2);
+
+    ServerSettings settings(env);
+
+    EXPECT_EQ(settings.getMode(), ServerMode::ReusePort);
+    EXPECT_EQ(settings.getThreads(), 2);
+}
+
+// Ошибка: неизвестный режим
+TEST(ServerSettingsTest, InvalidMode)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+    env->setProperty("server.mode", std::string("fork"));
+
+    EXPECT_THROW({
+        ServerSettings settings(env);
+    }, std::runtime_error);
+}
+
+// Ошибка: неположительное число потоков
+TEST(ServerSettingsTest, InvalidThreads)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+    env->setProperty("server.threads", 0);
+
+    EXPECT_THROW({
+        ServerSettings settings(env);
+    }, std::runtime_error);
+}
+
+// Потоки для потоковых обработчиков: по умолчанию 4, только положительное число
+TEST(ServerSettingsTest, BlockingThreads)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+    EXPECT_EQ(ServerSettings(env).getBlockingThreads(), 4);
+
+    env->setProperty("server.blocking_threads", 8);
+    EXPECT_EQ(ServerSettings(env).getBlockingThreads(), 8);
+
+    env->setProperty("server.blocking_threads", 0);
+    EXPECT_THROW(ServerSettings settings(env), std::runtime_error);
+}
+
+// Лимиты и политика перегрузки
+TEST(ServerSettingsTest, OverloadSettings)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+    env->setProperty("server.max_connections", 1000);
+    env->setProperty("server.max_inflight", 64);
+    env->setProperty("server.overload", std::string("pause"));
+    env->setProperty("server.retry_after", 3);
+
+    ServerSettings settings(env);
+
+    EXPECT_EQ(settings.getMaxConnections(), 1000);
+    EXPECT_EQ(settings.getMaxInflight(), 64);
+    EXPECT_EQ(settings.getOverloadPolicy(), OverloadPolicy::Pause);
+    EXPECT_EQ(settings.getRetryAfter(), 3);
+}
+
+// Ошибка: неизвестная политика перегрузки
+TEST(ServerSettingsTest, InvalidOverloadPolicy)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+    env->setProperty("server.overload", std::string("drop"));
+
+    EXPECT_THROW({
+        ServerSettings settings(env);
+    }, std::runtime_error);
+}
+
+// Таймаут graceful drain
+TEST(ServerSettingsTest, DrainTimeout)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+
+    EXPECT_EQ(ServerSettings(env).getDrainTimeout(), 10);
+
+    env->setProperty("server.drain_timeout", 30);
+    EXPECT_EQ(ServerSettings(env).getDrainTimeout(), 30);
+
+    env->setProperty("server.drain_timeout", -1);
+    EXPECT_THROW({
+        ServerSettings settings(env);
+    }, std::runtime_error);
+}
+
+// Сроки чтения и записи
+TEST(ServerSettingsTest, IoTimeouts)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+
+    ServerSettings defaults(env);
+    EXPECT_EQ(defaults.getHeaderReadTimeout(), 10);
+    EXPECT_EQ(defaults.getBodyReadTimeout(), 30);
+    EXPECT_EQ(defaults.getWriteTimeout(), 30);
+
+    env->setProperty("server.timeouts.header_read", 2);
+    env->setProperty("server.timeouts.body_read", 5);
+    env->setProperty("server.timeouts.write", 7);
+    ServerSettings settings(env);
+    EXPECT_EQ(settings.getHeaderReadTimeout(), 2);
+    EXPECT_EQ(settings.getBodyReadTimeout(), 5);
+    EXPECT_EQ(settings.getWriteTimeout(), 7);
+
+    env->setProperty("server.timeouts.write", 0);
+    EXPECT_THROW({
+        ServerSettings invalid(env);
+    }, std::runtime_error);
+}
+
+// Лимит тела запроса по умолчанию
+TEST(ServerSettingsTest, MaxBodySize)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+
+    EXPECT_EQ(ServerSettings(env).getMaxBodySize(), 1024 * 1024);
+
+    env->setProperty("server.max_body_size", 4096);
+    EXPECT_EQ(ServerSettings(env).getMaxBodySize(), 4096);
+
+    env->setProperty("server.max_body_size", 0);
+    EXPECT_THROW({
+        ServerSettings settings(env);
+    }, std::runtime_error);
+}
+
+// Заголовок Server-Timing выключен по умолчанию
+TEST(ServerSettingsTest, ServerTiming)
+{
+    auto env = std::make_shared<Environment>();
+    env->setProperty("server.host", std::string("127.0.0.1"));
+    env->setProperty("server.port", 8080);
+
+    EXPECT_FALSE(ServerSettings(env).getServerTiming());
+
+    env->setProperty("server.server_timing", true);
+    EXPECT_TRUE(ServerSettings(env).getServerTiming());
+}
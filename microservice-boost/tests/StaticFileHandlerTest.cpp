@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "OpenFileCache.hpp"
+#include "SimpleRequest.hpp"
+#include "SimpleResponse.hpp"
+#include "StaticFileHandler.hpp"
+
+/**
+ * @file StaticFileHandlerTest.cpp
+ * @brief Unit-тесты для StaticFileHandler и OpenFileCache
+ */
+
+namespace
+{
+
+// Временный каталог с файлами, удаляется после теста
+class StaticFileHandlerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char pattern[] = "/tmp/static-test-XXXXXX";
+        ASSERT_NE(::mkdtemp(pattern), nullptr);
+        root_ = pattern;
+        ::mkdir((root_ + "/css").c_str(), 0755);
+        write("/index.html", "<h1>home</h1>");
+        write("/css/app.css", "body{}");
+    }
+
+    void TearDown() override
+    {
+        std::system(("rm -rf " + root_).c_str());
+    }
+
+    void write(const std::string& name, const std::string& content)
+    {
+        std::ofstream(root_ + name, std::ios::binary) << content;
+    }
+
+    SimpleResponse get(StaticFileHandler& handler, const std::string& path,
+                       const std::map<std::string, std::string>& headers = {})
+    {
+        SimpleRequest req("GET", path, "", "127.0.0.1", 80, headers);
+        SimpleResponse res;
+        handler.handle(req, res);
+        return res;
+    }
+
+    std::string root_;
+};
+
+} // namespace
+
+// Файл отдаётся с Content-Type, ETag и Last-Modified
+TEST_F(StaticFileHandlerTest, ServesFile)
+{
+    StaticFileHandler handler("/static", root_);
+
+    auto res = get(handler, "/static/css/app.css");
+
+    EXPECT_EQ(res.getStatus(), 200);
+    EXPECT_EQ(res.getBody(), "body{}");
+    EXPECT_EQ(res.getHeaders()["Content-Type"], "text/css; charset=utf-8");
+    EXPECT_FALSE(res.getHeaders()["ETag"].empty());
+    EXPECT_NE(res.getHeaders()["Last-Modified"].find("GMT"), std::string::npos);
+}
+
+// Каталог отдаёт index.html
+TEST_F(StaticFileHandlerTest, ServesIndex)
+{
+    StaticFileHandler handler("/static", root_);
+
+    EXPECT_EQ(get(handler, "/static/").getBody(), "<h1>home</h1>");
+    EXPECT_EQ(get(handler, "/static").getBody(), "<h1>home</h1>");
+}
+
+// Несуществующий файл, каталог и выход за root - 404
+TEST_F(StaticFileHandlerTest, RejectsMissingAndTraversal)
+{
+    StaticFileHandler handler("/static", root_);
+
+    EXPECT_EQ(get(handler, "/static/missing.txt").getStatus(), 404);
+    EXPECT_EQ(get(handler, "/static/css").getStatus(), 404);
+    EXPECT_EQ(get(handler, "/static/../etc/passwd").getStatus(), 404);
+    EXPECT_EQ(get(handler, "/static/css/../../x").getStatus(), 404);
+    EXPECT_EQ(get(handler, "/staticfoo").getStatus(), 404);
+}
+
+// Путь percent-декодируется до поиска файла и проверки ".."
+TEST_F(StaticFileHandlerTest, DecodesPercentEncodedPath)
+{
+    write("/my file+1.txt", "spaced");
+    StaticFileHandler handler("/static", root_);
+
+    EXPECT_EQ(get(handler, "/static/my%20file+1.txt").getBody(), "spaced");
+    EXPECT_EQ(get(handler, "/static/css%2Fapp.css").getBody(), "body{}");
+    EXPECT_EQ(get(handler, "/static/my%20file+1.txt?v=2").getBody(), "spaced");
+    EXPECT_EQ(get(handler, "/static/%2e%2e/etc/passwd").getStatus(), 404);
+    EXPECT_EQ(get(handler, "/static/css/%2E%2E%2F%2E%2E%2Fx").getStatus(), 404);
+    EXPECT_EQ(get(handler, "/static/app%00.css").getStatus(), 404);
+    EXPECT_EQ(get(handler, "/static/bad%zz").getStatus(), 404);
+}
+
+// Совпавший ETag или дата изменения - 304 без тела
+TEST_F(StaticFileHandlerTest, ConditionalRequests)
+{
+    StaticFileHandler handler("/static", root_);
+    auto first = get(handler, "/static/css/app.css");
+    std::string etag = first.getHeaders()["ETag"];
+    std::string lastModified = first.getHeaders()["Last-Modified"];
+
+    auto byEtag = get(handler, "/static/css/app.css", {{"if-none-match", "\"x\", " + etag}});
+    EXPECT_EQ(byEtag.getStatus(), 304);
+    EXPECT_EQ(byEtag.getBody(), "");
+
+    auto byDate = get(handler, "/static/css/app.css", {{"If-Modified-Since", lastModified}});
+    EXPECT_EQ(byDate.getStatus(), 304);
+
+    auto changed = get(handler, "/static/css/app.css", {{"If-None-Match", "\"other\""}});
+    EXPECT_EQ(changed.getStatus(), 200);
+    EXPECT_EQ(changed.getBody(), "body{}");
+}
+
+// MIME-типы по расширению
+TEST(StaticFileHandlerContentTypeTest, ByExtension)
+{
+    EXPECT_EQ(StaticFileHandler::contentType("/a/b.JSON"), "application/json");
+    EXPECT_EQ(StaticFileHandler::contentType("/a/b.js"), "application/javascript");
+    EXPECT_EQ(StaticFileHandler::contentType("/a.dir/file"), "application/octet-stream");
+    EXPECT_EQ(StaticFileHandler::contentType("/a/b.unknown"), "application/octet-stream");
+}
+
+// Кэш отдаёт тот же дескриптор и вытесняет давно не использованные файлы
+TEST_F(StaticFileHandlerTest, CacheReusesAndEvicts)
+{
+    OpenFileCache cache(1);
+
+    auto index = cache.open(root_ + "/index.html");
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(cache.open(root_ + "/index.html"), index);
+    EXPECT_EQ(cache.size(), 1u);
+
+    auto css = cache.open(root_ + "/css/app.css");
+    ASSERT_NE(css, nullptr);
+    EXPECT_EQ(cache.size(), 1u);
+
+    // Вытесненный файл остаётся открытым, пока на него есть ссылка
+    char byte = 0;
+    EXPECT_EQ(::pread(index->fd, &byte, 1, 0), 1);
+    EXPECT_EQ(byte, '<');
+
+    EXPECT_EQ(cache.open(root_ + "/css"), nullptr);
+    EXPECT_EQ(cache.open(root_ + "/missing"), nullptr);
+}
+
+// Изменённый файл переоткрывается после истечения validity
+TEST_F(StaticFileHandlerTest, CacheRevalidatesChangedFile)
+{
+    OpenFileCache cache(8, std::chrono::seconds(1));
+    auto now = OpenFileCache::Clock::now();
+
+    auto before = cache.open(root_ + "/index.html", now);
+    ASSERT_NE(before, nullptr);
+
+    write("/index.html", "<h1>changed home</h1>");
+    EXPECT_EQ(cache.open(root_ + "/index.html", now), before);
+
+    auto after = cache.open(root_ + "/index.html", now + std::chrono::seconds(2));
+    ASSERT_NE(after, nullptr);
+    EXPECT_NE(after, before);
+    EXPECT_EQ(after->size(), std::string("<h1>changed home</h1>").size());
+}
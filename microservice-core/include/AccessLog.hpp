@@ -0,0 +1,176 @@
+#pragma once
+
+#include "IEnvironment.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file AccessLog.hpp
+ * @brief Двоичный журнал доступа: записи фиксированного размера в mmap-файле
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @struct AccessRecord
+ * @brief Одна запись журнала доступа, 128 байт без указателей
+ *
+ * Записывается в файл как есть (порядок байт машины), поэтому читать
+ * файл нужно на той же архитектуре. Строковые поля обрезаются и не
+ * обязаны заканчиваться нулём.
+ */
+struct AccessRecord
+{
+    /// Фазы обработки запроса, длительность каждой - в phaseUs
+    enum Phase : std::size_t
+    {
+        Read,   ///< Чтение заголовков и тела
+        Route,  ///< Поиск обработчика
+        Handle, ///< Обработчик
+        Write,  ///< Отправка ответа
+        PhaseCount
+    };
+
+    std::uint64_t timeNs;                 ///< Начало обработки, нс от эпохи UNIX; 0 - конец данных
+    std::uint64_t bytesIn;                ///< Тело запроса (для потокового тела - Content-Length)
+    std::uint64_t bytesOut;               ///< Тело ответа
+    std::uint32_t phaseUs[PhaseCount];    ///< Длительность фаз, мкс; 0 - не измерялась
+    std::uint16_t status;
+    std::uint8_t ipVersion;               ///< 4 или 6, 0 - адрес неизвестен
+    std::uint8_t reserved;
+    std::uint8_t address[16];             ///< Адрес клиента в сетевом порядке байт
+    char methodName[8];
+    char routePattern[60];                ///< Паттерн маршрута, пусто - маршрут не найден
+
+    void setMethod(std::string_view method);
+    void setRoute(std::string_view pattern);
+
+    /**
+     * @brief Разобрать текстовый IPv4/IPv6 адрес (неразобранный - ipVersion = 0)
+     */
+    void setIp(std::string_view ip);
+
+    std::string_view method() const;
+    std::string_view route() const;
+    std::string ip() const;
+};
+
+static_assert(sizeof(AccessRecord) == 128, "AccessRecord is a fixed-size file record");
+static_assert(std::is_trivially_copyable_v<AccessRecord>, "AccessRecord is copied as raw bytes");
+
+/**
+ * @class AccessLog
+ * @brief Журнал доступа, запись в который не блокирует обработку запросов
+ *
+ * Как и Logger, каждый поток кладёт записи в собственный кольцевой буфер
+ * без блокировок, а фоновый поток копирует их в файл, отображённый в
+ * память (mmap): ни форматирования, ни системных вызовов на запрос.
+ * Переполненный буфер потока отбрасывает запись и учитывает её в dropped().
+ *
+ * Файл начинается с заголовка (64 байта, сигнатура "MSACCLOG"), за ним
+ * идут записи. Файл создаётся сразу размера maxFileSize; заполненный файл
+ * обрезается по последней записи и переименовывается в path.1 (path.1 -
+ * в path.2 и т.д., старше maxFiles - удаляются), запись продолжается в
+ * новый path.
+ *
+ * Выборка: записывается каждый sample-й запрос потока, ответы 5xx -
+ * всегда.
+ */
+class AccessLog
+{
+public:
+    static constexpr std::size_t headerSize = 64;
+    static constexpr std::string_view signature = "MSACCLOG";
+
+    struct Options
+    {
+        std::string path;                             ///< Пусто - журнал выключен
+        std::uint64_t maxFileSize = 64 * 1024 * 1024; ///< Размер одного файла, байты
+        int maxFiles = 5;                             ///< Текущий и ротированные файлы
+        int sample = 1;                               ///< Записывать каждый N-й запрос
+
+        /**
+         * @brief Прочитать access_log.path, access_log.max_file_size,
+         * access_log.max_files и access_log.sample
+         * @throws std::runtime_error для недопустимых значений
+         */
+        static Options fromEnvironment(const IEnvironment& env);
+    };
+
+    /**
+     * @throws std::runtime_error если файл не удалось создать
+     */
+    explicit AccessLog(Options options);
+
+    /**
+     * @brief Дописывает оставшиеся записи и обрезает файл
+     */
+    ~AccessLog();
+
+    AccessLog(const AccessLog&) = delete;
+    AccessLog& operator=(const AccessLog&) = delete;
+
+    /**
+     * @brief Записать запрос с учётом выборки (из любого потока)
+     */
+    void record(const AccessRecord& record);
+
+    /**
+     * @brief Дождаться записи в файл всего, что передано до вызова
+     */
+    void flush();
+
+    /**
+     * @brief Число записей, отброшенных из-за переполнения буферов или ошибок файла
+     */
+    std::uint64_t dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Прочитать записи файла журнала
+     * @throws std::runtime_error если файл не открывается или это не журнал доступа
+     */
+    static std::vector<AccessRecord> read(const std::string& path);
+
+    /**
+     * @brief Строка вида "2026-10-18T06:22:45.388123Z 10.0.0.1 GET /users/{id} 200 in=0 out=42 ..."
+     */
+    static std::string toText(const AccessRecord& record);
+
+    /**
+     * @brief Объект JSON в одну строку
+     */
+    static std::string toJson(const AccessRecord& record);
+
+private:
+    class Ring;
+    class File;
+
+    Ring& threadRing();
+    void run();
+
+    Options options_;
+    const std::uint64_t id_; ///< Отличает буферы потоков разных журналов
+    std::unique_ptr<File> file_;
+    std::atomic<std::uint64_t> dropped_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable flushed_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::uint64_t flushRequested_ = 0;
+    std::uint64_t flushDone_ = 0;
+    bool stopping_ = false;
+
+    std::thread thread_;
+};
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @file AdmissionControl.hpp
+ * @brief Ограничение числа одновременных соединений и запросов
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class AdmissionControl
+ * @brief Счётчики соединений и запросов в обработке с верхними границами
+ *
+ * Захват слота - один атомарный инкремент, без блокировок. Слот
+ * возвращается автоматически при уничтожении токена Slot.
+ *
+ * Для режима "пауза" (не принимать соединения, пока нет свободного слота)
+ * есть acquireConnectionOrWait(): если слота нет, функция resume будет
+ * вызвана один раз после освобождения любого соединения.
+ *
+ * Лимит 0 означает "без ограничения", счётчики при этом всё равно ведутся.
+ */
+class AdmissionControl
+{
+public:
+    /**
+     * @class Slot
+     * @brief RAII-токен занятого слота (move-only)
+     */
+    class Slot
+    {
+    public:
+        Slot() = default;
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+
+        Slot(Slot&& other) noexcept
+            : owner_(std::exchange(other.owner_, nullptr)), connection_(other.connection_)
+        {
+        }
+
+        Slot& operator=(Slot&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                owner_ = std::exchange(other.owner_, nullptr);
+                connection_ = other.connection_;
+            }
+            return *this;
+        }
+
+        ~Slot()
+        {
+            reset();
+        }
+
+        explicit operator bool() const { return owner_ != nullptr; }
+
+        /**
+         * @brief Вернуть слот досрочно
+         */
+        void reset()
+        {
+            if (owner_)
+            {
+                if (connection_)
+                {
+                    owner_->releaseConnection();
+                }
+                else
+                {
+                    owner_->releaseRequest();
+                }
+                owner_ = nullptr;
+            }
+        }
+
+    private:
+        friend class AdmissionControl;
+        Slot(AdmissionControl* owner, bool connection) : owner_(owner), connection_(connection) {}
+
+        AdmissionControl* owner_ = nullptr;
+        bool connection_ = false;
+    };
+
+    AdmissionControl() = default;
+    AdmissionControl(const AdmissionControl&) = delete;
+    AdmissionControl& operator=(const AdmissionControl&) = delete;
+
+    /**
+     * @brief Установить лимиты (до начала приёма соединений)
+     * @param maxConnections Максимум одновременных соединений, 0 - без ограничения
+     * @param maxInflight Максимум запросов в обработке, 0 - без ограничения
+     */
+    void setLimits(std::size_t maxConnections, std::size_t maxInflight)
+    {
+        maxConnections_ = maxConnections;
+        maxInflight_ = maxInflight;
+    }
+
+    /**
+     * @brief Занять слот соединения
+     * @return Пустой токен, если лимит исчерпан
+     */
+    Slot tryAcquireConnection()
+    {
+        return tryIncrement(connections_, maxConnections_) ? Slot(this, true) : Slot();
+    }
+
+    /**
+     * @brief Занять слот соединения или подписаться на его освобождение
+     * @param resume Вызывается один раз (из потока, освободившего слот),
+     *               если сейчас слота нет; после вызова нужно повторить попытку
+     * @return Занятый токен или пустой токен, если resume зарегистрирован
+     */
+    Slot acquireConnectionOrWait(std::function<void()> resume)
+    {
+        std::lock_guard<std::mutex> lock(waitersMutex_);
+        // Сначала объявляем ожидание, потом пробуем: так освобождение слота
+        // между неудачной попыткой и регистрацией не теряется
+        waiting_.fetch_add(1);
+        if (tryIncrement(connections_, maxConnections_))
+        {
+            waiting_.fetch_sub(1);
+            return Slot(this, true);
+        }
+        waiters_.push_back(std::move(resume));
+        return Slot();
+    }
+
+    /**
+     * @brief Занять слот запроса в обработке
+     * @return Пустой токен, если лимит исчерпан
+     */
+    Slot tryAcquireRequest()
+    {
+        return tryIncrement(inflight_, maxInflight_) ? Slot(this, false) : Slot();
+    }
+
+    /**
+     * @brief Забыть все ожидающие resume (при остановке сервера)
+     */
+    void clearWaiters()
+    {
+        std::lock_guard<std::mutex> lock(waitersMutex_);
+        waiting_.fetch_sub(waiters_.size());
+        waiters_.clear();
+    }
+
+    std::size_t connections() const { return connections_.load(std::memory_order_relaxed); }
+    std::size_t inflight() const { return inflight_.load(std::memory_order_relaxed); }
+
+private:
+    static bool tryIncrement(std::atomic<std::size_t>& counter, std::size_t limit)
+    {
+        if (limit == 0)
+        {
+            counter.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        std::size_t current = counter.load();
+        while (current < limit)
+        {
+            if (counter.compare_exchange_weak(current, current + 1))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void releaseConnection()
+    {
+        connections_.fetch_sub(1);
+
+        if (waiting_.load() == 0)
+        {
+            return;
+        }
+
+        std::function<void()> resume;
+        {
+            std::lock_guard<std::mutex> lock(waitersMutex_);
+            if (waiters_.empty())
+            {
+                return;
+            }
+            resume = std::move(waiters_.back());
+            waiters_.pop_back();
+            waiting_.fetch_sub(1);
+        }
+        resume();
+    }
+
+    void releaseRequest()
+    {
+        inflight_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::size_t maxConnections_ = 0;
+    std::size_t maxInflight_ = 0;
+    std::atomic<std::size_t> connections_{0};
+    std::atomic<std::size_t> inflight_{0};
+
+    std::mutex waitersMutex_;
+    std::atomic<std::size_t> waiting_{0};
+    std::vector<std::function<void()>> waiters_;
+};
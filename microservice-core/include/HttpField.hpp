@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @file HttpField.hpp
+ * @brief Часто читаемые заголовки HTTP
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @enum HttpField
+ * @brief Заголовки, которые middleware читает на каждый запрос
+ *
+ * Имя заголовка проверяет компилятор, а не тест: опечатка в строке
+ * "Authorizaton" молча даёт пустое значение. Остальные заголовки читают
+ * по имени через IRequest::header(std::string_view).
+ */
+enum class HttpField : std::uint8_t
+{
+    Accept,
+    AcceptEncoding,
+    Authorization,
+    CacheControl,
+    Connection,
+    ContentLength,
+    ContentType,
+    Cookie,
+    Host,
+    IfModifiedSince,
+    IfNoneMatch,
+    Origin,
+    Range,
+    Referer,
+    Traceparent,
+    UserAgent,
+    XForwardedFor,
+    XRequestId
+};
+
+/**
+ * @brief Каноническое имя заголовка
+ */
+constexpr std::string_view httpFieldName(HttpField field)
+{
+    switch (field)
+    {
+    case HttpField::Accept: return "Accept";
+    case HttpField::AcceptEncoding: return "Accept-Encoding";
+    case HttpField::Authorization: return "Authorization";
+    case HttpField::CacheControl: return "Cache-Control";
+    case HttpField::Connection: return "Connection";
+    case HttpField::ContentLength: return "Content-Length";
+    case HttpField::ContentType: return "Content-Type";
+    case HttpField::Cookie: return "Cookie";
+    case HttpField::Host: return "Host";
+    case HttpField::IfModifiedSince: return "If-Modified-Since";
+    case HttpField::IfNoneMatch: return "If-None-Match";
+    case HttpField::Origin: return "Origin";
+    case HttpField::Range: return "Range";
+    case HttpField::Referer: return "Referer";
+    case HttpField::Traceparent: return "traceparent";
+    case HttpField::UserAgent: return "User-Agent";
+    case HttpField::XForwardedFor: return "X-Forwarded-For";
+    case HttpField::XRequestId: return "X-Request-ID";
+    }
+    return {};
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @file HttpMethod.hpp
+ * @brief Перечисление стандартных HTTP методов
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @enum HttpMethod
+ * @brief Стандартные методы HTTP/1.1 (RFC 9110, RFC 5789)
+ *
+ * Позволяет индексировать таблицы маршрутов методом вместо сравнения
+ * строк. Остальные методы (WebDAV и т.п.) - Other, их маршрутизируют по
+ * имени.
+ */
+enum class HttpMethod : std::uint8_t
+{
+    Get,
+    Head,
+    Post,
+    Put,
+    Delete,
+    Connect,
+    Options,
+    Trace,
+    Patch,
+    Other
+};
+
+/// Число стандартных методов (без Other)
+constexpr std::size_t kHttpMethodCount = static_cast<std::size_t>(HttpMethod::Other);
+
+/**
+ * @brief Метод по имени (с учётом регистра, как в HTTP)
+ */
+constexpr HttpMethod parseHttpMethod(std::string_view name)
+{
+    switch (name.size())
+    {
+    case 3:
+        if (name == "GET") return HttpMethod::Get;
+        if (name == "PUT") return HttpMethod::Put;
+        break;
+    case 4:
+        if (name == "POST") return HttpMethod::Post;
+        if (name == "HEAD") return HttpMethod::Head;
+        break;
+    case 5:
+        if (name == "PATCH") return HttpMethod::Patch;
+        if (name == "TRACE") return HttpMethod::Trace;
+        break;
+    case 6:
+        if (name == "DELETE") return HttpMethod::Delete;
+        break;
+    case 7:
+        if (name == "OPTIONS") return HttpMethod::Options;
+        if (name == "CONNECT") return HttpMethod::Connect;
+        break;
+    default:
+        break;
+    }
+    return HttpMethod::Other;
+}
+
+/**
+ * @brief Имя стандартного метода ("" для Other)
+ */
+constexpr std::string_view httpMethodName(HttpMethod method)
+{
+    switch (method)
+    {
+    case HttpMethod::Get: return "GET";
+    case HttpMethod::Head: return "HEAD";
+    case HttpMethod::Post: return "POST";
+    case HttpMethod::Put: return "PUT";
+    case HttpMethod::Delete: return "DELETE";
+    case HttpMethod::Connect: return "CONNECT";
+    case HttpMethod::Options: return "OPTIONS";
+    case HttpMethod::Trace: return "TRACE";
+    case HttpMethod::Patch: return "PATCH";
+    case HttpMethod::Other: break;
+    }
+    return {};
+}
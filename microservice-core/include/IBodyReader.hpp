@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
+
+/**
+ * @file IBodyReader.hpp
+ * @brief Интерфейс потокового чтения тела HTTP запроса
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class IBodyReader
+ * @brief Тело запроса, читаемое порциями по мере поступления из сокета
+ *
+ * Позволяет обработать загрузку любого размера в постоянной памяти.
+ * Ошибки чтения (обрыв соединения, превышение лимита тела, истёкший
+ * срок) выбрасываются исключением.
+ */
+class IBodyReader
+{
+public:
+    virtual ~IBodyReader() = default;
+
+    /**
+     * @brief Прочитать очередную порцию тела
+     * @param data Буфер для данных
+     * @param size Размер буфера
+     * @return Число прочитанных байт, 0 - тело закончилось
+     */
+    virtual std::size_t read(char* data, std::size_t size) = 0;
+
+    /**
+     * @brief Размер тела из Content-Length (нет значения для chunked)
+     */
+    virtual std::optional<std::uint64_t> contentLength() const = 0;
+};
+
+/**
+ * @class StringBodyReader
+ * @brief IBodyReader поверх уже прочитанного тела
+ */
+class StringBodyReader : public IBodyReader
+{
+public:
+    explicit StringBodyReader(std::string body) : body_(std::move(body)) {}
+
+    std::size_t read(char* data, std::size_t size) override
+    {
+        std::size_t n = std::min(size, body_.size() - offset_);
+        std::memcpy(data, body_.data() + offset_, n);
+        offset_ += n;
+        return n;
+    }
+
+    std::optional<std::uint64_t> contentLength() const override
+    {
+        return body_.size();
+    }
+
+private:
+    std::string body_;
+    std::size_t offset_ = 0;
+};
@@ -2,6 +2,7 @@
 
 #include "IRequest.hpp"
 #include "IResponse.hpp"
+#include <cstdint>
 
 /**
  * @file IHttpHandler.hpp
@@ -27,4 +28,25 @@ public:
      * @param res HTTP ответ
      */
     virtual void handle(IRequest& req, IResponse& res) = 0;
+
+    /**
+     * @brief Лимит тела запроса для маршрута в байтах
+     * @return 0 - использовать server.max_body_size
+     */
+    virtual std::uint64_t maxBodySize() const
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Обработчик пишет ответ порциями (IResponse::write)
+     *
+     * Асинхронные режимы сервера выполняют такой обработчик в пуле
+     * server.blocking_threads: запись ждёт медленного клиента, не занимая
+     * поток io_context.
+     */
+    virtual bool streamsResponse() const
+    {
+        return false;
+    }
 };
\ No newline at end of file
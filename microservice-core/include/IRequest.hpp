@@ -1,6 +1,15 @@
 #pragma once
+#include "HttpField.hpp"
+#include "PathParams.hpp"
+#include "RequestTiming.hpp"
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <map>
+#include <memory_resource>
 
 /**
  * @file IRequest.hpp
@@ -8,6 +17,14 @@
  * @author Anton Tobolkin
  */
 struct IRequest {
+    IRequest() = default;
+    // Копии для view-методов по умолчанию не переносятся: они ссылаются на свой запрос
+    IRequest(const IRequest&) {}
+    IRequest& operator=(const IRequest&)
+    {
+        views_.reset();
+        return *this;
+    }
     virtual ~IRequest() = default;
 
     /**
@@ -23,13 +40,132 @@ struct IRequest {
      */
     virtual std::string getBody() const = 0;
 
+    /**
+     * @brief Путь запроса без query string, без копирования
+     *
+     * View-методы действительны, пока жив запрос. Реализации, которые
+     * хранят запрос целиком, переопределяют их. Реализация по умолчанию
+     * один раз копирует getPath()/getBody()/getHeaders() в запрос и
+     * отдаёт view в эти копии: она работает с любым IRequest, но не видит
+     * изменений запроса после первого вызова.
+     */
+    virtual std::string_view path() const
+    {
+        const std::string& full = views().path(*this);
+        return std::string_view(full).substr(0, full.find('?'));
+    }
+
+    /**
+     * @brief Тело запроса без копирования
+     */
+    virtual std::string_view body() const
+    {
+        return views().body(*this);
+    }
+
+    /**
+     * @brief Значение заголовка без копирования, имя без учёта регистра
+     * @return Пустая строка, если заголовка нет
+     */
+    virtual std::string_view header(std::string_view name) const
+    {
+        for (const auto& [key, value] : views().headers(*this))
+        {
+            if (equalsIgnoreCase(key, name))
+            {
+                return value;
+            }
+        }
+        return {};
+    }
+
+    /**
+     * @brief Значение заголовка из HttpField, без копирования
+     *
+     * Наследники, переопределяющие header(std::string_view), добавляют
+     * using IRequest::header, чтобы не скрыть эту перегрузку.
+     */
+    std::string_view header(HttpField field) const
+    {
+        return header(httpFieldName(field));
+    }
+
     /**
      * @brief Получить параметры запроса в виде ключ-значение
+     *
+     * Строит map на каждый вызов; для одного параметра - param().
      */
     virtual std::map<std::string, std::string> getParams() const = 0;
 
+    /**
+     * @brief Значение параметра query string, percent-декодированное
+     *
+     * Реализация по умолчанию ищет ключ в getParams() (копия снимается
+     * один раз, значения - как их вернул getParams()).
+     *
+     * @return nullopt, если параметра нет; при повторе ключа - первое значение
+     */
+    virtual std::optional<std::string_view> param(std::string_view name) const
+    {
+        const auto& params = views().params(*this);
+        auto it = params.find(std::string(name));
+        if (it == params.end())
+        {
+            return std::nullopt;
+        }
+        return std::string_view(it->second);
+    }
+
+    /**
+     * @brief Получить сегменты пути, захваченные маршрутом ({id}, {id:int})
+     *
+     * Значения - string_view в путь запроса, действительны во время обработки.
+     */
+    virtual const PathParams& getPathParams() const
+    {
+        static const PathParams empty;
+        return empty;
+    }
+
+    /**
+     * @brief Получить сегмент пути по имени из паттерна маршрута
+     * @return Пустая строка, если маршрут не захватывал такой сегмент
+     */
+    std::string_view getPathParam(std::string_view name) const
+    {
+        return getPathParams().get(name);
+    }
+
+    /**
+     * @brief Память для временных данных обработчика на время запроса
+     *
+     * Сервер отдаёт арену запроса: выделение - сдвиг указателя, всё
+     * освобождается разом после ответа. Объекты из неё нельзя хранить
+     * дольше запроса. По умолчанию - обычная куча.
+     *
+     * @code
+     * std::pmr::vector<Item> items(req.arena());
+     * std::pmr::string scratch(req.arena());
+     * @endcode
+     */
+    virtual std::pmr::memory_resource* arena() const
+    {
+        return std::pmr::get_default_resource();
+    }
+
+    /**
+     * @brief Отметки времени этапов запроса (чтение, поиск маршрута, ...)
+     * @return nullptr, если реализация их не ведёт
+     */
+    virtual const RequestTiming* timing() const
+    {
+        return nullptr;
+    }
+
     /**
      * @brief Получить HTTP-заголовки запроса
+     *
+     * Копирует все поля в map на каждый вызов; для одного заголовка - header().
      */
     virtual std::map<std::string, std::string> getHeaders() const = 0;
 
@@ -42,4 +178,75 @@ struct IRequest {
      * @brief Получить порт (для входящих - 80 по умолчанию, для исходящих - целевой порт)
      */
     virtual int getPort() const = 0;
+
+private:
+    /**
+     * @brief Копии полей запроса для view-методов по умолчанию
+     *
+     * Заполняются при первом обращении; реализации, переопределившие
+     * view-методы, не платят ни памятью, ни выделениями.
+     */
+    class Views
+    {
+    public:
+        const std::string& path(const IRequest& req)
+        {
+            if (!path_)
+            {
+                path_ = req.getPath();
+            }
+            return *path_;
+        }
+
+        const std::string& body(const IRequest& req)
+        {
+            if (!body_)
+            {
+                body_ = req.getBody();
+            }
+            return *body_;
+        }
+
+        const std::map<std::string, std::string>& headers(const IRequest& req)
+        {
+            if (!headers_)
+            {
+                headers_ = req.getHeaders();
+            }
+            return *headers_;
+        }
+
+        const std::map<std::string, std::string>& params(const IRequest& req)
+        {
+            if (!params_)
+            {
+                params_ = req.getParams();
+            }
+            return *params_;
+        }
+
+    private:
+        std::optional<std::string> path_;
+        std::optional<std::string> body_;
+        std::optional<std::map<std::string, std::string>> headers_;
+        std::optional<std::map<std::string, std::string>> params_;
+    };
+
+    Views& views() const
+    {
+        if (!views_)
+        {
+            views_ = std::make_unique<Views>();
+        }
+        return *views_;
+    }
+
+    static bool equalsIgnoreCase(std::string_view a, std::string_view b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                   return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+               });
+    }
+
+    mutable std::unique_ptr<Views> views_; ///< Не потокобезопасно, как и сам запрос
 };
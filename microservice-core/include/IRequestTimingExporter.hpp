@@ -0,0 +1,32 @@
+#pragma once
+
+#include "RequestTiming.hpp"
+#include <string_view>
+
+/**
+ * @file IRequestTimingExporter.hpp
+ * @brief Интерфейс получателя отметок времени обработанных запросов
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class IRequestTimingExporter
+ * @brief Получает отметки каждого запроса после отправки ответа
+ *
+ * Вызывается в потоке сессии для каждого обслуженного запроса, поэтому
+ * реализация должна быть потокобезопасной и быстрой: тяжёлую работу -
+ * в свой фоновый поток.
+ */
+class IRequestTimingExporter
+{
+public:
+    virtual ~IRequestTimingExporter() = default;
+
+    /**
+     * @param method Метод запроса
+     * @param route Паттерн найденного маршрута, пусто - маршрут не найден
+     * @param status Код ответа
+     */
+    virtual void exportTiming(const RequestTiming& timing, std::string_view method,
+                              std::string_view route, int status) = 0;
+};
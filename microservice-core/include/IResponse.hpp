@@ -1,5 +1,11 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 
 /**
  * @file IResponse.hpp
@@ -18,9 +24,85 @@ struct IResponse {
      */
     virtual void setBody(const std::string& body) = 0;
 
+    /**
+     * @brief Установить тело ответа, забрав строку без копирования
+     *
+     * res.setBody(json.dump()) переносит готовую строку в ответ. Наследники,
+     * переопределяющие только setBody(const std::string&), добавляют
+     * using IResponse::setBody. По умолчанию - копия.
+     */
+    virtual void setBody(std::string&& body)
+    {
+        setBody(static_cast<const std::string&>(body));
+    }
+
+    /**
+     * @brief Зарезервировать память под тело, которое будет дописано appendBody()
+     */
+    virtual void reserveBody(std::size_t bytes)
+    {
+        (void)bytes;
+    }
+
+    /**
+     * @brief Дописать данные в конец тела ответа
+     *
+     * В отличие от write(), ничего не отправляет: ответ уходит целиком
+     * с Content-Length после handle(). Вместе с reserveBody() позволяет
+     * строить большое тело прямо в ответе, без промежуточной строки.
+     */
+    virtual void appendBody(std::string_view data)
+    {
+        (void)data;
+        throw std::logic_error("IResponse: appendBody is not supported");
+    }
+
+    /**
+     * @brief Тело ответа - общий неизменяемый буфер
+     *
+     * Один и тот же буфер (закэшированный ответ, справочник) может
+     * отдаваться многими запросами одновременно: сервер отправляет его из
+     * буфера, не копируя в ответ, и держит ссылку до конца отправки.
+     * Реализация по умолчанию копирует буфер через setBody(); nullptr -
+     * пустое тело.
+     */
+    virtual void setSharedBody(std::shared_ptr<const std::string> body)
+    {
+        setBody(body ? *body : std::string());
+    }
+
     /**
      * @brief Установить заголовок ответа
      */
     virtual void setHeader(const std::string& name, const std::string& value) = 0;
 
+    /**
+     * @brief Отправить очередную порцию тела, не дожидаясь конца ответа
+     *
+     * Первый вызов отправляет статус и заголовки (chunked transfer encoding),
+     * после него setStatus/setHeader/setBody не действуют. Память не растёт с
+     * размером ответа: в режиме thread и для обработчиков со streamsResponse()
+     * вызов ждёт, пока клиент примет данные; на потоках io_context данные
+     * копятся до 256 КиБ, дальше вызов тоже ждёт клиента, занимая поток.
+     */
+    virtual void write(std::string_view chunk)
+    {
+        (void)chunk;
+        throw std::logic_error("IResponse: streaming is not supported");
+    }
+
+    /**
+     * @brief Завершить потоковый ответ (иначе его завершит сервер после handle())
+     */
+    virtual void end() {}
+
+    /**
+     * @brief Тело ответа - первые size байт открытого файла
+     *
+     * Сервер отправляет файл через sendfile(2), не копируя его в user space,
+     * и сам выставляет Content-Length. Дескриптор не закрывается, пока на него
+     * есть ссылки (кэш открытых файлов может отдать тот же fd другим запросам).
+     * Реализация по умолчанию читает файл в тело через setBody().
+     */
+    virtual void setFileBody(std::shared_ptr<const int> fd, std::uint64_t size);
 };
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "IBodyReader.hpp"
+#include "IHttpHandler.hpp"
+
+/**
+ * @file IStreamingHttpHandler.hpp
+ * @brief Интерфейс обработчика с потоковым чтением тела запроса
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class IStreamingHttpHandler
+ * @brief Обработчик, который читает тело запроса порциями
+ *
+ * Сервер читает заголовки, проверяет Content-Length по maxBodySize()
+ * маршрута и вызывает handleStream(), не буферизуя тело: req.getBody()
+ * при этом пуст. Регистрируется в handlers_ так же, как обычный IHttpHandler.
+ */
+class IStreamingHttpHandler : public IHttpHandler
+{
+public:
+    /**
+     * @brief Обработать HTTP запрос с потоковым телом
+     * @param req HTTP запрос (без тела)
+     * @param body Тело запроса
+     * @param res HTTP ответ
+     */
+    virtual void handleStream(IRequest& req, IBodyReader& body, IResponse& res) = 0;
+
+    /**
+     * @brief Вызов с уже прочитанным телом (например, из тестов или HttpClient)
+     */
+    void handle(IRequest& req, IResponse& res) override
+    {
+        StringBodyReader body(req.getBody());
+        handleStream(req, body, res);
+    }
+};
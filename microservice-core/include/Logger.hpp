@@ -0,0 +1,247 @@
+#pragma once
+
+#include "IEnvironment.hpp"
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @file Logger.hpp
+ * @brief Асинхронный журнал: кольцевые буферы потоков и фоновая запись
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @enum LogLevel
+ * @brief Уровень сообщения журнала
+ */
+enum class LogLevel : std::uint8_t
+{
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+/**
+ * @brief Уровень, ниже которого сообщения удаляются при компиляции
+ *
+ * Задаётся числом -DMICROSERVICE_LOG_MIN_LEVEL=N (0 - Trace ... 4 - Error),
+ * по умолчанию 1 (Debug): вызовы MS_LOG_TRACE не попадают в код.
+ */
+#ifndef MICROSERVICE_LOG_MIN_LEVEL
+#define MICROSERVICE_LOG_MIN_LEVEL 1
+#endif
+
+constexpr LogLevel kMinLogLevel = static_cast<LogLevel>(MICROSERVICE_LOG_MIN_LEVEL);
+
+/**
+ * @brief Имя уровня: "trace", "debug", "info", "warn", "error", "off"
+ */
+constexpr std::string_view logLevelName(LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel::Trace: return "trace";
+    case LogLevel::Debug: return "debug";
+    case LogLevel::Info: return "info";
+    case LogLevel::Warn: return "warn";
+    case LogLevel::Error: return "error";
+    case LogLevel::Off: return "off";
+    }
+    return {};
+}
+
+/**
+ * @class LogLine
+ * @brief Сообщение фиксированной длины, собираемое без выделения памяти
+ *
+ * Не поместившийся хвост отбрасывается, последним символом ставится '~'.
+ */
+class LogLine
+{
+public:
+    static constexpr std::size_t capacity = 232;
+
+    void append(std::string_view text)
+    {
+        std::size_t room = capacity - size_;
+        if (text.size() > room)
+        {
+            text = text.substr(0, room);
+            truncated_ = true;
+        }
+        text.copy(data_.data() + size_, text.size());
+        size_ += text.size();
+        if (truncated_)
+        {
+            data_[capacity - 1] = '~';
+        }
+    }
+
+    void append(const char* text)
+    {
+        append(std::string_view(text ? text : "(null)"));
+    }
+
+    void append(const std::string& text)
+    {
+        append(std::string_view(text));
+    }
+
+    void append(char ch)
+    {
+        append(std::string_view(&ch, 1));
+    }
+
+    void append(bool value)
+    {
+        append(std::string_view(value ? "true" : "false"));
+    }
+
+    template<class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    void append(T value)
+    {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        append(std::string_view(buffer, static_cast<std::size_t>(result.ptr - buffer)));
+    }
+
+    template<class T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+    void append(T value)
+    {
+        char buffer[32];
+        int length = std::snprintf(buffer, sizeof(buffer), "%g", static_cast<double>(value));
+        append(std::string_view(buffer, length > 0 ? static_cast<std::size_t>(length) : 0));
+    }
+
+    /// Строковые типы библиотек (boost::string_view и т.п.)
+    template<class T, std::enable_if_t<!std::is_convertible_v<const T&, std::string_view> &&
+                                           std::is_convertible_v<decltype(std::declval<const T&>().data()), const char*>,
+                                       int> = 0>
+    void append(const T& text)
+    {
+        append(std::string_view(text.data(), text.size()));
+    }
+
+    std::string_view view() const
+    {
+        return std::string_view(data_.data(), size_);
+    }
+
+private:
+    std::array<char, capacity> data_;
+    std::size_t size_ = 0;
+    bool truncated_ = false;
+};
+
+/**
+ * @class Logger
+ * @brief Журнал, запись которого не блокирует обработку запросов
+ *
+ * Каждый поток пишет в собственный кольцевой буфер (один писатель - один
+ * читатель, без блокировок); фоновый поток забирает сообщения из всех
+ * буферов и выводит их пачками одним write(2): Warn и Error - в stderr,
+ * остальные - в stdout. Если буфер потока полон, сообщение отбрасывается
+ * и учитывается в dropped(): запрос не ждёт вывода.
+ *
+ * Порядок сообщений сохраняется внутри потока; сообщения разных потоков
+ * могут выводиться не по времени, поэтому у каждой строки своя метка.
+ *
+ * Уровень задаётся в IEnvironment ("logging.level", по умолчанию "info")
+ * и меняется на лету; сообщения ниже kMinLogLevel вырезаются при компиляции.
+ */
+class Logger
+{
+public:
+    /**
+     * @brief Получатель готовых строк (по умолчанию - stdout/stderr)
+     */
+    using Sink = std::function<void(LogLevel level, std::string_view lines)>;
+
+    static bool enabled(LogLevel level)
+    {
+        return level >= level_.load(std::memory_order_relaxed);
+    }
+
+    static LogLevel level()
+    {
+        return level_.load(std::memory_order_relaxed);
+    }
+
+    static void setLevel(LogLevel level)
+    {
+        level_.store(level, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Уровень по имени
+     * @throws std::runtime_error для неизвестного имени
+     */
+    static LogLevel parseLevel(std::string_view name);
+
+    /**
+     * @brief Установить уровень из "logging.level"
+     * @throws std::runtime_error для неизвестного уровня
+     */
+    static void configure(const IEnvironment& env);
+
+    /**
+     * @brief Записать сообщение из частей: строк, чисел, bool
+     */
+    template<class... Args>
+    static void log(LogLevel level, const Args&... parts)
+    {
+        LogLine line;
+        (line.append(parts), ...);
+        push(level, line);
+    }
+
+    /**
+     * @brief Дождаться вывода всех сообщений, записанных до вызова
+     */
+    static void flush();
+
+    /**
+     * @brief Заменить получателя строк (nullptr - stdout/stderr)
+     */
+    static void setSink(Sink sink);
+
+    /**
+     * @brief Число сообщений, отброшенных из-за переполнения буферов
+     */
+    static std::uint64_t dropped();
+
+private:
+    static void push(LogLevel level, const LogLine& line);
+
+    inline static std::atomic<LogLevel> level_{LogLevel::Info};
+};
+
+#define MS_LOG(level, ...)                                                  \
+    do                                                                      \
+    {                                                                       \
+        if constexpr ((level) >= kMinLogLevel)                              \
+        {                                                                   \
+            if (Logger::enabled(level))                                     \
+            {                                                               \
+                Logger::log((level), __VA_ARGS__);                          \
+            }                                                               \
+        }                                                                   \
+    } while (false)
+
+#define MS_LOG_TRACE(...) MS_LOG(LogLevel::Trace, __VA_ARGS__)
+#define MS_LOG_DEBUG(...) MS_LOG(LogLevel::Debug, __VA_ARGS__)
+#define MS_LOG_INFO(...) MS_LOG(LogLevel::Info, __VA_ARGS__)
+#define MS_LOG_WARN(...) MS_LOG(LogLevel::Warn, __VA_ARGS__)
+#define MS_LOG_ERROR(...) MS_LOG(LogLevel::Error, __VA_ARGS__)
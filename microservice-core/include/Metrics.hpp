@@ -0,0 +1,264 @@
+#pragma once
+
+#include "IEnvironment.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file Metrics.hpp
+ * @brief Метрики сервера: счётчики, гистограммы задержек и вывод для Prometheus
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @brief Номер текущего потока для выбора шарда метрик
+ *
+ * Раздаётся по порядку при первом обращении потока, поэтому потоки
+ * пула попадают в разные шарды.
+ */
+std::size_t metricsThreadIndex();
+
+/**
+ * @class Counter
+ * @brief Счётчик (или gauge) из шардов по потокам
+ *
+ * add() - одно атомарное сложение relaxed в ячейке шарда текущего потока,
+ * ячейки выровнены по кеш-линии и не делят её между потоками. Значение
+ * собирается суммированием шардов только при чтении.
+ */
+class Counter
+{
+public:
+    /**
+     * @param shards Число шардов, степень двойки
+     */
+    explicit Counter(std::size_t shards);
+
+    void add(std::int64_t delta = 1)
+    {
+        cells_[metricsThreadIndex() & mask_].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    std::int64_t value() const;
+
+private:
+    struct alignas(64) Cell
+    {
+        std::atomic<std::int64_t> value{0};
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_;
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Гистограмма задержек с логарифмическими корзинами (как HDR Histogram)
+ *
+ * Задержки до 16 нс ложатся в корзины по 1 нс, дальше каждая степень
+ * двойки делится на 8 корзин: ширина корзины - не больше 1/8 её нижней
+ * границы. Значения от 2^40 нс (~18 минут) попадают в последнюю корзину.
+ *
+ * Запись - два сложения relaxed в шарде текущего потока. Шард выделяется
+ * при первой записи в него, так что неиспользуемые сочетания маршрута и
+ * класса статуса почти не занимают памяти.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr std::size_t linearBuckets = 16;
+    static constexpr std::size_t subBuckets = 8;
+    static constexpr std::size_t maxExponent = 40;
+    static constexpr std::size_t bucketCount = linearBuckets + (maxExponent - 4) * subBuckets;
+
+    /**
+     * @brief Сумма шардов на момент чтения
+     */
+    struct Snapshot
+    {
+        std::array<std::uint64_t, bucketCount> counts{};
+        std::uint64_t count = 0;
+        std::uint64_t sumNs = 0;
+
+        /**
+         * @brief Квантиль q (0..1), нс - верхняя граница корзины, 0 - записей нет
+         */
+        std::uint64_t quantile(double q) const;
+    };
+
+    /**
+     * @param shards Число шардов, степень двойки
+     */
+    explicit LatencyHistogram(std::size_t shards);
+    ~LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(std::chrono::nanoseconds latency);
+
+    Snapshot snapshot() const;
+
+    static std::size_t bucketOf(std::uint64_t ns);
+
+    /**
+     * @brief Граница корзины: в неё попадают значения меньше upperBound
+     */
+    static std::uint64_t upperBound(std::size_t bucket);
+
+private:
+    struct Shard;
+
+    std::unique_ptr<std::atomic<Shard*>[]> shards_;
+    std::size_t mask_;
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Метрики приложения и их вывод в текстовом формате Prometheus
+ *
+ * Время обработки запросов хранится в гистограммах по маршруту (метод и
+ * паттерн, как его нашёл Router) и классу статуса (1xx..5xx). Серии
+ * маршрутов создаются заранее addRoute(), поэтому recordRequest() не
+ * выделяет память и не берёт блокировок: поиск серии по паттерну и
+ * запись в гистограмму. Запросы без маршрута и с незарегистрированным
+ * паттерном попадают в одну серию с пустыми method и route - число серий
+ * не зависит от присланных клиентами путей.
+ *
+ * Агрегация шардов, квантили и форматирование - только в scrape().
+ *
+ * addRoute(), counter() и addGauge() - до начала обработки запросов;
+ * recordRequest(), счётчики и scrape() - из любых потоков.
+ */
+class MetricsRegistry
+{
+public:
+    static constexpr std::size_t statusClasses = 5;
+
+    struct Options
+    {
+        bool enabled = false;           ///< Записывать метрики запросов
+        std::string path = "/metrics";  ///< GET-маршрут для Prometheus, пусто - не регистрировать
+
+        /**
+         * @brief Прочитать metrics.enabled и metrics.path
+         * @throws std::runtime_error для недопустимых значений
+         */
+        static Options fromEnvironment(const IEnvironment& env);
+    };
+
+    /**
+     * @class Inflight
+     * @brief Учитывает запрос в gauge запросов в обработке, пока жив
+     */
+    class Inflight
+    {
+    public:
+        explicit Inflight(Counter* gauge = nullptr) : gauge_(gauge)
+        {
+            if (gauge_)
+            {
+                gauge_->add(1);
+            }
+        }
+
+        ~Inflight()
+        {
+            if (gauge_)
+            {
+                gauge_->add(-1);
+            }
+        }
+
+        Inflight(const Inflight&) = delete;
+        Inflight& operator=(const Inflight&) = delete;
+
+    private:
+        Counter* gauge_;
+    };
+
+    /**
+     * @param shards Число шардов счётчиков и гистограмм, 0 - по числу ядер
+     */
+    explicit MetricsRegistry(std::size_t shards = 0);
+
+    /**
+     * @brief Создать серии маршрута (повторный вызов ничего не делает)
+     */
+    void addRoute(std::string_view method, std::string_view pattern);
+
+    /**
+     * @brief Записать время обработки запроса
+     * @param pattern Паттерн найденного маршрута, пусто - маршрут не найден
+     */
+    void recordRequest(std::string_view method, std::string_view pattern, int status,
+                       std::chrono::nanoseconds latency);
+
+    /**
+     * @brief Gauge http_server_requests_in_flight на время обработки запроса
+     */
+    Inflight trackRequest()
+    {
+        return Inflight(&inflight_);
+    }
+
+    /**
+     * @brief Счётчик приложения (повторный вызов с тем же именем вернёт тот же)
+     * @param name Имя метрики Prometheus: [a-zA-Z_:][a-zA-Z0-9_:]*
+     * @throws std::runtime_error если имя некорректно
+     */
+    Counter& counter(const std::string& name, const std::string& help);
+
+    /**
+     * @brief Gauge, значение которого читается функцией при каждом scrape()
+     * @throws std::runtime_error если имя некорректно
+     */
+    void addGauge(const std::string& name, const std::string& help, std::function<double()> read);
+
+    /**
+     * @brief Все метрики в текстовом формате Prometheus 0.0.4
+     */
+    std::string scrape() const;
+
+private:
+    struct Series
+    {
+        std::string method;
+        std::string pattern;
+        std::array<std::unique_ptr<LatencyHistogram>, statusClasses> latency;
+    };
+
+    struct NamedCounter
+    {
+        std::string name;
+        std::string help;
+        std::unique_ptr<Counter> counter;
+    };
+
+    struct Gauge
+    {
+        std::string name;
+        std::string help;
+        std::function<double()> read;
+    };
+
+    Series& makeSeries(std::string_view method, std::string_view pattern);
+
+    std::size_t shards_;
+    std::deque<Series> series_; ///< deque: адреса серий не меняются при добавлении
+    std::unordered_map<std::string_view, std::vector<Series*>> routes_; ///< Ключи указывают в Series::pattern
+    Series* unmatched_;
+    Counter inflight_;
+    std::deque<NamedCounter> counters_;
+    std::vector<Gauge> gauges_;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "IHttpHandler.hpp"
+#include "Metrics.hpp"
+
+/**
+ * @file MetricsHandler.hpp
+ * @brief Обработчик GET /metrics для Prometheus
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class MetricsHandler
+ * @brief Отдаёт MetricsRegistry::scrape() в текстовом формате Prometheus
+ *
+ * Реестр должен жить дольше обработчика.
+ */
+class MetricsHandler : public IHttpHandler
+{
+public:
+    explicit MetricsHandler(const MetricsRegistry& registry) : registry_(registry)
+    {
+    }
+
+    void handle(IRequest&, IResponse& res) override
+    {
+        res.setStatus(200);
+        res.setHeader("Content-Type", "text/plain; version=0.0.4; charset=utf-8");
+        res.setBody(registry_.scrape());
+    }
+
+private:
+    const MetricsRegistry& registry_;
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+/**
+ * @file PathParams.hpp
+ * @brief Именованные сегменты пути, захваченные маршрутом
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class PathParams
+ * @brief Значения сегментов {name} паттерна маршрута
+ *
+ * Хранит только string_view: имена и паттерн указывают в маршрутизатор,
+ * значения - в target запроса, поэтому действительны, пока обрабатывается
+ * запрос.
+ * Ёмкость фиксирована, захват не выделяет память.
+ */
+class PathParams
+{
+public:
+    /// Максимум переменных сегментов в одном паттерне
+    static constexpr std::size_t capacity = 8;
+
+    struct Param
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    /**
+     * @brief Значение сегмента по имени
+     * @return Пустая строка, если такого сегмента нет
+     */
+    std::string_view get(std::string_view name) const
+    {
+        for (const auto& param : *this)
+        {
+            if (param.name == name)
+            {
+                return param.value;
+            }
+        }
+        return {};
+    }
+
+    /**
+     * @brief Значение сегмента как целое (для {name:int})
+     * @return nullopt, если сегмента нет или это не целое
+     */
+    std::optional<std::int64_t> getInt(std::string_view name) const
+    {
+        std::string_view value = get(name);
+        std::int64_t result = 0;
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (value.empty() || ec != std::errc() || end != value.data() + value.size())
+        {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    bool contains(std::string_view name) const
+    {
+        for (const auto& param : *this)
+        {
+            if (param.name == name)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void add(std::string_view name, std::string_view value)
+    {
+        if (size_ == capacity)
+        {
+            throw std::length_error("PathParams: too many path parameters");
+        }
+        params_[size_++] = Param{name, value};
+    }
+
+    /**
+     * @brief Паттерн найденного маршрута ("/users/{id}"), пусто - не найден
+     *
+     * Подходит как метка маршрута в журналах и метриках: в отличие от пути,
+     * число разных значений ограничено числом маршрутов.
+     */
+    std::string_view pattern() const
+    {
+        return pattern_;
+    }
+
+    void setPattern(std::string_view pattern)
+    {
+        pattern_ = pattern;
+    }
+
+    void clear()
+    {
+        size_ = 0;
+        pattern_ = {};
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const Param* begin() const { return params_.data(); }
+    const Param* end() const { return params_.data() + size_; }
+
+private:
+    std::array<Param, capacity> params_{};
+    std::size_t size_ = 0;
+    std::string_view pattern_;
+};
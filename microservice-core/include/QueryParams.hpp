@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file QueryParams.hpp
+ * @brief Ленивый разбор query string с percent-декодированием
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class QueryParams
+ * @brief Параметры query string, разобранные при первом обращении
+ *
+ * Разбор один раз делит строку на пары string_view (без копирования).
+ * Значение декодируется (%XX, '+' - пробел) только при чтении и только
+ * если в нём есть что декодировать; декодированная строка кэшируется.
+ * Повторяющиеся ключи сохраняются, ключ без '=' имеет пустое значение.
+ *
+ * Возвращаемые string_view действительны, пока живы QueryParams и
+ * исходная строка. Не потокобезопасен (один запрос - один поток).
+ */
+class QueryParams
+{
+public:
+    QueryParams() = default;
+
+    /**
+     * @param query Строка после '?' (без неё)
+     * @param resource Память под разобранные пары (арена запроса)
+     */
+    explicit QueryParams(std::string_view query,
+                         std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : query_(query), entries_(resource)
+    {
+    }
+
+    /**
+     * @brief Первое значение параметра, декодированное
+     * @return nullopt, если параметра нет
+     */
+    std::optional<std::string_view> get(std::string_view name) const
+    {
+        for (const auto& entry : entries())
+        {
+            if (keyEquals(entry.key, name))
+            {
+                return value(entry);
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Все значения повторяющегося параметра по порядку
+     */
+    std::vector<std::string_view> getAll(std::string_view name) const
+    {
+        std::vector<std::string_view> values;
+        for (const auto& entry : entries())
+        {
+            if (keyEquals(entry.key, name))
+            {
+                values.push_back(value(entry));
+            }
+        }
+        return values;
+    }
+
+    bool contains(std::string_view name) const
+    {
+        return get(name).has_value();
+    }
+
+    /**
+     * @brief Число пар key=value (с повторами)
+     */
+    std::size_t size() const
+    {
+        return entries().size();
+    }
+
+    /**
+     * @brief Обойти все пары в порядке query string
+     * @param visit Вызывается как visit(std::string key, std::string_view value)
+     */
+    template<class Visitor>
+    void forEach(Visitor&& visit) const
+    {
+        for (const auto& entry : entries())
+        {
+            visit(decode(entry.key), value(entry));
+        }
+    }
+
+    /**
+     * @brief Percent-декодирование ('+' - пробел, неверный %XX остаётся как есть)
+     */
+    static std::string decode(std::string_view text)
+    {
+        std::string result;
+        result.reserve(text.size());
+        for (std::size_t i = 0; i < text.size(); ++i)
+        {
+            result += decodeAt(text, i);
+        }
+        return result;
+    }
+
+private:
+    struct Entry
+    {
+        std::string_view key;
+        std::string_view value;
+        mutable std::string decoded;
+        mutable bool isDecoded = false;
+    };
+
+    const std::pmr::vector<Entry>& entries() const
+    {
+        if (!parsed_)
+        {
+            parse();
+        }
+        return entries_;
+    }
+
+    void parse() const
+    {
+        parsed_ = true;
+        if (query_.empty())
+        {
+            return;
+        }
+        // Одно выделение памяти на запрос
+        entries_.reserve(static_cast<std::size_t>(std::count(query_.begin(), query_.end(), '&')) + 1);
+
+        std::string_view rest = query_;
+        while (!rest.empty())
+        {
+            std::size_t amp = rest.find('&');
+            std::string_view pair = rest.substr(0, amp);
+            rest = amp == std::string_view::npos ? std::string_view() : rest.substr(amp + 1);
+            if (pair.empty())
+            {
+                continue;
+            }
+
+            std::size_t eq = pair.find('=');
+            Entry entry;
+            entry.key = pair.substr(0, eq);
+            entry.value = eq == std::string_view::npos ? std::string_view() : pair.substr(eq + 1);
+            entries_.push_back(std::move(entry));
+        }
+    }
+
+    static bool needsDecoding(std::string_view text)
+    {
+        return text.find_first_of("%+") != std::string_view::npos;
+    }
+
+    static std::string_view value(const Entry& entry)
+    {
+        if (!needsDecoding(entry.value))
+        {
+            return entry.value;
+        }
+        if (!entry.isDecoded)
+        {
+            entry.decoded = decode(entry.value);
+            entry.isDecoded = true;
+        }
+        return entry.decoded;
+    }
+
+    /**
+     * @brief Сравнить закодированный ключ с именем, не выделяя память
+     */
+    static bool keyEquals(std::string_view raw, std::string_view name)
+    {
+        if (!needsDecoding(raw))
+        {
+            return raw == name;
+        }
+
+        std::size_t matched = 0;
+        for (std::size_t i = 0; i < raw.size(); ++i)
+        {
+            if (matched == name.size() || decodeAt(raw, i) != name[matched++])
+            {
+                return false;
+            }
+        }
+        return matched == name.size();
+    }
+
+    /**
+     * @brief Декодировать символ в позиции i (для %XX сдвигает i на последнюю цифру)
+     */
+    static char decodeAt(std::string_view text, std::size_t& i)
+    {
+        if (text[i] == '+')
+        {
+            return ' ';
+        }
+        if (text[i] == '%' && i + 2 < text.size())
+        {
+            int high = hex(text[i + 1]);
+            int low = hex(text[i + 2]);
+            if (high >= 0 && low >= 0)
+            {
+                i += 2;
+                return static_cast<char>(high * 16 + low);
+            }
+        }
+        return text[i];
+    }
+
+    static int hex(char ch)
+    {
+        if (ch >= '0' && ch <= '9') return ch - '0';
+        if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+        if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+        return -1;
+    }
+
+    std::string_view query_;
+    mutable std::pmr::vector<Entry> entries_;
+    mutable bool parsed_ = false;
+};
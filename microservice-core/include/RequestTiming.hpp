@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @file RequestTiming.hpp
+ * @brief Отметки времени этапов обработки запроса
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @struct RequestTiming
+ * @brief Моменты (steady_clock) прохождения запросом этапов сервера
+ *
+ * Отметка, которую сервер не поставил, равна Clock::time_point{}, а
+ * длительность с её участием - нулю. Обработчик видит отметки до Routed
+ * включительно, Handled и Written ставятся после него.
+ *
+ * Фазы:
+ * - read - от первого байта запроса до прочитанного тела; простой
+ *   keep-alive соединения в неё не входит. Потоковое тело читает сам
+ *   обработчик, поэтому для него read заканчивается на заголовках;
+ * - route - поиск обработчика;
+ * - handle - обработчик (вместе с ответом, отправленным им порциями);
+ * - write - отправка ответа после обработчика.
+ */
+struct RequestTiming
+{
+    using Clock = std::chrono::steady_clock;
+
+    enum Mark : std::size_t
+    {
+        Accepted,    ///< Соединение принято (общая для всех запросов соединения)
+        ReadStarted, ///< Пришёл первый байт запроса
+        HeaderRead,  ///< Заголовки прочитаны
+        BodyRead,    ///< Тело прочитано
+        Routed,      ///< Обработчик найден (или не найден)
+        Handled,     ///< Обработчик вернул управление
+        Written,     ///< Ответ отправлен
+        MarkCount
+    };
+
+    std::array<Clock::time_point, MarkCount> marks{};
+
+    void mark(Mark which, Clock::time_point at = Clock::now())
+    {
+        marks[which] = at;
+    }
+
+    bool has(Mark which) const
+    {
+        return marks[which] != Clock::time_point{};
+    }
+
+    /**
+     * @brief Время от отметки from до отметки to, 0 - если одной из них нет
+     */
+    Clock::duration between(Mark from, Mark to) const
+    {
+        if (!has(from) || !has(to) || marks[to] < marks[from])
+        {
+            return Clock::duration::zero();
+        }
+        return marks[to] - marks[from];
+    }
+
+    Clock::duration read() const
+    {
+        return between(ReadStarted, BodyRead);
+    }
+
+    Clock::duration route() const
+    {
+        return between(BodyRead, Routed);
+    }
+
+    Clock::duration handle() const
+    {
+        return between(Routed, Handled);
+    }
+
+    Clock::duration write() const
+    {
+        return between(Handled, Written);
+    }
+
+    /**
+     * @brief От первого байта запроса до отправленного ответа
+     */
+    Clock::duration total() const
+    {
+        return between(ReadStarted, Written);
+    }
+};
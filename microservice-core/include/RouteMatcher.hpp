@@ -1,7 +1,7 @@
 #pragma once
 
-#include <string>
-#include <vector>
+#include "PathParams.hpp"
+#include <string_view>
 
 /**
  * @file RouteMatcher.hpp
@@ -12,21 +12,60 @@
 /**
  * @class RouteMatcher
  * @brief Проверяет соответствие пути паттерну
+ *
+ * Сегменты паттерна:
+ * - литерал - совпадает только с собой;
+ * - "*" - любой один сегмент;
+ * - "{name}" - любой один сегмент, значение доступно по имени;
+ * - "{name:int}" - сегмент из цифр, значение доступно по имени.
+ *
+ * Пустые сегменты ("//") пропускаются. Путь со слешем в конце подходит и
+ * паттерну без него, паттерн со слешем в конце - только пути со слешем.
+ * Сопоставление не копирует строки и не выделяет память.
  */
 class RouteMatcher
 {
 public:
+    /**
+     * @brief Вид сегмента паттерна
+     */
+    enum class SegmentKind
+    {
+        Literal,
+        Any,    ///< "*" или "{name}"
+        Int,    ///< "{name:int}"
+        Invalid ///< Незакрытая скобка, пустое имя или неизвестный тип
+    };
+
+    struct Segment
+    {
+        SegmentKind kind;
+        std::string_view text; ///< Литерал или имя захвата (пусто для "*")
+    };
+
     /**
      * @brief Проверить соответствие пути паттерну
-     * @param pattern Паттерн с wildcard (например, /r/*)
-     * @param path Путь для проверки (например, /r/promo)
+     * @param pattern Паттерн с wildcard и захватами (например, /users/{id})
+     * @param path Путь для проверки (например, /users/42)
+     * @param params Куда сложить захваченные сегменты (nullptr - не нужны)
      * @return true если путь соответствует паттерну
      */
-    static bool matches(const std::string& pattern, const std::string& path);
+    static bool matches(std::string_view pattern, std::string_view path, PathParams* params = nullptr);
+
+    /**
+     * @brief Отделить следующий непустой сегмент
+     * @param rest Остаток пути, после вызова - остаток за сегментом
+     * @return Пустой сегмент, если сегментов больше нет
+     */
+    static std::string_view nextSegment(std::string_view& rest);
+
+    /**
+     * @brief Разобрать сегмент паттерна
+     */
+    static Segment parseSegment(std::string_view segment);
 
-private:
     /**
-     * @brief Разбить строку на сегменты по разделителю
+     * @brief Подходит ли сегмент пути под переменный сегмент паттерна
      */
-    static std::vector<std::string> split(const std::string& str, char delimiter);
-};
\ No newline at end of file
+    static bool accepts(SegmentKind kind, std::string_view value);
+};
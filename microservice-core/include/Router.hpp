@@ -0,0 +1,129 @@
+#pragma once
+
+#include "HttpMethod.hpp"
+#include "IHttpHandler.hpp"
+#include "PathParams.hpp"
+#include "RouteMatcher.hpp"
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @file Router.hpp
+ * @brief Маршрутизатор на дереве сегментов пути
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class Router
+ * @brief Находит обработчик по методу и пути за один проход по пути
+ *
+ * Паттерны разбираются один раз при add() в дерево сегментов, отдельное
+ * для каждого метода: деревья стандартных методов лежат в массиве по
+ * HttpMethod, остальные ищутся по имени. Паттерны без переменных
+ * сегментов дополнительно попадают в хеш-таблицу метода: путь, буква в
+ * букву совпавший с таким паттерном, находится одним поиском по хешу.
+ *
+ * Сегменты паттерна - как в RouteMatcher: литерал,
+ * "*", "{name}" и "{name:int}". find() идёт по сегментам пути без
+ * копирования строк и выделения памяти; на каждом уровне литерал
+ * проверяется раньше "{name:int}", а тот - раньше "*" и "{name}"; при
+ * неудаче поиск возвращается и пробует следующий вариант.
+ *
+ * Пути сравниваются так же, как RouteMatcher: пустые сегменты ("//")
+ * пропускаются, путь со слешем в конце подходит и паттерну без него,
+ * а паттерн со слешем в конце ("/r/") - только пути со слешем.
+ *
+ * Построение не потокобезопасно; find() после построения можно вызывать
+ * из любых потоков. Ключи хеш-таблиц указывают в строки самих маршрутов,
+ * поэтому Router не копируется и не перемещается.
+ */
+class Router
+{
+public:
+    Router() = default;
+
+    Router(const Router&) = delete;
+    Router& operator=(const Router&) = delete;
+    Router(Router&&) = delete;
+    Router& operator=(Router&&) = delete;
+
+    /**
+     * @brief Зарегистрировать обработчик (повторная регистрация заменяет)
+     * @param method HTTP метод (GET, POST, ...)
+     * @param pattern Паттерн пути, например /users/{id:int}/orders/{orderId}
+     * @throws std::runtime_error если паттерн некорректен, в нём больше
+     *         PathParams::capacity переменных сегментов или он совпадает с
+     *         уже зарегистрированным с точностью до имён переменных
+     *         ("*" и "{id}", "{id}" и "{userId}" в одном месте пути)
+     */
+    void add(std::string_view method, std::string_view pattern, std::shared_ptr<IHttpHandler> handler);
+
+    /**
+     * @brief Найти обработчик
+     * @param path Путь без query string
+     * @param params Куда сложить значения {name} (string_view в path) и паттерн маршрута
+     * @return nullptr если маршрут не найден
+     */
+    std::shared_ptr<IHttpHandler> find(std::string_view method, std::string_view path,
+                                       PathParams* params = nullptr) const;
+
+    /**
+     * @brief Найти обработчик по уже разобранному методу
+     * @param methodName Имя метода, нужно только для HttpMethod::Other
+     */
+    std::shared_ptr<IHttpHandler> find(HttpMethod method, std::string_view methodName, std::string_view path,
+                                       PathParams* params = nullptr) const;
+
+    /**
+     * @brief Удалить все маршруты
+     */
+    void clear();
+
+    /**
+     * @brief Число зарегистрированных маршрутов
+     */
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    struct Route
+    {
+        std::shared_ptr<IHttpHandler> handler;
+        std::vector<std::string> names; ///< Имена переменных сегментов, "" для "*"
+        std::string pattern;            ///< Паттерн, как его зарегистрировали
+        std::string exact;              ///< Паттерн без переменных сегментов - ключ Tree::exact
+    };
+
+    struct Node
+    {
+        std::vector<std::pair<std::string, std::unique_ptr<Node>>> literals; ///< По возрастанию имени
+        std::unique_ptr<Node> integer;  ///< {name:int}
+        std::unique_ptr<Node> wildcard; ///< * и {name}
+        Route route;      ///< Паттерн заканчивается сегментом
+        Route slashRoute; ///< Паттерн заканчивается "/"
+    };
+
+    struct Tree
+    {
+        Node root;
+        std::unordered_map<std::string_view, const Route*> exact; ///< Ключи указывают в Route::exact
+    };
+
+    using Values = std::array<std::string_view, PathParams::capacity>;
+
+    Tree& tree(std::string_view method);
+    const Tree* findTree(HttpMethod method, std::string_view methodName) const;
+    static Node& child(Node& node, const RouteMatcher::Segment& segment);
+    static const Route* match(const Node& node, std::string_view rest, Values& values, std::size_t depth);
+
+    std::array<Tree, kHttpMethodCount> methods_;
+    std::vector<std::pair<std::string, std::unique_ptr<Tree>>> otherMethods_;
+    std::size_t size_ = 0;
+};
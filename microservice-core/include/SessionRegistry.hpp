@@ -0,0 +1,158 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @file SessionRegistry.hpp
+ * @brief Реестр активных сессий для graceful drain
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class SessionRegistry
+ * @brief Учитывает открытые соединения и умеет их закрывать при остановке
+ *
+ * Каждая сессия регистрирует функцию закрытия close(force):
+ * - force == false - закрыть, только если сессия простаивает между запросами;
+ * - force == true - закрыть безусловно (истёк срок drain).
+ *
+ * Функции закрытия вызываются под внутренней блокировкой, поэтому не должны
+ * синхронно снимать регистрацию (асинхронные сессии делают post в свой executor).
+ */
+class SessionRegistry
+{
+public:
+    using Closer = std::function<void(bool force)>;
+
+    /**
+     * @class Registration
+     * @brief RAII-регистрация сессии (move-only)
+     */
+    class Registration
+    {
+    public:
+        Registration() = default;
+        Registration(const Registration&) = delete;
+        Registration& operator=(const Registration&) = delete;
+
+        Registration(Registration&& other) noexcept
+            : owner_(std::exchange(other.owner_, nullptr)), id_(other.id_)
+        {
+        }
+
+        Registration& operator=(Registration&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                owner_ = std::exchange(other.owner_, nullptr);
+                id_ = other.id_;
+            }
+            return *this;
+        }
+
+        ~Registration()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            if (owner_)
+            {
+                owner_->remove(id_);
+                owner_ = nullptr;
+            }
+        }
+
+    private:
+        friend class SessionRegistry;
+        Registration(SessionRegistry* owner, std::uint64_t id) : owner_(owner), id_(id) {}
+
+        SessionRegistry* owner_ = nullptr;
+        std::uint64_t id_ = 0;
+    };
+
+    SessionRegistry() = default;
+    SessionRegistry(const SessionRegistry&) = delete;
+    SessionRegistry& operator=(const SessionRegistry&) = delete;
+
+    /**
+     * @brief Зарегистрировать сессию
+     * @param closer Функция закрытия сессии
+     */
+    Registration add(Closer closer)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uint64_t id = nextId_++;
+        sessions_.emplace(id, std::move(closer));
+        return Registration(this, id);
+    }
+
+    /**
+     * @brief Число активных сессий
+     */
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sessions_.size();
+    }
+
+    /**
+     * @brief Закрыть сессии, простаивающие между запросами
+     */
+    void closeIdle()
+    {
+        closeEach(false);
+    }
+
+    /**
+     * @brief Закрыть все сессии, включая обрабатывающие запрос
+     */
+    void closeAll()
+    {
+        closeEach(true);
+    }
+
+    /**
+     * @brief Дождаться закрытия всех сессий
+     * @param deadline Крайний срок ожидания
+     * @return true если сессий не осталось
+     */
+    bool waitEmpty(std::chrono::steady_clock::time_point deadline)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return empty_.wait_until(lock, deadline, [this] { return sessions_.empty(); });
+    }
+
+private:
+    void remove(std::uint64_t id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions_.erase(id);
+        if (sessions_.empty())
+        {
+            empty_.notify_all();
+        }
+    }
+
+    void closeEach(bool force)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [id, closer] : sessions_)
+        {
+            closer(force);
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable empty_;
+    std::unordered_map<std::uint64_t, Closer> sessions_;
+    std::uint64_t nextId_ = 0;
+};
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "IRequest.hpp"
+#include <algorithm>
+#include <cctype>
 #include <string>
+#include <string_view>
 #include <map>
+#include <optional>
 
 /**
  * @file SimpleRequest.hpp
@@ -31,12 +35,38 @@ struct SimpleRequest : IRequest
     {
         return {};
     }
+
+    std::optional<std::string_view> param(std::string_view) const override
+    {
+        return std::nullopt;
+    }
     
     std::map<std::string, std::string> getHeaders() const override
     {
         return headers_;
     }
 
+    // getPath() - цель запроса целиком (её отправляет HttpClient), path() - без query string
+    std::string_view path() const override { return std::string_view(path_).substr(0, path_.find('?')); }
+    std::string_view body() const override { return body_; }
+
+    using IRequest::header;
+
+    std::string_view header(std::string_view name) const override
+    {
+        for (const auto& [key, value] : headers_)
+        {
+            if (key.size() == name.size() &&
+                std::equal(key.begin(), key.end(), name.begin(), [](char a, char b) {
+                    return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+                }))
+            {
+                return value;
+            }
+        }
+        return {};
+    }
+
 private:
     std::string method_;
     std::string path_;
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "IResponse.hpp"
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <map>
 
 /**
@@ -27,13 +31,39 @@ public:
         body_ = body;
     }
 
+    void setBody(std::string&& body) override
+    {
+        body_ = std::move(body);
+    }
+
+    void reserveBody(std::size_t bytes) override
+    {
+        body_.reserve(bytes);
+    }
+
+    void appendBody(std::string_view data) override
+    {
+        body_.append(data);
+    }
+
+    void setSharedBody(std::shared_ptr<const std::string> body) override
+    {
+        body_ = *body;
+    }
+
     void setHeader(const std::string& name, const std::string& value) override
     {
         headers_[name] = value;
     }
 
+    void write(std::string_view chunk) override
+    {
+        body_.append(chunk);
+    }
+
     int getStatus() const { return status_; }
     std::string getBody() const { return body_; }
+    const std::string& body() const { return body_; }
     std::map<std::string, std::string> getHeaders() const { return headers_; }
 
 private:
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @file SpscRing.hpp
+ * @brief Кольцевой буфер один писатель - один читатель без блокировок
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class SpscRing
+ * @brief Буфер потока: пишет поток-владелец, читает фоновый поток
+ *
+ * Элементы хранятся на месте и перезаписываются, push() не выделяет
+ * память. При заполненном буфере push() ничего не пишет и возвращает
+ * false - вызывающий решает, считать ли потерю.
+ *
+ * Флаг released выставляет завершившийся поток-владелец: после того как
+ * читатель вычитает буфер, его можно отдать другому потоку.
+ */
+template<class T, std::size_t Capacity>
+class SpscRing
+{
+public:
+    static constexpr std::size_t capacity = Capacity;
+
+    /**
+     * @brief Заполнить следующий элемент (только поток-владелец)
+     * @param fill Вызывается как fill(T&)
+     * @return false, если буфер полон
+     */
+    template<class Fill>
+    bool push(Fill&& fill)
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        fill(items_[head % Capacity]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Обойти и освободить всё записанное (только читатель)
+     * @param visit Вызывается как visit(const T&)
+     * @return true, если что-то было прочитано
+     */
+    template<class Visitor>
+    bool drain(Visitor&& visit)
+    {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t head = head_.load(std::memory_order_acquire);
+        for (std::size_t i = tail; i != head; ++i)
+        {
+            visit(static_cast<const T&>(items_[i % Capacity]));
+        }
+        tail_.store(head, std::memory_order_release);
+        return head != tail;
+    }
+
+    bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    std::atomic<bool> released{false}; ///< Владелец завершился, буфер можно отдать другому
+
+private:
+    std::array<T, Capacity> items_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+};
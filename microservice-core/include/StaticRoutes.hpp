@@ -0,0 +1,232 @@
+#pragma once
+
+#include "HttpMethod.hpp"
+#include "IRequest.hpp"
+#include "IResponse.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+/**
+ * @file StaticRoutes.hpp
+ * @brief Таблица маршрутов, построенная на этапе компиляции
+ * @author Anton Tobolkin
+ */
+
+/// Обработчик статического маршрута: обычная функция, без виртуального вызова
+using StaticHandler = void (*)(IRequest&, IResponse&);
+
+/**
+ * @struct StaticRoute
+ * @brief Точный маршрут: метод, путь и функция-обработчик
+ */
+struct StaticRoute
+{
+    HttpMethod method;
+    std::string_view path;
+    StaticHandler handler;
+};
+
+/**
+ * @brief Объявить статический маршрут
+ *
+ * В constexpr-контексте некорректный маршрут (нестандартный метод,
+ * "*" или "{name}" в пути) - ошибка компиляции.
+ */
+constexpr StaticRoute route(std::string_view method, std::string_view path, StaticHandler handler)
+{
+    HttpMethod parsed = parseHttpMethod(method);
+    if (parsed == HttpMethod::Other)
+    {
+        throw std::logic_error("Static route: unsupported method");
+    }
+    for (char ch : path)
+    {
+        if (ch == '*' || ch == '{' || ch == '}')
+        {
+            throw std::logic_error("Static route: path must be literal");
+        }
+    }
+    return StaticRoute{parsed, path, handler};
+}
+
+/**
+ * @class StaticRoutes
+ * @brief Нешаблонное представление StaticRouteTable для поиска во время работы
+ *
+ * Открытая адресация по хешу (FNV-1a пути и метод), таблица слотов
+ * посчитана компилятором. Не владеет данными: таблица должна жить
+ * дольше (обычно static constexpr).
+ */
+class StaticRoutes
+{
+public:
+    constexpr StaticRoutes() = default;
+
+    constexpr StaticRoutes(const StaticRoute* routes, const std::uint16_t* slots, std::size_t slotCount)
+        : routes_(routes), slots_(slots), mask_(slotCount - 1)
+    {
+    }
+
+    /**
+     * @brief Найти обработчик пути, буква в букву совпадающего с маршрутом
+     * @return nullptr если маршрута нет
+     */
+    constexpr StaticHandler find(HttpMethod method, std::string_view path) const
+    {
+        if (!slots_)
+        {
+            return nullptr;
+        }
+
+        for (std::size_t slot = hash(method, path) & mask_;; slot = (slot + 1) & mask_)
+        {
+            std::uint16_t index = slots_[slot];
+            if (index == 0)
+            {
+                return nullptr;
+            }
+            const StaticRoute& candidate = routes_[index - 1];
+            if (candidate.method == method && candidate.path == path)
+            {
+                return candidate.handler;
+            }
+        }
+    }
+
+    constexpr bool empty() const
+    {
+        return slots_ == nullptr;
+    }
+
+    /**
+     * @brief Обойти маршруты таблицы (порядок - по слотам)
+     * @param visit Вызывается как visit(const StaticRoute&)
+     */
+    template<class Visitor>
+    void forEach(Visitor&& visit) const
+    {
+        if (!slots_)
+        {
+            return;
+        }
+        for (std::size_t slot = 0; slot <= mask_; ++slot)
+        {
+            if (slots_[slot] != 0)
+            {
+                visit(routes_[slots_[slot] - 1]);
+            }
+        }
+    }
+
+    static constexpr std::uint64_t hash(HttpMethod method, std::string_view path)
+    {
+        std::uint64_t value = 14695981039346656037ull ^ static_cast<std::uint64_t>(method);
+        for (char ch : path)
+        {
+            value ^= static_cast<unsigned char>(ch);
+            value *= 1099511628211ull;
+        }
+        return value;
+    }
+
+private:
+    const StaticRoute* routes_ = nullptr;
+    const std::uint16_t* slots_ = nullptr; ///< Индекс маршрута + 1, 0 - пустой слот
+    std::size_t mask_ = 0;
+};
+
+/**
+ * @brief Число слотов таблицы: степень двойки не меньше 2N
+ */
+constexpr std::size_t staticRouteSlots(std::size_t routes)
+{
+    std::size_t count = 1;
+    while (count < 2 * routes)
+    {
+        count *= 2;
+    }
+    return count;
+}
+
+/**
+ * @class StaticRouteTable
+ * @brief Хеш-таблица N маршрутов, которую строит компилятор
+ *
+ * Слотов вдвое больше маршрутов, поэтому цепочки пробирования короткие,
+ * а пустой слот всегда найдётся. Повтор маршрута в
+ * constexpr-контексте - ошибка компиляции.
+ */
+template<std::size_t N>
+class StaticRouteTable
+{
+public:
+    static_assert(N > 0 && N < 0x8000, "StaticRouteTable: 1..32767 routes");
+
+    static constexpr std::size_t slotCount()
+    {
+        return staticRouteSlots(N);
+    }
+
+    constexpr explicit StaticRouteTable(const std::array<StaticRoute, N>& routes)
+        : routes_(routes), slots_{}
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            std::size_t slot = StaticRoutes::hash(routes_[i].method, routes_[i].path) & (slotCount() - 1);
+            while (slots_[slot] != 0)
+            {
+                const StaticRoute& other = routes_[slots_[slot] - 1];
+                if (other.method == routes_[i].method && other.path == routes_[i].path)
+                {
+                    throw std::logic_error("Static route: duplicate route");
+                }
+                slot = (slot + 1) & (slotCount() - 1);
+            }
+            slots_[slot] = static_cast<std::uint16_t>(i + 1);
+        }
+    }
+
+    constexpr StaticHandler find(HttpMethod method, std::string_view path) const
+    {
+        return view().find(method, path);
+    }
+
+    constexpr StaticRoutes view() const
+    {
+        return StaticRoutes(routes_.data(), slots_.data(), slotCount());
+    }
+
+    constexpr std::size_t size() const
+    {
+        return N;
+    }
+
+private:
+    std::array<StaticRoute, N> routes_;
+    std::array<std::uint16_t, staticRouteSlots(N)> slots_;
+};
+
+/**
+ * @brief Построить таблицу из списка маршрутов
+ *
+ * @code
+ * static constexpr auto kRoutes = makeStaticRoutes({
+ *     route("GET", "/health", &health),
+ *     route("GET", "/version", &version),
+ * });
+ * static_assert(kRoutes.find(HttpMethod::Get, "/health") == &health);
+ * @endcode
+ */
+template<std::size_t N>
+constexpr StaticRouteTable<N> makeStaticRoutes(const StaticRoute (&routes)[N])
+{
+    std::array<StaticRoute, N> list{};
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        list[i] = routes[i];
+    }
+    return StaticRouteTable<N>(list);
+}
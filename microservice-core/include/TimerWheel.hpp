@@ -0,0 +1,263 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+/**
+ * @file TimerWheel.hpp
+ * @brief Иерархическое колесо таймеров для сроков операций соединений
+ * @author Anton Tobolkin
+ */
+
+/**
+ * @class TimerWheel
+ * @brief Много таймеров с грубой точностью и O(1) постановкой и отменой
+ *
+ * Время делится на тики фиксированной длины. Четыре уровня по 64 слота
+ * покрывают 64^4 тиков (при тике 100 мс - больше 19 суток); таймеры с
+ * дальних уровней переносятся на ближние по мере приближения срока.
+ *
+ * Таймер (Timer) - интрузивный узел, который владелец хранит у себя:
+ * постановка на срок только перевешивает узел между списками и не выделяет
+ * память. Таймер срабатывает не раньше заданного срока и не позже чем
+ * через два тика после него.
+ *
+ * Методы потокобезопасны. Обработчики срабатывания вызываются из advance()
+ * под внутренней блокировкой: они должны быть короткими и не обращаться
+ * к колесу (асинхронные сессии делают post в свой executor).
+ */
+class TimerWheel
+{
+    struct Node
+    {
+        Node* prev = nullptr;
+        Node* next = nullptr;
+    };
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @class Timer
+     * @brief Интрузивный таймер; при уничтожении снимается с колеса
+     */
+    class Timer : private Node
+    {
+    public:
+        Timer() = default;
+        explicit Timer(std::function<void()> handler) : handler_(std::move(handler)) {}
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        ~Timer()
+        {
+            if (owner_)
+            {
+                owner_->cancel(*this);
+            }
+        }
+
+        /**
+         * @brief Задать обработчик (пока таймер не поставлен на срок)
+         */
+        void setHandler(std::function<void()> handler)
+        {
+            handler_ = std::move(handler);
+        }
+
+    private:
+        friend class TimerWheel;
+
+        std::function<void()> handler_;
+        TimerWheel* owner_ = nullptr;
+        std::uint64_t expires_ = 0;
+    };
+
+    /**
+     * @param tick Длина тика (точность таймеров)
+     * @param start Момент отсчёта тиков
+     */
+    explicit TimerWheel(Clock::duration tick = std::chrono::milliseconds(100),
+                        Clock::time_point start = Clock::now())
+        : tick_(tick), start_(start)
+    {
+        for (auto& level : slots_)
+        {
+            for (auto& slot : level)
+            {
+                slot.prev = slot.next = &slot;
+            }
+        }
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief Поставить (или переставить) таймер на срок now + timeout
+     */
+    void schedule(Timer& timer, Clock::duration timeout, Clock::time_point now = Clock::now())
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (timer.next)
+        {
+            unlink(timer);
+            --size_;
+        }
+
+        // Тик текущего момента плюс округлённый вверх таймаут и ещё один тик:
+        // currentTick_ может отставать, а срабатывание раньше срока недопустимо
+        std::uint64_t nowTick = now > start_ ? static_cast<std::uint64_t>((now - start_) / tick_) : 0;
+        std::uint64_t ticks = timeout > Clock::duration::zero()
+                                  ? static_cast<std::uint64_t>((timeout + tick_ - Clock::duration(1)) / tick_)
+                                  : 0;
+        std::uint64_t base = nowTick > currentTick_ ? nowTick : currentTick_;
+        std::uint64_t delta = base - currentTick_ + ticks + 1;
+        if (delta > kMaxDelta)
+        {
+            delta = kMaxDelta;
+        }
+
+        timer.owner_ = this;
+        timer.expires_ = currentTick_ + delta;
+        place(timer);
+        ++size_;
+    }
+
+    /**
+     * @brief Снять таймер с колеса (если он поставлен)
+     */
+    void cancel(Timer& timer)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (timer.next)
+        {
+            unlink(timer);
+            --size_;
+        }
+    }
+
+    /**
+     * @brief Продвинуть колесо до момента now и вызвать обработчики истёкших таймеров
+     * @return Число сработавших таймеров
+     */
+    std::size_t advance(Clock::time_point now = Clock::now())
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (now <= start_)
+        {
+            return 0;
+        }
+
+        std::uint64_t target = static_cast<std::uint64_t>((now - start_) / tick_);
+        std::size_t fired = 0;
+
+        while (currentTick_ < target)
+        {
+            ++currentTick_;
+
+            // Когда младший уровень проходит полный круг, слот старшего
+            // уровня раскладывается по младшим
+            for (std::size_t level = 1; level < kLevels; ++level)
+            {
+                if ((currentTick_ & ((std::uint64_t(1) << (kSlotBits * level)) - 1)) != 0)
+                {
+                    break;
+                }
+                cascade(slots_[level][(currentTick_ >> (kSlotBits * level)) & kSlotMask]);
+            }
+
+            Node& slot = slots_[0][currentTick_ & kSlotMask];
+            while (slot.next != &slot)
+            {
+                Timer& timer = static_cast<Timer&>(*slot.next);
+                unlink(timer);
+                --size_;
+                ++fired;
+                if (timer.handler_)
+                {
+                    timer.handler_();
+                }
+            }
+        }
+
+        return fired;
+    }
+
+    /**
+     * @brief Число поставленных таймеров
+     */
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+    Clock::duration tick() const { return tick_; }
+
+private:
+    static constexpr std::size_t kSlotBits = 6;
+    static constexpr std::size_t kSlots = std::size_t(1) << kSlotBits;
+    static constexpr std::uint64_t kSlotMask = kSlots - 1;
+    static constexpr std::size_t kLevels = 4;
+    static constexpr std::uint64_t kMaxDelta = (std::uint64_t(1) << (kSlotBits * kLevels)) - 1;
+
+    static void link(Node& head, Node& node)
+    {
+        node.prev = head.prev;
+        node.next = &head;
+        head.prev->next = &node;
+        head.prev = &node;
+    }
+
+    static void unlink(Node& node)
+    {
+        node.prev->next = node.next;
+        node.next->prev = node.prev;
+        node.prev = node.next = nullptr;
+    }
+
+    void place(Timer& timer)
+    {
+        std::uint64_t delta = timer.expires_ - currentTick_;
+        std::size_t level = 0;
+        while (level + 1 < kLevels && delta >= (std::uint64_t(1) << (kSlotBits * (level + 1))))
+        {
+            ++level;
+        }
+        link(slots_[level][(timer.expires_ >> (kSlotBits * level)) & kSlotMask], timer);
+    }
+
+    void cascade(Node& slot)
+    {
+        // Сначала отцепляем весь список: таймеры раскладываются по другим слотам
+        Node pending;
+        pending.prev = pending.next = &pending;
+        while (slot.next != &slot)
+        {
+            Node& node = *slot.next;
+            unlink(node);
+            link(pending, node);
+        }
+
+        while (pending.next != &pending)
+        {
+            Timer& timer = static_cast<Timer&>(*pending.next);
+            unlink(timer);
+            place(timer);
+        }
+    }
+
+    const Clock::duration tick_;
+    const Clock::time_point start_;
+
+    mutable std::mutex mutex_;
+    std::array<std::array<Node, kSlots>, kLevels> slots_;
+    std::uint64_t currentTick_ = 0;
+    std::size_t size_ = 0;
+};
@@ -0,0 +1,529 @@
+#include "AccessLog.hpp"
+#include "Logger.hpp"
+#include "SpscRing.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @file AccessLog.cpp
+ * @brief Реализация двоичного журнала доступа
+ * @author Anton Tobolkin
+ */
+
+namespace
+{
+
+/**
+ * @brief Заголовок файла журнала, занимает AccessLog::headerSize байт
+ */
+struct FileHeader
+{
+    char signature[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint8_t reserved[48];
+};
+
+static_assert(sizeof(FileHeader) == AccessLog::headerSize, "FileHeader fills the header area");
+
+constexpr std::uint32_t kFormatVersion = 1;
+
+template<std::size_t N>
+void copyField(char (&field)[N], std::string_view text)
+{
+    std::size_t size = std::min(text.size(), N);
+    std::memcpy(field, text.data(), size);
+    std::memset(field + size, 0, N - size);
+}
+
+template<std::size_t N>
+std::string_view fieldView(const char (&field)[N])
+{
+    return std::string_view(field, strnlen(field, N));
+}
+
+std::string systemError(const std::string& what, const std::string& path)
+{
+    return "AccessLog: " + what + " " + path + ": " + std::strerror(errno);
+}
+
+void appendJsonString(std::string& out, std::string_view text)
+{
+    out.push_back('"');
+    for (char ch : text)
+    {
+        if (ch == '"' || ch == '\\')
+        {
+            out.push_back('\\');
+            out.push_back(ch);
+        }
+        else if (static_cast<unsigned char>(ch) < 0x20)
+        {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            out.append(escaped);
+        }
+        else
+        {
+            out.push_back(ch);
+        }
+    }
+    out.push_back('"');
+}
+
+/**
+ * @brief Время записи в UTC: "2026-10-18T06:22:45.388123Z"
+ */
+std::string formatTime(std::uint64_t timeNs)
+{
+    std::time_t seconds = static_cast<std::time_t>(timeNs / 1000000000);
+    std::tm tm{};
+    ::gmtime_r(&seconds, &tm);
+
+    char text[40];
+    std::size_t length = std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &tm);
+    std::snprintf(text + length, sizeof(text) - length, ".%06uZ",
+                  static_cast<unsigned>(timeNs % 1000000000 / 1000));
+    return text;
+}
+
+const char* const kPhaseNames[AccessRecord::PhaseCount] = {"read", "route", "handle", "write"};
+
+/**
+ * @brief Счётчик выборки потока: общий для всех журналов, без атомарных операций
+ */
+thread_local std::uint64_t sampleCounter = 0;
+
+} // namespace
+
+void AccessRecord::setMethod(std::string_view method)
+{
+    copyField(methodName, method);
+}
+
+void AccessRecord::setRoute(std::string_view pattern)
+{
+    copyField(routePattern, pattern);
+}
+
+void AccessRecord::setIp(std::string_view ip)
+{
+    char text[INET6_ADDRSTRLEN] = {};
+    std::memset(address, 0, sizeof(address));
+    ipVersion = 0;
+    if (ip.size() >= sizeof(text))
+    {
+        return;
+    }
+    ip.copy(text, ip.size());
+
+    if (::inet_pton(AF_INET, text, address) == 1)
+    {
+        ipVersion = 4;
+    }
+    else if (::inet_pton(AF_INET6, text, address) == 1)
+    {
+        ipVersion = 6;
+    }
+}
+
+std::string_view AccessRecord::method() const
+{
+    return fieldView(methodName);
+}
+
+std::string_view AccessRecord::route() const
+{
+    return fieldView(routePattern);
+}
+
+std::string AccessRecord::ip() const
+{
+    char text[INET6_ADDRSTRLEN] = {};
+    if (ipVersion == 4)
+    {
+        ::inet_ntop(AF_INET, address, text, sizeof(text));
+    }
+    else if (ipVersion == 6)
+    {
+        ::inet_ntop(AF_INET6, address, text, sizeof(text));
+    }
+    return text[0] ? text : "-";
+}
+
+/**
+ * @brief Буфер записей одного потока
+ */
+class AccessLog::Ring : public SpscRing<AccessRecord, 1024>
+{
+};
+
+/**
+ * @class AccessLog::File
+ * @brief Текущий файл журнала, отображённый в память; используется только фоновым потоком
+ */
+class AccessLog::File
+{
+public:
+    explicit File(const Options& options)
+        : options_(options),
+          capacity_((options.maxFileSize - headerSize) / sizeof(AccessRecord))
+    {
+        // Журнал прошлого запуска уходит в path.1, как при ротации
+        shift();
+        open();
+    }
+
+    ~File()
+    {
+        close();
+    }
+
+    /**
+     * @return false, если файл не удалось открыть (запись потеряна)
+     */
+    bool append(const AccessRecord& record)
+    {
+        if ((fd_ < 0 || count_ == capacity_) && !reopen())
+        {
+            return false;
+        }
+        std::memcpy(data_ + headerSize + count_ * sizeof(AccessRecord), &record, sizeof(record));
+        ++count_;
+        return true;
+    }
+
+private:
+    void open()
+    {
+        fd_ = ::open(options_.path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0)
+        {
+            throw std::runtime_error(systemError("cannot create", options_.path));
+        }
+
+        // Файл сразу нужного размера: страницы выделяются при первой записи,
+        // незаписанный хвост читается нулями
+        size_ = headerSize + capacity_ * sizeof(AccessRecord);
+        void* mapped = MAP_FAILED;
+        if (::ftruncate(fd_, static_cast<off_t>(size_)) == 0)
+        {
+            mapped = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        }
+        if (mapped == MAP_FAILED)
+        {
+            std::string error = systemError("cannot map", options_.path);
+            ::close(fd_);
+            fd_ = -1;
+            throw std::runtime_error(error);
+        }
+        data_ = static_cast<char*>(mapped);
+        count_ = 0;
+
+        FileHeader header{};
+        signature.copy(header.signature, sizeof(header.signature));
+        header.version = kFormatVersion;
+        header.recordSize = sizeof(AccessRecord);
+        std::memcpy(data_, &header, sizeof(header));
+    }
+
+    /**
+     * @brief Отпустить отображение и обрезать файл по последней записи
+     */
+    void close()
+    {
+        if (fd_ < 0)
+        {
+            return;
+        }
+        ::munmap(data_, size_);
+        // Необрезанный хвост из нулей читатель всё равно распознаёт как конец данных
+        if (::ftruncate(fd_, static_cast<off_t>(headerSize + count_ * sizeof(AccessRecord))) != 0)
+        {
+            MS_LOG_WARN("[AccessLog] Cannot truncate ", options_.path, ": ", std::strerror(errno));
+        }
+        ::close(fd_);
+        fd_ = -1;
+        data_ = nullptr;
+    }
+
+    /**
+     * @brief Ротация заполненного файла или повтор неудавшегося открытия
+     */
+    bool reopen()
+    {
+        try
+        {
+            if (fd_ >= 0)
+            {
+                close();
+                shift();
+            }
+            open();
+            failed_ = false;
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            if (!failed_)
+            {
+                MS_LOG_ERROR("[AccessLog] ", e.what());
+            }
+            failed_ = true;
+            return false;
+        }
+    }
+
+    /**
+     * @brief path.(N-2) -> path.(N-1), ..., path -> path.1; самый старый перезаписывается
+     */
+    void shift()
+    {
+        const std::string& path = options_.path;
+        for (int i = options_.maxFiles - 1; i > 0; --i)
+        {
+            std::string from = i == 1 ? path : path + "." + std::to_string(i - 1);
+            std::string to = path + "." + std::to_string(i);
+            ::rename(from.c_str(), to.c_str());
+        }
+    }
+
+    const Options& options_;
+    const std::size_t capacity_;
+    int fd_ = -1;
+    char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t count_ = 0;
+    bool failed_ = false; ///< Ошибка открытия уже в журнале
+};
+
+AccessLog::Options AccessLog::Options::fromEnvironment(const IEnvironment& env)
+{
+    Options options;
+    options.path = env.get<std::string>("access_log.path", "");
+
+    int maxFileSize = env.get<int>("access_log.max_file_size", static_cast<int>(options.maxFileSize));
+    if (maxFileSize < 4096)
+    {
+        throw std::runtime_error("Invalid setting: access_log.max_file_size must be at least 4096");
+    }
+    options.maxFileSize = static_cast<std::uint64_t>(maxFileSize);
+
+    options.maxFiles = env.get<int>("access_log.max_files", options.maxFiles);
+    if (options.maxFiles <= 0)
+    {
+        throw std::runtime_error("Invalid setting: access_log.max_files must be positive");
+    }
+
+    options.sample = env.get<int>("access_log.sample", options.sample);
+    if (options.sample <= 0)
+    {
+        throw std::runtime_error("Invalid setting: access_log.sample must be positive");
+    }
+    return options;
+}
+
+AccessLog::AccessLog(Options options)
+    : options_(std::move(options)),
+      id_([] {
+          static std::atomic<std::uint64_t> nextId{1};
+          return nextId.fetch_add(1, std::memory_order_relaxed);
+      }()),
+      file_(std::make_unique<File>(options_)),
+      thread_([this] { run(); })
+{
+}
+
+AccessLog::~AccessLog()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+    thread_.join();
+}
+
+void AccessLog::record(const AccessRecord& record)
+{
+    if (record.status < 500 && ++sampleCounter % static_cast<std::uint64_t>(options_.sample) != 0)
+    {
+        return;
+    }
+
+    bool pushed = threadRing().push([&](AccessRecord& slot) { slot = record; });
+    if (!pushed)
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AccessLog::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::uint64_t target = ++flushRequested_;
+    wakeup_.notify_all();
+    flushed_.wait(lock, [&] { return flushDone_ >= target || stopping_; });
+}
+
+AccessLog::Ring& AccessLog::threadRing()
+{
+    /**
+     * @brief Буфер потока в последнем журнале, куда поток писал
+     *
+     * При смене журнала или завершении потока буфер помечается released,
+     * журнал отдаёт его другому потоку после вычитывания.
+     */
+    struct Cache
+    {
+        ~Cache()
+        {
+            if (ring)
+            {
+                ring->released.store(true, std::memory_order_release);
+            }
+        }
+
+        std::uint64_t owner = 0;
+        std::shared_ptr<Ring> ring;
+    };
+    thread_local Cache cache;
+
+    if (cache.owner == id_)
+    {
+        return *cache.ring;
+    }
+    if (cache.ring)
+    {
+        cache.ring->released.store(true, std::memory_order_release);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache.owner = id_;
+    cache.ring = nullptr;
+    for (auto& ring : rings_)
+    {
+        if (ring->released.load(std::memory_order_acquire) && ring->empty())
+        {
+            ring->released.store(false, std::memory_order_relaxed);
+            cache.ring = ring;
+            return *cache.ring;
+        }
+    }
+    cache.ring = rings_.emplace_back(std::make_shared<Ring>());
+    return *cache.ring;
+}
+
+void AccessLog::run()
+{
+    std::vector<std::shared_ptr<Ring>> rings;
+    for (;;)
+    {
+        std::uint64_t flushTarget;
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeup_.wait_for(lock, std::chrono::milliseconds(10),
+                             [this] { return stopping_ || flushRequested_ > flushDone_; });
+            rings = rings_;
+            flushTarget = flushRequested_;
+            stopping = stopping_;
+        }
+
+        for (auto& ring : rings)
+        {
+            ring->drain([this](const AccessRecord& record) {
+                if (!file_->append(record))
+                {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            flushDone_ = flushTarget;
+        }
+        flushed_.notify_all();
+
+        if (stopping)
+        {
+            // Файл закрывается здесь же: после остановки писателей в нём больше нет
+            file_.reset();
+            return;
+        }
+    }
+}
+
+std::vector<AccessRecord> AccessLog::read(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error("AccessLog: cannot open " + path);
+    }
+
+    FileHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::string_view(header.signature, sizeof(header.signature)) != signature ||
+        header.version != kFormatVersion || header.recordSize != sizeof(AccessRecord))
+    {
+        throw std::runtime_error("AccessLog: not an access log file: " + path);
+    }
+
+    std::vector<AccessRecord> records;
+    AccessRecord record;
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record)) && record.timeNs != 0)
+    {
+        records.push_back(record);
+    }
+    return records;
+}
+
+std::string AccessLog::toText(const AccessRecord& record)
+{
+    std::string route(record.route());
+    std::string text = formatTime(record.timeNs) + " " + record.ip() + " " + std::string(record.method()) + " " +
+                       (route.empty() ? "-" : route) + " " + std::to_string(record.status) +
+                       " in=" + std::to_string(record.bytesIn) + " out=" + std::to_string(record.bytesOut);
+    for (std::size_t phase = 0; phase < AccessRecord::PhaseCount; ++phase)
+    {
+        text += " ";
+        text += kPhaseNames[phase];
+        text += "=" + std::to_string(record.phaseUs[phase]) + "us";
+    }
+    return text;
+}
+
+std::string AccessLog::toJson(const AccessRecord& record)
+{
+    std::string json = "{\"time\":";
+    appendJsonString(json, formatTime(record.timeNs));
+    json += ",\"ip\":";
+    appendJsonString(json, record.ip());
+    json += ",\"method\":";
+    appendJsonString(json, record.method());
+    json += ",\"route\":";
+    appendJsonString(json, record.route());
+    json += ",\"status\":" + std::to_string(record.status);
+    json += ",\"bytes_in\":" + std::to_string(record.bytesIn);
+    json += ",\"bytes_out\":" + std::to_string(record.bytesOut);
+    for (std::size_t phase = 0; phase < AccessRecord::PhaseCount; ++phase)
+    {
+        json += ",\"";
+        json += kPhaseNames[phase];
+        json += "_us\":" + std::to_string(record.phaseUs[phase]);
+    }
+    json += "}";
+    return json;
+}
@@ -0,0 +1,30 @@
+#include "IResponse.hpp"
+#include <cerrno>
+#include <system_error>
+#include <unistd.h>
+
+/**
+ * @file IResponse.cpp
+ * @brief Реализации IResponse по умолчанию, которым нужен POSIX
+ * @author Anton Tobolkin
+ */
+
+void IResponse::setFileBody(std::shared_ptr<const int> fd, std::uint64_t size)
+{
+    std::string body(size, '\0');
+    std::uint64_t done = 0;
+    while (done < size)
+    {
+        ssize_t n = ::pread(*fd, &body[done], size - done, static_cast<off_t>(done));
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            throw std::system_error(n < 0 ? errno : EIO, std::generic_category(), "IResponse: read file body");
+        }
+        done += static_cast<std::uint64_t>(n);
+    }
+    setBody(std::move(body));
+}
@@ -0,0 +1,281 @@
+#include "Logger.hpp"
+#include "SpscRing.hpp"
+#include <cerrno>
+#include <condition_variable>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * @file Logger.cpp
+ * @brief Реализация асинхронного журнала
+ * @author Anton Tobolkin
+ */
+
+namespace
+{
+
+struct Record
+{
+    std::chrono::system_clock::time_point time;
+    LogLevel level;
+    LogLine line;
+};
+
+/// Буфер одного потока: пишет владелец, читает фоновый поток
+using Ring = SpscRing<Record, 256>;
+
+class Writer
+{
+public:
+    Writer() : thread_([this] { run(); }) {}
+
+    ~Writer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wakeup_.notify_all();
+        thread_.join();
+    }
+
+    /**
+     * @brief Буфер для нового потока: освободившийся или новый
+     */
+    std::shared_ptr<Ring> acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& ring : rings_)
+        {
+            // Освобождённый буфер переиспользуется только после вычитывания
+            if (ring->released.load(std::memory_order_acquire) && ring->empty())
+            {
+                ring->released.store(false, std::memory_order_relaxed);
+                return ring;
+            }
+        }
+        return rings_.emplace_back(std::make_shared<Ring>());
+    }
+
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        std::uint64_t target = ++flushRequested_;
+        wakeup_.notify_all();
+        flushed_.wait(lock, [&] { return flushDone_ >= target || stopping_; });
+    }
+
+    void setSink(Logger::Sink sink)
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex_);
+        sink_ = std::move(sink);
+    }
+
+    std::atomic<std::uint64_t> dropped{0};
+
+private:
+    void run()
+    {
+        std::vector<std::shared_ptr<Ring>> rings;
+        std::uint64_t reportedDrops = 0;
+        for (;;)
+        {
+            std::uint64_t flushTarget;
+            bool stopping;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                // Производители не будят писателя, чтобы не брать блокировку
+                wakeup_.wait_for(lock, std::chrono::milliseconds(10),
+                                 [this] { return stopping_ || flushRequested_ > flushDone_; });
+                rings = rings_;
+                flushTarget = flushRequested_;
+                stopping = stopping_;
+            }
+
+            for (auto& ring : rings)
+            {
+                ring->drain([this](const Record& record) { format(record); });
+            }
+
+            std::uint64_t drops = dropped.load(std::memory_order_relaxed);
+            if (drops != reportedDrops)
+            {
+                LogLine line;
+                line.append("[Logger] ");
+                line.append(drops - reportedDrops);
+                line.append(" message(s) dropped: log buffer full");
+                format(Record{std::chrono::system_clock::now(), LogLevel::Warn, line});
+                reportedDrops = drops;
+            }
+            write();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                flushDone_ = flushTarget;
+            }
+            flushed_.notify_all();
+
+            if (stopping)
+            {
+                return;
+            }
+        }
+    }
+
+    void format(const Record& record)
+    {
+        std::string& out = record.level >= LogLevel::Warn ? errors_ : output_;
+
+        auto time = std::chrono::system_clock::to_time_t(record.time);
+        auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          record.time.time_since_epoch()).count() % 1000;
+        std::tm tm{};
+        ::localtime_r(&time, &tm);
+
+        char stamp[32];
+        std::size_t length = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm);
+        std::snprintf(stamp + length, sizeof(stamp) - length, ".%03d", static_cast<int>(millis));
+
+        out.append(stamp);
+        out.append(" [");
+        out.append(logLevelName(record.level));
+        out.append("] ");
+        out.append(record.line.view());
+        out.push_back('\n');
+    }
+
+    void write()
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex_);
+        emit(LogLevel::Info, output_, STDOUT_FILENO);
+        emit(LogLevel::Error, errors_, STDERR_FILENO);
+    }
+
+    void emit(LogLevel level, std::string& lines, int fd)
+    {
+        if (lines.empty())
+        {
+            return;
+        }
+
+        if (sink_)
+        {
+            sink_(level, lines);
+        }
+        else
+        {
+            std::size_t done = 0;
+            while (done < lines.size())
+            {
+                ssize_t n = ::write(fd, lines.data() + done, lines.size() - done);
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n <= 0)
+                {
+                    break;
+                }
+                done += static_cast<std::size_t>(n);
+            }
+        }
+        lines.clear();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable flushed_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::uint64_t flushRequested_ = 0;
+    std::uint64_t flushDone_ = 0;
+    bool stopping_ = false;
+
+    std::mutex sinkMutex_;
+    Logger::Sink sink_;
+    std::string output_;
+    std::string errors_;
+
+    std::thread thread_;
+};
+
+Writer& writer()
+{
+    // Уничтожается при выходе из программы, перед этим выводит остаток буферов
+    static Writer instance;
+    return instance;
+}
+
+/**
+ * @brief Буфер текущего потока, при завершении потока возвращается писателю
+ */
+struct ThreadRing
+{
+    ~ThreadRing()
+    {
+        if (ring)
+        {
+            ring->released.store(true, std::memory_order_release);
+        }
+    }
+
+    std::shared_ptr<Ring> ring;
+};
+
+thread_local ThreadRing threadRing;
+
+} // namespace
+
+LogLevel Logger::parseLevel(std::string_view name)
+{
+    for (auto level : {LogLevel::Trace, LogLevel::Debug, LogLevel::Info, LogLevel::Warn, LogLevel::Error, LogLevel::Off})
+    {
+        if (logLevelName(level) == name)
+        {
+            return level;
+        }
+    }
+    throw std::runtime_error("Invalid setting: logging.level = " + std::string(name));
+}
+
+void Logger::configure(const IEnvironment& env)
+{
+    setLevel(parseLevel(env.get<std::string>("logging.level", std::string(logLevelName(LogLevel::Info)))));
+}
+
+void Logger::push(LogLevel level, const LogLine& line)
+{
+    Writer& out = writer();
+    if (!threadRing.ring)
+    {
+        threadRing.ring = out.acquire();
+    }
+    bool pushed = threadRing.ring->push([&](Record& record) {
+        record.time = std::chrono::system_clock::now();
+        record.level = level;
+        record.line = line;
+    });
+    if (!pushed)
+    {
+        out.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Logger::flush()
+{
+    writer().flush();
+}
+
+void Logger::setSink(Sink sink)
+{
+    writer().setSink(std::move(sink));
+}
+
+std::uint64_t Logger::dropped()
+{
+    return writer().dropped.load(std::memory_order_relaxed);
+}
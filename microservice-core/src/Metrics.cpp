@@ -0,0 +1,413 @@
+#include "Metrics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * @file Metrics.cpp
+ * @brief Реализация счётчиков, гистограмм и вывода метрик
+ * @author Anton Tobolkin
+ */
+
+namespace
+{
+
+std::size_t roundUpToPowerOfTwo(std::size_t value)
+{
+    std::size_t result = 1;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+bool isValidName(const std::string& name)
+{
+    if (name.empty())
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < name.size(); ++i)
+    {
+        char ch = name[i];
+        bool letter = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_' || ch == ':';
+        bool digit = ch >= '0' && ch <= '9';
+        if (!letter && !(digit && i > 0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void appendNumber(std::string& out, double value)
+{
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    out.append(buffer, static_cast<std::size_t>(length));
+}
+
+// Значение метки: обратная косая черта, кавычка и перевод строки экранируются
+void appendLabel(std::string& out, std::string_view name, std::string_view value)
+{
+    out += name;
+    out += "=\"";
+    for (char ch : value)
+    {
+        switch (ch)
+        {
+        case '\\': out += "\\\\"; break;
+        case '"': out += "\\\""; break;
+        case '\n': out += "\\n"; break;
+        default: out += ch;
+        }
+    }
+    out += '"';
+}
+
+// HELP: экранируются только обратная косая черта и перевод строки
+void appendHeader(std::string& out, const std::string& name, const std::string& help, const char* type)
+{
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    for (char ch : help)
+    {
+        if (ch == '\\')
+        {
+            out += "\\\\";
+        }
+        else if (ch == '\n')
+        {
+            out += "\\n";
+        }
+        else
+        {
+            out += ch;
+        }
+    }
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+constexpr const char* kDurationName = "http_server_request_duration_seconds";
+constexpr double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+constexpr const char* kQuantileLabels[] = {"0.5", "0.9", "0.99", "0.999"};
+constexpr const char* kStatusLabels[] = {"1xx", "2xx", "3xx", "4xx", "5xx"};
+
+} // namespace
+
+std::size_t metricsThreadIndex()
+{
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+// === Counter ===
+
+Counter::Counter(std::size_t shards)
+    : cells_(std::make_unique<Cell[]>(shards)),
+      mask_(shards - 1)
+{
+}
+
+std::int64_t Counter::value() const
+{
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i <= mask_; ++i)
+    {
+        sum += cells_[i].value.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+// === LatencyHistogram ===
+
+struct LatencyHistogram::Shard
+{
+    std::array<std::atomic<std::uint64_t>, bucketCount> counts;
+    std::atomic<std::uint64_t> sumNs;
+};
+
+LatencyHistogram::LatencyHistogram(std::size_t shards)
+    : shards_(std::make_unique<std::atomic<Shard*>[]>(shards)),
+      mask_(shards - 1)
+{
+    for (std::size_t i = 0; i < shards; ++i)
+    {
+        shards_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+LatencyHistogram::~LatencyHistogram()
+{
+    for (std::size_t i = 0; i <= mask_; ++i)
+    {
+        delete shards_[i].load(std::memory_order_relaxed);
+    }
+}
+
+std::size_t LatencyHistogram::bucketOf(std::uint64_t ns)
+{
+    if (ns < linearBuckets)
+    {
+        return static_cast<std::size_t>(ns);
+    }
+    if (ns >> maxExponent)
+    {
+        return bucketCount - 1;
+    }
+    // Старший бит задаёт степень двойки, три следующих - корзину внутри неё
+    auto exponent = static_cast<std::size_t>(63 - __builtin_clzll(ns));
+    auto sub = static_cast<std::size_t>(ns >> (exponent - 3)) - subBuckets;
+    return linearBuckets + (exponent - 4) * subBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::upperBound(std::size_t bucket)
+{
+    if (bucket < linearBuckets)
+    {
+        return bucket + 1;
+    }
+    std::size_t exponent = 4 + (bucket - linearBuckets) / subBuckets;
+    std::size_t sub = (bucket - linearBuckets) % subBuckets;
+    return static_cast<std::uint64_t>(subBuckets + sub + 1) << (exponent - 3);
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency)
+{
+    auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 0));
+
+    auto& slot = shards_[metricsThreadIndex() & mask_];
+    Shard* shard = slot.load(std::memory_order_acquire);
+    if (!shard)
+    {
+        // Первая запись в шард: проигравший гонку освобождает свой экземпляр
+        auto* created = new Shard();
+        if (slot.compare_exchange_strong(shard, created, std::memory_order_acq_rel))
+        {
+            shard = created;
+        }
+        else
+        {
+            delete created;
+        }
+    }
+
+    shard->counts[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    shard->sumNs.fetch_add(ns, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot result;
+    for (std::size_t i = 0; i <= mask_; ++i)
+    {
+        const Shard* shard = shards_[i].load(std::memory_order_acquire);
+        if (!shard)
+        {
+            continue;
+        }
+        for (std::size_t bucket = 0; bucket < bucketCount; ++bucket)
+        {
+            auto count = shard->counts[bucket].load(std::memory_order_relaxed);
+            result.counts[bucket] += count;
+            result.count += count;
+        }
+        result.sumNs += shard->sumNs.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+std::uint64_t LatencyHistogram::Snapshot::quantile(double q) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    auto rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count)));
+    rank = std::clamp<std::uint64_t>(rank, 1, count);
+
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < bucketCount; ++bucket)
+    {
+        seen += counts[bucket];
+        if (seen >= rank)
+        {
+            return upperBound(bucket);
+        }
+    }
+    return upperBound(bucketCount - 1);
+}
+
+// === MetricsRegistry ===
+
+MetricsRegistry::Options MetricsRegistry::Options::fromEnvironment(const IEnvironment& env)
+{
+    Options options;
+    options.enabled = env.get<bool>("metrics.enabled", options.enabled);
+    options.path = env.get<std::string>("metrics.path", options.path);
+    if (!options.path.empty() && options.path.front() != '/')
+    {
+        throw std::runtime_error("Invalid setting: metrics.path must start with /");
+    }
+    return options;
+}
+
+MetricsRegistry::MetricsRegistry(std::size_t shards)
+    : shards_(roundUpToPowerOfTwo(shards ? shards
+                                         : std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, 64))),
+      unmatched_(&makeSeries("", "")),
+      inflight_(shards_)
+{
+}
+
+MetricsRegistry::Series& MetricsRegistry::makeSeries(std::string_view method, std::string_view pattern)
+{
+    Series& series = series_.emplace_back();
+    series.method = method;
+    series.pattern = pattern;
+    for (auto& histogram : series.latency)
+    {
+        histogram = std::make_unique<LatencyHistogram>(shards_);
+    }
+    return series;
+}
+
+void MetricsRegistry::addRoute(std::string_view method, std::string_view pattern)
+{
+    auto it = routes_.find(pattern);
+    if (it != routes_.end())
+    {
+        for (const Series* series : it->second)
+        {
+            if (series->method == method)
+            {
+                return;
+            }
+        }
+    }
+
+    Series& series = makeSeries(method, pattern);
+    routes_[series.pattern].push_back(&series);
+}
+
+void MetricsRegistry::recordRequest(std::string_view method, std::string_view pattern, int status,
+                                    std::chrono::nanoseconds latency)
+{
+    Series* series = unmatched_;
+    if (!pattern.empty())
+    {
+        auto it = routes_.find(pattern);
+        if (it != routes_.end())
+        {
+            for (Series* candidate : it->second)
+            {
+                if (candidate->method == method)
+                {
+                    series = candidate;
+                    break;
+                }
+            }
+        }
+    }
+
+    int statusClass = std::clamp(status / 100, 1, static_cast<int>(statusClasses)) - 1;
+    series->latency[static_cast<std::size_t>(statusClass)]->record(latency);
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help)
+{
+    if (!isValidName(name))
+    {
+        throw std::runtime_error("Invalid metric name: " + name);
+    }
+    for (auto& named : counters_)
+    {
+        if (named.name == name)
+        {
+            return *named.counter;
+        }
+    }
+    counters_.push_back(NamedCounter{name, help, std::make_unique<Counter>(shards_)});
+    return *counters_.back().counter;
+}
+
+void MetricsRegistry::addGauge(const std::string& name, const std::string& help, std::function<double()> read)
+{
+    if (!isValidName(name))
+    {
+        throw std::runtime_error("Invalid metric name: " + name);
+    }
+    gauges_.push_back(Gauge{name, help, std::move(read)});
+}
+
+std::string MetricsRegistry::scrape() const
+{
+    std::string out;
+    out.reserve(4096);
+
+    appendHeader(out, kDurationName, "Request handling time by route and status class", "summary");
+    for (const Series& series : series_)
+    {
+        for (std::size_t statusClass = 0; statusClass < statusClasses; ++statusClass)
+        {
+            auto snapshot = series.latency[statusClass]->snapshot();
+            if (snapshot.count == 0)
+            {
+                continue;
+            }
+
+            std::string labels;
+            appendLabel(labels, "method", series.method);
+            labels += ',';
+            appendLabel(labels, "route", series.pattern);
+            labels += ',';
+            appendLabel(labels, "status", kStatusLabels[statusClass]);
+
+            for (std::size_t i = 0; i < std::size(kQuantiles); ++i)
+            {
+                out += kDurationName;
+                out += '{';
+                out += labels;
+                out += ",quantile=\"";
+                out += kQuantileLabels[i];
+                out += "\"} ";
+                appendNumber(out, static_cast<double>(snapshot.quantile(kQuantiles[i])) / 1e9);
+                out += '\n';
+            }
+            out += kDurationName;
+            out += "_sum{" + labels + "} ";
+            appendNumber(out, static_cast<double>(snapshot.sumNs) / 1e9);
+            out += '\n';
+            out += kDurationName;
+            out += "_count{" + labels + "} " + std::to_string(snapshot.count) + '\n';
+        }
+    }
+
+    appendHeader(out, "http_server_requests_in_flight", "Requests being handled", "gauge");
+    out += "http_server_requests_in_flight " + std::to_string(inflight_.value()) + '\n';
+
+    for (const auto& gauge : gauges_)
+    {
+        appendHeader(out, gauge.name, gauge.help, "gauge");
+        out += gauge.name;
+        out += ' ';
+        appendNumber(out, gauge.read());
+        out += '\n';
+    }
+
+    for (const auto& named : counters_)
+    {
+        appendHeader(out, named.name, named.help, "counter");
+        out += named.name + ' ' + std::to_string(named.counter->value()) + '\n';
+    }
+    return out;
+}
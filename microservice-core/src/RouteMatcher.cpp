@@ -6,79 +6,114 @@
  * @author Anton Tobolkin
  */
 
-bool RouteMatcher::matches(const std::string& pattern, const std::string& path)
+bool RouteMatcher::matches(std::string_view pattern, std::string_view path, PathParams* params)
 {
-    // Нормализуем trailing slash только для path (для wildcard matching)
-    // но сохраняем информацию для точного сравнения
-    std::string normalizedPath = path;
-    if (!normalizedPath.empty() && normalizedPath.back() == '/')
+    if (params)
     {
-        normalizedPath.pop_back();
+        params->clear();
     }
-    
-    auto patternSegments = split(pattern, '/');
-    auto pathSegments = split(normalizedPath, '/');
-    
-    // Количество сегментов должно совпадать
-    if (patternSegments.size() != pathSegments.size())
-    {
-        return false;
-    }
-    
-    // Сравниваем каждый сегмент
-    for (size_t i = 0; i < patternSegments.size(); ++i)
+
+    // Сравниваем сегменты попарно, без разбиения в вектор
+    for (;;)
     {
-        // * соответствует любому сегменту
-        if (patternSegments[i] == "*")
+        std::string_view expected = nextSegment(pattern);
+        std::string_view actual = nextSegment(path);
+
+        if (expected.empty() || actual.empty())
+        {
+            // Количество сегментов должно совпадать; паттерн со слешем
+            // в конце требует слеш и в пути
+            return expected.empty() && actual.empty() && (pattern.empty() || !path.empty());
+        }
+
+        Segment segment = parseSegment(expected);
+        if (segment.kind == SegmentKind::Literal)
         {
+            if (segment.text != actual)
+            {
+                return false;
+            }
             continue;
         }
-        
-        // Остальные должны совпадать точно
-        if (patternSegments[i] != pathSegments[i])
+
+        if (!accepts(segment.kind, actual))
         {
             return false;
         }
+        if (params && !segment.text.empty())
+        {
+            params->add(segment.text, actual);
+        }
     }
-    
-    return true;
 }
 
-std::vector<std::string> RouteMatcher::split(const std::string& str, char delimiter)
+std::string_view RouteMatcher::nextSegment(std::string_view& rest)
 {
-    std::vector<std::string> segments;
-    std::string segment;
-    bool hasTrailingDelimiter = false;
-    
-    for (char ch : str)
+    std::size_t begin = rest.find_first_not_of('/');
+    if (begin == std::string_view::npos)
     {
-        if (ch == delimiter)
-        {
-            if (!segment.empty())
-            {
-                segments.push_back(segment);
-                segment.clear();
-            }
-            hasTrailingDelimiter = true;
-        }
-        else
-        {
-            segment += ch;
-            hasTrailingDelimiter = false;
-        }
+        return {};
     }
-    
-    // Добавляем последний сегмент, если он не пустой
-    if (!segment.empty())
+
+    std::size_t end = rest.find('/', begin);
+    if (end == std::string_view::npos)
     {
-        segments.push_back(segment);
+        end = rest.size();
     }
-    
-    // Если строка заканчивалась на delimiter, добавляем пустой сегмент
-    if (hasTrailingDelimiter && !str.empty())
+
+    std::string_view segment = rest.substr(begin, end - begin);
+    rest.remove_prefix(end);
+    return segment;
+}
+
+RouteMatcher::Segment RouteMatcher::parseSegment(std::string_view segment)
+{
+    if (segment == "*")
+    {
+        return {SegmentKind::Any, {}};
+    }
+    if (segment.front() != '{')
+    {
+        return {SegmentKind::Literal, segment};
+    }
+    if (segment.back() != '}')
+    {
+        return {SegmentKind::Invalid, segment};
+    }
+
+    std::string_view name = segment.substr(1, segment.size() - 2);
+    std::string_view type;
+    std::size_t colon = name.find(':');
+    if (colon != std::string_view::npos)
+    {
+        type = name.substr(colon + 1);
+        name = name.substr(0, colon);
+    }
+
+    if (name.empty())
     {
-        segments.push_back("");
+        return {SegmentKind::Invalid, segment};
     }
-    
-    return segments;
-}
\ No newline at end of file
+    if (type.empty() && colon == std::string_view::npos)
+    {
+        return {SegmentKind::Any, name};
+    }
+    if (type == "int")
+    {
+        return {SegmentKind::Int, name};
+    }
+    return {SegmentKind::Invalid, segment};
+}
+
+bool RouteMatcher::accepts(SegmentKind kind, std::string_view value)
+{
+    switch (kind)
+    {
+    case SegmentKind::Any:
+        return true;
+    case SegmentKind::Int:
+        return value.find_first_not_of("0123456789") == std::string_view::npos;
+    default:
+        return false;
+    }
+}
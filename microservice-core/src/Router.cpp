@@ -0,0 +1,232 @@
+#include "Router.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @file Router.cpp
+ * @brief Реализация маршрутизатора на дереве сегментов
+ * @author Anton Tobolkin
+ */
+
+namespace
+{
+
+template<class Literals>
+auto lowerBound(Literals& literals, std::string_view segment)
+{
+    return std::lower_bound(literals.begin(), literals.end(), segment,
+        [](const auto& literal, std::string_view name) { return literal.first < name; });
+}
+
+} // namespace
+
+void Router::add(std::string_view method, std::string_view pattern, std::shared_ptr<IHttpHandler> handler)
+{
+    Tree& methodTree = tree(method);
+    Node* node = &methodTree.root;
+    std::vector<std::string> names;
+
+    std::string_view rest = pattern;
+    for (auto text = RouteMatcher::nextSegment(rest); !text.empty(); text = RouteMatcher::nextSegment(rest))
+    {
+        auto segment = RouteMatcher::parseSegment(text);
+        if (segment.kind == RouteMatcher::SegmentKind::Invalid)
+        {
+            throw std::runtime_error("Invalid route pattern: " + std::string(pattern));
+        }
+        if (segment.kind != RouteMatcher::SegmentKind::Literal)
+        {
+            if (names.size() == PathParams::capacity)
+            {
+                throw std::runtime_error("Invalid route pattern: too many parameters in " + std::string(pattern));
+            }
+            names.emplace_back(segment.text);
+        }
+        node = &child(*node, segment);
+    }
+
+    // После последнего сегмента в паттерне остались только слеши
+    Route& route = rest.empty() ? node->route : node->slashRoute;
+    // "*" и "{name}" ведут в один узел: разные имена значат разные маршруты
+    if (route.handler && route.names != names)
+    {
+        throw std::runtime_error("Conflicting route patterns: " + route.pattern + " and " + std::string(pattern));
+    }
+    if (!route.handler)
+    {
+        ++size_;
+    }
+    if (!route.exact.empty())
+    {
+        methodTree.exact.erase(route.exact);
+        route.exact.clear();
+    }
+    route.handler = std::move(handler);
+    route.names = std::move(names);
+    route.pattern = std::string(pattern);
+
+    if (route.names.empty())
+    {
+        route.exact = std::string(pattern);
+        methodTree.exact[route.exact] = &route;
+    }
+}
+
+std::shared_ptr<IHttpHandler> Router::find(std::string_view method, std::string_view path,
+                                           PathParams* params) const
+{
+    return find(parseHttpMethod(method), method, path, params);
+}
+
+std::shared_ptr<IHttpHandler> Router::find(HttpMethod method, std::string_view methodName, std::string_view path,
+                                           PathParams* params) const
+{
+    if (params)
+    {
+        params->clear();
+    }
+
+    const Tree* methodTree = findTree(method, methodName);
+    if (!methodTree)
+    {
+        return nullptr;
+    }
+
+    // Точное совпадение с литеральным паттерном - без обхода дерева
+    auto exact = methodTree->exact.find(path);
+    if (exact != methodTree->exact.end())
+    {
+        if (params)
+        {
+            params->setPattern(exact->second->pattern);
+        }
+        return exact->second->handler;
+    }
+
+    Values values;
+    const Route* route = match(methodTree->root, path, values, 0);
+    if (!route)
+    {
+        return nullptr;
+    }
+
+    if (params)
+    {
+        params->setPattern(route->pattern);
+        for (std::size_t i = 0; i < route->names.size(); ++i)
+        {
+            if (!route->names[i].empty())
+            {
+                params->add(route->names[i], values[i]);
+            }
+        }
+    }
+    return route->handler;
+}
+
+void Router::clear()
+{
+    for (auto& methodTree : methods_)
+    {
+        methodTree = Tree{};
+    }
+    otherMethods_.clear();
+    size_ = 0;
+}
+
+Router::Tree& Router::tree(std::string_view method)
+{
+    HttpMethod known = parseHttpMethod(method);
+    if (known != HttpMethod::Other)
+    {
+        return methods_[static_cast<std::size_t>(known)];
+    }
+
+    for (auto& [name, methodTree] : otherMethods_)
+    {
+        if (name == method)
+        {
+            return *methodTree;
+        }
+    }
+    return *otherMethods_.emplace_back(std::string(method), std::make_unique<Tree>()).second;
+}
+
+const Router::Tree* Router::findTree(HttpMethod method, std::string_view methodName) const
+{
+    if (method != HttpMethod::Other)
+    {
+        return &methods_[static_cast<std::size_t>(method)];
+    }
+
+    for (const auto& [name, methodTree] : otherMethods_)
+    {
+        if (name == methodName)
+        {
+            return methodTree.get();
+        }
+    }
+    return nullptr;
+}
+
+Router::Node& Router::child(Node& node, const RouteMatcher::Segment& segment)
+{
+    if (segment.kind != RouteMatcher::SegmentKind::Literal)
+    {
+        auto& next = segment.kind == RouteMatcher::SegmentKind::Int ? node.integer : node.wildcard;
+        if (!next)
+        {
+            next = std::make_unique<Node>();
+        }
+        return *next;
+    }
+
+    auto it = lowerBound(node.literals, segment.text);
+    if (it == node.literals.end() || it->first != segment.text)
+    {
+        it = node.literals.emplace(it, std::string(segment.text), std::make_unique<Node>());
+    }
+    return *it->second;
+}
+
+const Router::Route* Router::match(const Node& node, std::string_view rest, Values& values, std::size_t depth)
+{
+    std::string_view after = rest;
+    std::string_view segment = RouteMatcher::nextSegment(after);
+
+    if (segment.empty())
+    {
+        // Конец пути; непустой остаток - слеш в конце
+        if (!rest.empty() && node.slashRoute.handler)
+        {
+            return &node.slashRoute;
+        }
+        return node.route.handler ? &node.route : nullptr;
+    }
+
+    auto it = lowerBound(node.literals, segment);
+    if (it != node.literals.end() && it->first == segment)
+    {
+        if (auto route = match(*it->second, after, values, depth))
+        {
+            return route;
+        }
+    }
+
+    // Переменных сегментов в дереве не больше PathParams::capacity (проверено в add)
+    if (node.integer && RouteMatcher::accepts(RouteMatcher::SegmentKind::Int, segment))
+    {
+        values[depth] = segment;
+        if (auto route = match(*node.integer, after, values, depth + 1))
+        {
+            return route;
+        }
+    }
+
+    if (node.wildcard)
+    {
+        values[depth] = segment;
+        return match(*node.wildcard, after, values, depth + 1);
+    }
+    return nullptr;
+}
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+#include "AccessLog.hpp"
+#include "Environment.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * @file AccessLogTest.cpp
+ * @brief Unit-тесты для AccessLog
+ * @author Anton Tobolkin
+ */
+
+namespace
+{
+
+// Временный каталог для файлов журнала, удаляется после теста
+class AccessLogTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char pattern[] = "/tmp/access-log-test-XXXXXX";
+        ASSERT_NE(::mkdtemp(pattern), nullptr);
+        dir_ = pattern;
+    }
+
+    void TearDown() override
+    {
+        std::system(("rm -rf " + dir_).c_str());
+    }
+
+    AccessLog::Options options(int sample = 1)
+    {
+        AccessLog::Options result;
+        result.path = dir_ + "/access.bin";
+        result.maxFileSize = 4096; // 31 запись
+        result.maxFiles = 3;
+        result.sample = sample;
+        return result;
+    }
+
+    static AccessRecord makeRecord(std::uint16_t status, std::uint64_t id = 1)
+    {
+        AccessRecord record{};
+        record.timeNs = 1760768565388123000ull;
+        record.bytesIn = id;
+        record.bytesOut = 42;
+        record.phaseUs[AccessRecord::Handle] = 25;
+        record.status = status;
+        record.setMethod("GET");
+        record.setRoute("/users/{id}");
+        record.setIp("10.0.0.1");
+        return record;
+    }
+
+    std::string dir_;
+};
+
+} // namespace
+
+// Тест: запись читается из файла без потерь
+TEST_F(AccessLogTest, WritesAndReadsRecords)
+{
+    {
+        AccessLog log(options());
+        log.record(makeRecord(200, 1));
+        log.record(makeRecord(404, 2));
+        log.flush();
+
+        // Пока журнал открыт, незаписанный хвост файла читается как конец данных
+        EXPECT_EQ(AccessLog::read(dir_ + "/access.bin").size(), 2u);
+    }
+
+    auto records = AccessLog::read(dir_ + "/access.bin");
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].status, 200);
+    EXPECT_EQ(records[0].bytesIn, 1u);
+    EXPECT_EQ(records[0].method(), "GET");
+    EXPECT_EQ(records[0].route(), "/users/{id}");
+    EXPECT_EQ(records[0].ip(), "10.0.0.1");
+    EXPECT_EQ(records[0].phaseUs[AccessRecord::Handle], 25u);
+    EXPECT_EQ(records[1].status, 404);
+}
+
+// Тест: заполненный файл уходит в path.1, самые старые файлы удаляются
+TEST_F(AccessLogTest, RotatesFullFiles)
+{
+    {
+        AccessLog log(options());
+        for (std::uint64_t i = 0; i < 100; ++i)
+        {
+            log.record(makeRecord(200, i));
+        }
+    }
+
+    auto current = AccessLog::read(dir_ + "/access.bin");
+    auto previous = AccessLog::read(dir_ + "/access.bin.1");
+    auto oldest = AccessLog::read(dir_ + "/access.bin.2");
+    EXPECT_EQ(current.size(), 100u - 3 * 31);
+    EXPECT_EQ(previous.size(), 31u);
+    EXPECT_EQ(oldest.size(), 31u);
+    EXPECT_EQ(previous.front().bytesIn, 62u);
+    EXPECT_EQ(current.back().bytesIn, 99u);
+    EXPECT_EQ(::access((dir_ + "/access.bin.3").c_str(), F_OK), -1);
+}
+
+// Тест: файл прошлого запуска не перезаписывается
+TEST_F(AccessLogTest, KeepsPreviousRun)
+{
+    {
+        AccessLog log(options());
+        log.record(makeRecord(200));
+    }
+    {
+        AccessLog log(options());
+        log.record(makeRecord(201));
+        log.record(makeRecord(202));
+    }
+
+    EXPECT_EQ(AccessLog::read(dir_ + "/access.bin").size(), 2u);
+    EXPECT_EQ(AccessLog::read(dir_ + "/access.bin.1").size(), 1u);
+}
+
+// Тест: выборка пропускает запросы, но не ответы 5xx
+TEST_F(AccessLogTest, SamplesButKeepsServerErrors)
+{
+    {
+        AccessLog log(options(10));
+        for (int i = 0; i < 20; ++i)
+        {
+            log.record(makeRecord(200));
+        }
+        log.record(makeRecord(503));
+    }
+
+    auto records = AccessLog::read(dir_ + "/access.bin");
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records.back().status, 503);
+}
+
+// Тест: записи всех потоков попадают в файл
+TEST_F(AccessLogTest, CollectsRecordsOfManyThreads)
+{
+    auto settings = options();
+    settings.maxFileSize = 1024 * 1024;
+    {
+        AccessLog log(settings);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&log] {
+                for (int i = 0; i < 500; ++i)
+                {
+                    log.record(makeRecord(200));
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(log.dropped(), 0u);
+    }
+
+    EXPECT_EQ(AccessLog::read(dir_ + "/access.bin").size(), 2000u);
+}
+
+// Тест: текстовый и JSON вид записи
+TEST_F(AccessLogTest, FormatsRecords)
+{
+    auto record = makeRecord(200);
+    EXPECT_EQ(AccessLog::toText(record),
+              "2025-10-18T06:22:45.388123Z 10.0.0.1 GET /users/{id} 200 in=1 out=42 "
+              "read=0us route=0us handle=25us write=0us");
+    EXPECT_EQ(AccessLog::toJson(record),
+              R"({"time":"2025-10-18T06:22:45.388123Z","ip":"10.0.0.1","method":"GET",)"
+              R"("route":"/users/{id}","status":200,"bytes_in":1,"bytes_out":42,)"
+              R"("read_us":0,"route_us":0,"handle_us":25,"write_us":0})");
+
+    record.setIp("::1");
+    record.setRoute("");
+    record.setMethod("PROPFIND");
+    EXPECT_EQ(record.ip(), "::1");
+    EXPECT_EQ(record.method(), "PROPFIND");
+    EXPECT_NE(AccessLog::toText(record).find(" PROPFIND - 200 "), std::string::npos);
+
+    record.setIp("unknown");
+    EXPECT_EQ(record.ip(), "-");
+}
+
+// Тест: чужой файл не читается как журнал
+TEST_F(AccessLogTest, RejectsForeignFile)
+{
+    std::ofstream(dir_ + "/other.bin") << "not an access log, just some text to fill the header area......";
+    EXPECT_THROW(AccessLog::read(dir_ + "/other.bin"), std::runtime_error);
+    EXPECT_THROW(AccessLog::read(dir_ + "/missing.bin"), std::runtime_error);
+}
+
+TEST(AccessLogConfigTest, ReadsOptionsFromEnvironment)
+{
+    Environment env;
+    auto defaults = AccessLog::Options::fromEnvironment(env);
+    EXPECT_TRUE(defaults.path.empty());
+    EXPECT_EQ(defaults.sample, 1);
+
+    env.setProperty("access_log.path", std::string("/var/log/app/access.bin"));
+    env.setProperty("access_log.sample", 100);
+    auto options = AccessLog::Options::fromEnvironment(env);
+    EXPECT_EQ(options.path, "/var/log/app/access.bin");
+    EXPECT_EQ(options.sample, 100);
+
+    env.setProperty("access_log.sample", 0);
+    EXPECT_THROW(AccessLog::Options::fromEnvironment(env), std::runtime_error);
+    env.setProperty("access_log.sample", 1);
+    env.setProperty("access_log.max_file_size", 100);
+    EXPECT_THROW(AccessLog::Options::fromEnvironment(env), std::runtime_error);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "AdmissionControl.hpp"
+
+/**
+ * @file AdmissionControlTest.cpp
+ * @brief Unit-тесты для AdmissionControl
+ */
+
+// Лимит соединений: слот возвращается при уничтожении токена
+TEST(AdmissionControlTest, ConnectionLimit)
+{
+    AdmissionControl admission;
+    admission.setLimits(2, 0);
+
+    auto first = admission.tryAcquireConnection();
+    auto second = admission.tryAcquireConnection();
+    EXPECT_TRUE(first);
+    EXPECT_TRUE(second);
+    EXPECT_FALSE(admission.tryAcquireConnection());
+    EXPECT_EQ(admission.connections(), 2u);
+
+    first.reset();
+    EXPECT_EQ(admission.connections(), 1u);
+    EXPECT_TRUE(admission.tryAcquireConnection());
+}
+
+// Лимит 0 - без ограничения, но счётчик ведётся
+TEST(AdmissionControlTest, UnlimitedStillCounts)
+{
+    AdmissionControl admission;
+
+    {
+        auto a = admission.tryAcquireRequest();
+        auto b = admission.tryAcquireRequest();
+        EXPECT_TRUE(a);
+        EXPECT_TRUE(b);
+        EXPECT_EQ(admission.inflight(), 2u);
+    }
+
+    EXPECT_EQ(admission.inflight(), 0u);
+}
+
+// Перемещение токена не освобождает слот дважды
+TEST(AdmissionControlTest, SlotMove)
+{
+    AdmissionControl admission;
+    admission.setLimits(0, 1);
+
+    auto slot = admission.tryAcquireRequest();
+    AdmissionControl::Slot moved = std::move(slot);
+    EXPECT_FALSE(slot);
+    EXPECT_TRUE(moved);
+    EXPECT_EQ(admission.inflight(), 1u);
+
+    moved.reset();
+    EXPECT_EQ(admission.inflight(), 0u);
+}
+
+// Ожидание слота: resume вызывается при освобождении соединения
+TEST(AdmissionControlTest, ResumeOnRelease)
+{
+    AdmissionControl admission;
+    admission.setLimits(1, 0);
+
+    auto held = admission.tryAcquireConnection();
+    int resumed = 0;
+
+    auto waiting = admission.acquireConnectionOrWait([&resumed] { ++resumed; });
+    EXPECT_FALSE(waiting);
+    EXPECT_EQ(resumed, 0);
+
+    held.reset();
+    EXPECT_EQ(resumed, 1);
+
+    auto retry = admission.acquireConnectionOrWait([&resumed] { ++resumed; });
+    EXPECT_TRUE(retry);
+}
+
+// clearWaiters: ожидающие больше не вызываются
+TEST(AdmissionControlTest, ClearWaiters)
+{
+    AdmissionControl admission;
+    admission.setLimits(1, 0);
+
+    auto held = admission.tryAcquireConnection();
+    int resumed = 0;
+    auto waiting = admission.acquireConnectionOrWait([&resumed] { ++resumed; });
+
+    admission.clearWaiters();
+    held.reset();
+
+    EXPECT_EQ(resumed, 0);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "Environment.hpp"
+#include "Logger.hpp"
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file LoggerTest.cpp
+ * @brief Unit-тесты для Logger
+ * @author Anton Tobolkin
+ */
+
+namespace
+{
+
+// Перехватывает вывод журнала на время теста
+class LoggerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Logger::flush();
+        Logger::setSink([this](LogLevel level, std::string_view lines) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            (level >= LogLevel::Warn ? errors_ : output_).append(lines);
+        });
+        Logger::setLevel(LogLevel::Debug);
+    }
+
+    void TearDown() override
+    {
+        Logger::flush();
+        Logger::setSink(nullptr);
+        Logger::setLevel(LogLevel::Info);
+    }
+
+    std::string output()
+    {
+        Logger::flush();
+        std::lock_guard<std::mutex> lock(mutex_);
+        return output_;
+    }
+
+    std::string errors()
+    {
+        Logger::flush();
+        std::lock_guard<std::mutex> lock(mutex_);
+        return errors_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::string output_;
+    std::string errors_;
+};
+
+} // namespace
+
+TEST_F(LoggerTest, FormatsParts)
+{
+    std::string name = "orders";
+    MS_LOG_INFO("[Test] ", name, " served ", 42, " requests, ok=", true, ", ratio ", 0.5);
+
+    std::string out = output();
+    EXPECT_NE(out.find("[info] [Test] orders served 42 requests, ok=true, ratio 0.5\n"), std::string::npos);
+}
+
+TEST_F(LoggerTest, WarningsGoToErrors)
+{
+    MS_LOG_WARN("[Test] slow client");
+    MS_LOG_ERROR("[Test] handler failed");
+    MS_LOG_DEBUG("[Test] details");
+
+    EXPECT_NE(errors().find("[warn] [Test] slow client"), std::string::npos);
+    EXPECT_NE(errors().find("[error] [Test] handler failed"), std::string::npos);
+    EXPECT_NE(output().find("[debug] [Test] details"), std::string::npos);
+    EXPECT_EQ(output().find("slow client"), std::string::npos);
+}
+
+TEST_F(LoggerTest, FiltersByLevel)
+{
+    Logger::setLevel(LogLevel::Warn);
+    MS_LOG_INFO("[Test] hidden");
+    MS_LOG_WARN("[Test] visible");
+
+    EXPECT_EQ(output().find("hidden"), std::string::npos);
+    EXPECT_NE(errors().find("visible"), std::string::npos);
+}
+
+TEST_F(LoggerTest, RemovesLevelsBelowCompiledMinimum)
+{
+    static_assert(kMinLogLevel == LogLevel::Debug);
+
+    Logger::setLevel(LogLevel::Trace);
+    bool evaluated = false;
+    MS_LOG_TRACE("[Test] ", (evaluated = true));
+
+    EXPECT_FALSE(evaluated);
+    EXPECT_EQ(output().find("[trace]"), std::string::npos);
+}
+
+TEST_F(LoggerTest, TruncatesLongMessages)
+{
+    MS_LOG_INFO(std::string(1000, 'x'));
+
+    std::string out = output();
+    auto start = out.find("] x");
+    ASSERT_NE(start, std::string::npos);
+    std::string message = out.substr(start + 2, out.find('\n', start) - start - 2);
+    EXPECT_EQ(message.size(), LogLine::capacity);
+    EXPECT_EQ(message.back(), '~');
+}
+
+TEST_F(LoggerTest, KeepsMessagesOfManyThreads)
+{
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 50; ++i)
+            {
+                MS_LOG_INFO("[Test] thread ", t, " message ", i);
+                // Буфер потока ограничен: даём писателю время его вычитать
+                if (i % 10 == 9)
+                {
+                    Logger::flush();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::string out = output();
+    for (int t = 0; t < 4; ++t)
+    {
+        EXPECT_NE(out.find("thread " + std::to_string(t) + " message 49\n"), std::string::npos);
+        // Порядок внутри потока сохраняется
+        EXPECT_LT(out.find("thread " + std::to_string(t) + " message 0\n"),
+                  out.find("thread " + std::to_string(t) + " message 49\n"));
+    }
+}
+
+TEST_F(LoggerTest, DropsWhenBufferIsFull)
+{
+    std::uint64_t before = Logger::dropped();
+    std::thread([] {
+        for (int i = 0; i < 5000; ++i)
+        {
+            MS_LOG_DEBUG("[Test] burst ", i);
+        }
+    }).join();
+
+    // Запрос не ждёт вывода: лишнее отбрасывается и учитывается
+    EXPECT_GT(Logger::dropped(), before);
+    EXPECT_NE(errors().find("message(s) dropped"), std::string::npos);
+}
+
+TEST(LoggerConfigTest, ReadsLevelFromEnvironment)
+{
+    Environment env;
+    Logger::configure(env);
+    EXPECT_EQ(Logger::level(), LogLevel::Info);
+
+    env.setProperty("logging.level", std::string("error"));
+    Logger::configure(env);
+    EXPECT_EQ(Logger::level(), LogLevel::Error);
+
+    env.setProperty("logging.level", std::string("verbose"));
+    EXPECT_THROW(Logger::configure(env), std::runtime_error);
+
+    Logger::setLevel(LogLevel::Info);
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include "Metrics.hpp"
+#include "MetricsHandler.hpp"
+#include "Environment.hpp"
+#include "SimpleRequest.hpp"
+#include "SimpleResponse.hpp"
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file MetricsTest.cpp
+ * @brief Unit-тесты для Counter, LatencyHistogram и MetricsRegistry
+ * @author Anton Tobolkin
+ */
+
+using namespace std::chrono_literals;
+
+// Тест: значение попадает в корзину, границы которой его содержат
+TEST(LatencyHistogramTest, BucketsContainValues)
+{
+    for (std::uint64_t value : {0ull, 1ull, 15ull, 16ull, 17ull, 18ull, 1000ull, 123456789ull, (1ull << 40) - 1})
+    {
+        std::size_t bucket = LatencyHistogram::bucketOf(value);
+        ASSERT_LT(bucket, LatencyHistogram::bucketCount);
+        EXPECT_LT(value, LatencyHistogram::upperBound(bucket)) << value;
+        if (bucket > 0)
+        {
+            EXPECT_GE(value, LatencyHistogram::upperBound(bucket - 1)) << value;
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucketOf(1ull << 50), LatencyHistogram::bucketCount - 1);
+
+    // Относительная ширина корзины - не больше 1/8
+    std::size_t bucket = LatencyHistogram::bucketOf(1000000);
+    double width = static_cast<double>(LatencyHistogram::upperBound(bucket) -
+                                       LatencyHistogram::upperBound(bucket - 1));
+    EXPECT_LE(width / 1000000.0, 0.125);
+}
+
+// Тест: квантили по записям всех потоков
+TEST(LatencyHistogramTest, ComputesQuantilesAcrossShards)
+{
+    LatencyHistogram histogram(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&histogram] {
+            for (int i = 1; i <= 1000; ++i)
+            {
+                histogram.record(std::chrono::microseconds(i));
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 4000u);
+    EXPECT_EQ(snapshot.sumNs, 4u * 500500 * 1000);
+
+    auto median = static_cast<double>(snapshot.quantile(0.5));
+    EXPECT_GE(median, 500000.0);
+    EXPECT_LE(median, 500000.0 * 1.125);
+    auto p99 = static_cast<double>(snapshot.quantile(0.99));
+    EXPECT_GE(p99, 990000.0);
+    EXPECT_LE(p99, 990000.0 * 1.125);
+    EXPECT_EQ(LatencyHistogram(1).snapshot().quantile(0.5), 0u);
+}
+
+// Тест: шарды счётчика суммируются при чтении
+TEST(CounterTest, SumsShards)
+{
+    Counter counter(8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 10000; ++i)
+            {
+                counter.add();
+            }
+            counter.add(-5);
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(counter.value(), 8 * 10000 - 8 * 5);
+}
+
+// Тест: серии по маршруту и классу статуса, неизвестные маршруты - в общей серии
+TEST(MetricsRegistryTest, ScrapesRouteSeries)
+{
+    MetricsRegistry registry(2);
+    registry.addRoute("GET", "/users/{id}");
+    registry.addRoute("POST", "/users/{id}");
+    registry.addRoute("GET", "/users/{id}");
+
+    registry.recordRequest("GET", "/users/{id}", 200, 2ms);
+    registry.recordRequest("GET", "/users/{id}", 204, 4ms);
+    registry.recordRequest("POST", "/users/{id}", 503, 1ms);
+    registry.recordRequest("GET", "", 404, 1ms);
+    registry.recordRequest("GET", "/unregistered", 200, 1ms);
+
+    std::string text = registry.scrape();
+    EXPECT_NE(text.find("# TYPE http_server_request_duration_seconds summary\n"), std::string::npos);
+    EXPECT_NE(text.find("http_server_request_duration_seconds_count"
+                        "{method=\"GET\",route=\"/users/{id}\",status=\"2xx\"} 2\n"),
+              std::string::npos) << text;
+    EXPECT_NE(text.find("http_server_request_duration_seconds_sum"
+                        "{method=\"GET\",route=\"/users/{id}\",status=\"2xx\"} 0.006\n"),
+              std::string::npos) << text;
+    EXPECT_NE(text.find("{method=\"POST\",route=\"/users/{id}\",status=\"5xx\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("{method=\"\",route=\"\",status=\"2xx\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("{method=\"\",route=\"\",status=\"4xx\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("{method=\"GET\",route=\"/users/{id}\",status=\"2xx\",quantile=\"0.999\"}"),
+              std::string::npos);
+    // Пустые серии не выводятся
+    EXPECT_EQ(text.find("status=\"3xx\""), std::string::npos);
+}
+
+// Тест: gauge запросов в обработке, счётчики и gauge приложения
+TEST(MetricsRegistryTest, ScrapesCountersAndGauges)
+{
+    MetricsRegistry registry;
+    Counter& orders = registry.counter("orders_created_total", "Orders created");
+    EXPECT_EQ(&registry.counter("orders_created_total", "Orders created"), &orders);
+    orders.add(3);
+    registry.addGauge("queue_depth", "Jobs\nwaiting", [] { return 7.0; });
+
+    {
+        auto inflight = registry.trackRequest();
+        EXPECT_NE(registry.scrape().find("http_server_requests_in_flight 1\n"), std::string::npos);
+    }
+
+    std::string text = registry.scrape();
+    EXPECT_NE(text.find("http_server_requests_in_flight 0\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE orders_created_total counter\norders_created_total 3\n"), std::string::npos);
+    EXPECT_NE(text.find("# HELP queue_depth Jobs\\nwaiting\n# TYPE queue_depth gauge\nqueue_depth 7\n"),
+              std::string::npos) << text;
+
+    EXPECT_THROW(registry.counter("9lives", ""), std::runtime_error);
+    EXPECT_THROW(registry.addGauge("queue depth", "", [] { return 0.0; }), std::runtime_error);
+}
+
+// Тест: метки экранируются
+TEST(MetricsRegistryTest, EscapesLabels)
+{
+    MetricsRegistry registry(1);
+    registry.addRoute("GET", "/a\"b\\c");
+    registry.recordRequest("GET", "/a\"b\\c", 200, 1ms);
+    EXPECT_NE(registry.scrape().find("route=\"/a\\\"b\\\\c\""), std::string::npos);
+}
+
+// Тест: обработчик отдаёт текстовый формат Prometheus
+TEST(MetricsRegistryTest, HandlerServesScrape)
+{
+    MetricsRegistry registry(1);
+    MetricsHandler handler(registry);
+    SimpleRequest request("GET", "/metrics", "", "127.0.0.1", 8080);
+    SimpleResponse response;
+    handler.handle(request, response);
+
+    EXPECT_EQ(response.getStatus(), 200);
+    EXPECT_EQ(response.getBody(), registry.scrape());
+}
+
+TEST(MetricsConfigTest, ReadsOptionsFromEnvironment)
+{
+    Environment env;
+    auto defaults = MetricsRegistry::Options::fromEnvironment(env);
+    EXPECT_FALSE(defaults.enabled);
+    EXPECT_EQ(defaults.path, "/metrics");
+
+    env.setProperty("metrics.enabled", true);
+    env.setProperty("metrics.path", std::string("/internal/metrics"));
+    auto options = MetricsRegistry::Options::fromEnvironment(env);
+    EXPECT_TRUE(options.enabled);
+    EXPECT_EQ(options.path, "/internal/metrics");
+
+    env.setProperty("metrics.path", std::string("metrics"));
+    EXPECT_THROW(MetricsRegistry::Options::fromEnvironment(env), std::runtime_error);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "QueryParams.hpp"
+
+/**
+ * @file QueryParamsTest.cpp
+ * @brief Unit-тесты для QueryParams
+ * @author Anton Tobolkin
+ */
+
+TEST(QueryParamsTest, FindsValues)
+{
+    QueryParams query("q=test&page=2");
+
+    EXPECT_EQ(query.get("q"), "test");
+    EXPECT_EQ(query.get("page"), "2");
+    EXPECT_FALSE(query.get("missing").has_value());
+    EXPECT_EQ(query.size(), 2u);
+}
+
+TEST(QueryParamsTest, EmptyQuery)
+{
+    QueryParams query("");
+
+    EXPECT_EQ(query.size(), 0u);
+    EXPECT_FALSE(query.contains("q"));
+}
+
+TEST(QueryParamsTest, DecodesPercentAndPlus)
+{
+    QueryParams query("q=hello+world%21&path=%2Fa%2fb&bad=100%&odd=%zz");
+
+    EXPECT_EQ(query.get("q"), "hello world!");
+    EXPECT_EQ(query.get("path"), "/a/b");
+    EXPECT_EQ(query.get("bad"), "100%");
+    EXPECT_EQ(query.get("odd"), "%zz");
+}
+
+TEST(QueryParamsTest, DecodesKeys)
+{
+    QueryParams query("first+name=Ann&a%5Bb%5D=1");
+
+    EXPECT_EQ(query.get("first name"), "Ann");
+    EXPECT_EQ(query.get("a[b]"), "1");
+    EXPECT_FALSE(query.contains("first"));
+}
+
+TEST(QueryParamsTest, KeysWithoutValue)
+{
+    QueryParams query("verbose&limit=10&&debug=");
+
+    EXPECT_TRUE(query.contains("verbose"));
+    EXPECT_EQ(query.get("verbose"), "");
+    EXPECT_EQ(query.get("limit"), "10");
+    EXPECT_EQ(query.get("debug"), "");
+    EXPECT_EQ(query.size(), 3u);
+}
+
+TEST(QueryParamsTest, RepeatedKeys)
+{
+    QueryParams query("tag=a&tag=b+c&other=1&tag=d");
+
+    EXPECT_EQ(query.get("tag"), "a");
+    auto tags = query.getAll("tag");
+    ASSERT_EQ(tags.size(), 3u);
+    EXPECT_EQ(tags[0], "a");
+    EXPECT_EQ(tags[1], "b c");
+    EXPECT_EQ(tags[2], "d");
+}
+
+TEST(QueryParamsTest, DecodedValueIsCached)
+{
+    QueryParams query("q=a%20b");
+
+    auto first = query.get("q");
+    auto second = query.get("q");
+    ASSERT_TRUE(first && second);
+    EXPECT_EQ(first->data(), second->data());
+}
+
+TEST(QueryParamsTest, PlainValueIsView)
+{
+    std::string raw = "q=plain";
+    QueryParams query(raw);
+
+    EXPECT_EQ(query.get("q")->data(), raw.data() + 2);
+}
+
+TEST(QueryParamsTest, ForEachVisitsInOrder)
+{
+    QueryParams query("b=2&a%20b=1&b=3");
+
+    std::vector<std::pair<std::string, std::string>> seen;
+    query.forEach([&seen](std::string key, std::string_view value) {
+        seen.emplace_back(std::move(key), std::string(value));
+    });
+
+    ASSERT_EQ(seen.size(), 3u);
+    EXPECT_EQ(seen[0], std::make_pair(std::string("b"), std::string("2")));
+    EXPECT_EQ(seen[1], std::make_pair(std::string("a b"), std::string("1")));
+    EXPECT_EQ(seen[2], std::make_pair(std::string("b"), std::string("3")));
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "RequestTiming.hpp"
+#include "SimpleRequest.hpp"
+#include <chrono>
+
+/**
+ * @file RequestTimingTest.cpp
+ * @brief Unit-тесты для RequestTiming
+ * @author Anton Tobolkin
+ */
+
+using namespace std::chrono_literals;
+
+// Тест: фазы считаются между соседними отметками
+TEST(RequestTimingTest, ComputesPhases)
+{
+    RequestTiming timing;
+    RequestTiming::Clock::time_point start{1s};
+    timing.mark(RequestTiming::Accepted, start);
+    timing.mark(RequestTiming::ReadStarted, start + 10us);
+    timing.mark(RequestTiming::HeaderRead, start + 20us);
+    timing.mark(RequestTiming::BodyRead, start + 50us);
+    timing.mark(RequestTiming::Routed, start + 52us);
+    timing.mark(RequestTiming::Handled, start + 152us);
+    timing.mark(RequestTiming::Written, start + 160us);
+
+    EXPECT_EQ(timing.read(), 40us);
+    EXPECT_EQ(timing.route(), 2us);
+    EXPECT_EQ(timing.handle(), 100us);
+    EXPECT_EQ(timing.write(), 8us);
+    EXPECT_EQ(timing.total(), 150us);
+    EXPECT_EQ(timing.between(RequestTiming::Accepted, RequestTiming::HeaderRead), 20us);
+}
+
+// Тест: фаза с непоставленной отметкой равна нулю
+TEST(RequestTimingTest, MissingMarkGivesZero)
+{
+    RequestTiming timing;
+    timing.mark(RequestTiming::ReadStarted);
+    EXPECT_TRUE(timing.has(RequestTiming::ReadStarted));
+    EXPECT_FALSE(timing.has(RequestTiming::Written));
+    EXPECT_EQ(timing.total(), RequestTiming::Clock::duration::zero());
+    EXPECT_EQ(timing.route(), RequestTiming::Clock::duration::zero());
+}
+
+// Тест: запрос без отметок возвращает nullptr
+TEST(RequestTimingTest, RequestWithoutTiming)
+{
+    SimpleRequest request("GET", "/", "", "127.0.0.1", 8080);
+    EXPECT_EQ(request.timing(), nullptr);
+}
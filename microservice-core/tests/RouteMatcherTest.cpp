@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "RouteMatcher.hpp"
+#include <string>
 
 /**
  * @file RouteMatcherTest.cpp
@@ -60,4 +61,30 @@ TEST(RouteMatcherTest, TrailingSlash)
 {
     EXPECT_TRUE(RouteMatcher::matches("/r/*", "/r/promo/"));
     EXPECT_FALSE(RouteMatcher::matches("/r/", "/r"));
-}
\ No newline at end of file
+}
+
+// Тест: именованные сегменты захватываются без копирования
+TEST(RouteMatcherTest, NamedParams)
+{
+    std::string path = "/users/42/orders/a-17";
+    PathParams params;
+
+    EXPECT_TRUE(RouteMatcher::matches("/users/{id}/orders/{orderId}", path, &params));
+    EXPECT_EQ(params.size(), 2u);
+    EXPECT_EQ(params.get("id"), "42");
+    EXPECT_EQ(params.get("orderId"), "a-17");
+    EXPECT_EQ(params.get("missing"), "");
+    EXPECT_EQ(params.get("id").data(), path.data() + 7);
+}
+
+// Тест: {name:int} принимает только цифры
+TEST(RouteMatcherTest, TypedParams)
+{
+    PathParams params;
+
+    EXPECT_TRUE(RouteMatcher::matches("/users/{id:int}", "/users/42", &params));
+    EXPECT_EQ(params.getInt("id"), 42);
+    EXPECT_FALSE(RouteMatcher::matches("/users/{id:int}", "/users/bob"));
+    EXPECT_FALSE(RouteMatcher::matches("/users/{id:uuid}", "/users/42"));
+    EXPECT_FALSE(RouteMatcher::matches("/users/{id", "/users/42"));
+}
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include "Router.hpp"
+#include <stdexcept>
+#include <string>
+
+/**
+ * @file RouterTest.cpp
+ * @brief Unit-тесты для Router
+ * @author Anton Tobolkin
+ */
+
+namespace
+{
+
+class NamedHandler : public IHttpHandler
+{
+public:
+    void handle(IRequest&, IResponse&) override {}
+};
+
+std::shared_ptr<IHttpHandler> handler()
+{
+    return std::make_shared<NamedHandler>();
+}
+
+} // namespace
+
+// Тест: литералы и wildcard, отдельное дерево для каждого метода
+TEST(RouterTest, MatchesByMethodAndPath)
+{
+    Router router;
+    auto users = handler();
+    auto item = handler();
+    auto post = handler();
+    router.add("GET", "/api/users", users);
+    router.add("GET", "/items/*", item);
+    router.add("POST", "/api/users", post);
+
+    EXPECT_EQ(router.find("GET", "/api/users"), users);
+    EXPECT_EQ(router.find("POST", "/api/users"), post);
+    EXPECT_EQ(router.find("GET", "/items/42"), item);
+    EXPECT_EQ(router.find("DELETE", "/api/users"), nullptr);
+    EXPECT_EQ(router.find("GET", "/items/42/edit"), nullptr);
+    EXPECT_EQ(router.find("GET", "/items"), nullptr);
+    EXPECT_EQ(router.find("GET", "/api"), nullptr);
+    EXPECT_EQ(router.size(), 3u);
+}
+
+// Тест: литерал важнее wildcard, при неудаче поиск возвращается к wildcard
+TEST(RouterTest, PrefersLiteralAndBacktracks)
+{
+    Router router;
+    auto details = handler();
+    auto me = handler();
+    auto any = handler();
+    router.add("GET", "/api/*/details", details);
+    router.add("GET", "/api/me", me);
+    router.add("GET", "/*/users/*", any);
+
+    EXPECT_EQ(router.find("GET", "/api/me"), me);
+    EXPECT_EQ(router.find("GET", "/api/me/details"), details);
+    EXPECT_EQ(router.find("GET", "/api/users/123"), any);
+    EXPECT_EQ(router.find("GET", "/api/posts/123"), nullptr);
+}
+
+// Тест: слеши в конце и пустые сегменты - как в RouteMatcher
+TEST(RouterTest, TrailingSlash)
+{
+    Router router;
+    auto item = handler();
+    auto dir = handler();
+    auto root = handler();
+    router.add("GET", "/r/*", item);
+    router.add("GET", "/d/", dir);
+    router.add("GET", "/", root);
+
+    EXPECT_EQ(router.find("GET", "/r/promo/"), item);
+    EXPECT_EQ(router.find("GET", "/r//promo"), item);
+    EXPECT_EQ(router.find("GET", "/d/"), dir);
+    EXPECT_EQ(router.find("GET", "/d"), nullptr);
+    EXPECT_EQ(router.find("GET", "/"), root);
+    EXPECT_EQ(router.find("GET", ""), nullptr);
+}
+
+// Тест: повторная регистрация заменяет обработчик, clear() удаляет все
+TEST(RouterTest, ReplaceAndClear)
+{
+    Router router;
+    auto first = handler();
+    auto second = handler();
+    router.add("GET", "/a", first);
+    router.add("GET", "/a", second);
+
+    EXPECT_EQ(router.find("GET", "/a"), second);
+    EXPECT_EQ(router.size(), 1u);
+
+    router.clear();
+    EXPECT_EQ(router.find("GET", "/a"), nullptr);
+    EXPECT_EQ(router.size(), 0u);
+}
+
+// Тест: паттерны, различающиеся только именами переменных, конфликтуют
+TEST(RouterTest, RejectsConflictingPatterns)
+{
+    Router router;
+    auto users = handler();
+    router.add("GET", "/users/*", users);
+    EXPECT_THROW(router.add("GET", "/users/{id}", handler()), std::runtime_error);
+
+    router.add("GET", "/orders/{id}", handler());
+    EXPECT_THROW(router.add("GET", "/orders/{orderId}", handler()), std::runtime_error);
+    router.add("GET", "/items/{id:int}", handler());
+    EXPECT_THROW(router.add("GET", "/items/{itemId:int}", handler()), std::runtime_error);
+
+    // Тот же паттерн и другой метод - не конфликт
+    router.add("POST", "/users/{id}", handler());
+    router.add("GET", "/orders/{id}", handler());
+    EXPECT_EQ(router.find("GET", "/users/7"), users);
+    EXPECT_EQ(router.size(), 4u);
+}
+
+// Тест: захваты {name}, приоритет {name:int} над {name}
+TEST(RouterTest, CapturesNamedParams)
+{
+    Router router;
+    auto byId = handler();
+    auto byName = handler();
+    auto orders = handler();
+    router.add("GET", "/users/{id:int}", byId);
+    router.add("GET", "/users/{name}", byName);
+    router.add("GET", "/users/{id:int}/orders/{orderId}", orders);
+
+    std::string path = "/users/42/orders/7";
+    PathParams params;
+    EXPECT_EQ(router.find("GET", path, &params), orders);
+    EXPECT_EQ(params.get("id"), "42");
+    EXPECT_EQ(params.get("orderId"), "7");
+    EXPECT_EQ(params.get("orderId").data(), path.data() + path.size() - 1);
+
+    EXPECT_EQ(router.find("GET", "/users/42", &params), byId);
+    EXPECT_EQ(params.getInt("id"), 42);
+    EXPECT_FALSE(params.contains("name"));
+
+    EXPECT_EQ(router.find("GET", "/users/bob", &params), byName);
+    EXPECT_EQ(params.get("name"), "bob");
+
+    EXPECT_EQ(router.find("GET", "/users/bob/orders/7", &params), nullptr);
+    EXPECT_TRUE(params.empty());
+}
+
+// Тест: некорректный паттерн отклоняется при регистрации
+TEST(RouterTest, RejectsInvalidPattern)
+{
+    Router router;
+    EXPECT_THROW(router.add("GET", "/users/{id", handler()), std::runtime_error);
+    EXPECT_THROW(router.add("GET", "/users/{}", handler()), std::runtime_error);
+    EXPECT_THROW(router.add("GET", "/users/{id:uuid}", handler()), std::runtime_error);
+    EXPECT_THROW(router.add("GET", "/*/*/*/*/*/*/*/*/*", handler()), std::runtime_error);
+    EXPECT_EQ(router.size(), 0u);
+}
+
+// Тест: стандартные методы по таблице, нестандартные - по имени
+TEST(RouterTest, DispatchesByMethod)
+{
+    EXPECT_EQ(parseHttpMethod("GET"), HttpMethod::Get);
+    EXPECT_EQ(parseHttpMethod("OPTIONS"), HttpMethod::Options);
+    EXPECT_EQ(parseHttpMethod("get"), HttpMethod::Other);
+    EXPECT_EQ(parseHttpMethod("PROPFIND"), HttpMethod::Other);
+
+    Router router;
+    auto get = handler();
+    auto propfind = handler();
+    router.add("GET", "/dav/{file}", get);
+    router.add("PROPFIND", "/dav/{file}", propfind);
+
+    PathParams params;
+    EXPECT_EQ(router.find(HttpMethod::Get, "GET", "/dav/a.txt", &params), get);
+    EXPECT_EQ(params.get("file"), "a.txt");
+    EXPECT_EQ(router.find(HttpMethod::Other, "PROPFIND", "/dav/a.txt"), propfind);
+    EXPECT_EQ(router.find("PROPFIND", "/dav/a.txt"), propfind);
+    EXPECT_EQ(router.find(HttpMethod::Other, "MKCOL", "/dav/a.txt"), nullptr);
+    EXPECT_EQ(router.find(HttpMethod::Post, "POST", "/dav/a.txt"), nullptr);
+}
+
+// Тест: точный литеральный маршрут находится по хешу, замена обновляет таблицу
+TEST(RouterTest, ExactRoutes)
+{
+    Router router;
+    auto health = handler();
+    auto any = handler();
+    auto replaced = handler();
+    router.add("GET", "/health", health);
+    router.add("GET", "/{name}", any);
+
+    PathParams params;
+    EXPECT_EQ(router.find("GET", "/health", &params), health);
+    EXPECT_TRUE(params.empty());
+    EXPECT_EQ(router.find("GET", "/health/", &params), health);
+    EXPECT_EQ(router.find("GET", "/ready", &params), any);
+
+    router.add("GET", "//health", replaced);
+    EXPECT_EQ(router.find("GET", "/health"), replaced);
+    EXPECT_EQ(router.find("GET", "//health"), replaced);
+    EXPECT_EQ(router.size(), 2u);
+}
+
+// Тест: find() сообщает паттерн найденного маршрута, а не путь
+TEST(RouterTest, ReportsMatchedPattern)
+{
+    Router router;
+    router.add("GET", "/api/users", handler());
+    router.add("GET", "/users/{id:int}/orders/{orderId}", handler());
+
+    PathParams params;
+    ASSERT_NE(router.find("GET", "/api/users", &params), nullptr);
+    EXPECT_EQ(params.pattern(), "/api/users");
+
+    ASSERT_NE(router.find("GET", "/users/42/orders/7", &params), nullptr);
+    EXPECT_EQ(params.pattern(), "/users/{id:int}/orders/{orderId}");
+
+    EXPECT_EQ(router.find("GET", "/missing", &params), nullptr);
+    EXPECT_TRUE(params.pattern().empty());
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include "SessionRegistry.hpp"
+#include <thread>
+
+/**
+ * @file SessionRegistryTest.cpp
+ * @brief Unit-тесты для SessionRegistry
+ */
+
+// Регистрация снимается при уничтожении токена
+TEST(SessionRegistryTest, CountsRegistrations)
+{
+    SessionRegistry registry;
+
+    {
+        auto first = registry.add([](bool) {});
+        auto second = registry.add([](bool) {});
+        EXPECT_EQ(registry.size(), 2u);
+
+        SessionRegistry::Registration moved = std::move(first);
+        EXPECT_EQ(registry.size(), 2u);
+    }
+
+    EXPECT_EQ(registry.size(), 0u);
+}
+
+// closeIdle и closeAll передают сессиям признак принудительного закрытия
+TEST(SessionRegistryTest, ClosePassesForceFlag)
+{
+    SessionRegistry registry;
+    int idleCalls = 0;
+    int forcedCalls = 0;
+
+    auto registration = registry.add([&](bool force) {
+        ++(force ? forcedCalls : idleCalls);
+    });
+
+    registry.closeIdle();
+    registry.closeAll();
+
+    EXPECT_EQ(idleCalls, 1);
+    EXPECT_EQ(forcedCalls, 1);
+}
+
+// waitEmpty возвращается, когда последняя сессия снимает регистрацию
+TEST(SessionRegistryTest, WaitEmpty)
+{
+    SessionRegistry registry;
+    auto registration = registry.add([](bool) {});
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+    EXPECT_FALSE(registry.waitEmpty(deadline));
+
+    std::thread closer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        registration.reset();
+    });
+
+    EXPECT_TRUE(registry.waitEmpty(std::chrono::steady_clock::now() + std::chrono::seconds(5)));
+    closer.join();
+}
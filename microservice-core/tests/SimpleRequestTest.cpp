@@ -55,3 +55,58 @@ TEST(SimpleRequestTest, HeadersAreCopied)
     auto reqHeaders = req.getHeaders();
     EXPECT_EQ(reqHeaders["Accept"], "text/plain"); // должно остаться прежним
 }
+
+// Проверка view-методов и поиска заголовка без учёта регистра
+TEST(SimpleRequestTest, ViewAccessors)
+{
+    SimpleRequest req("POST", "/api/items", "{\"id\": 1}", "127.0.0.1", 8080,
+                      {{"Content-Type", "application/json"}});
+
+    EXPECT_EQ(req.path(), "/api/items");
+    EXPECT_EQ(req.body(), "{\"id\": 1}");
+    EXPECT_EQ(req.header("content-type"), "application/json");
+    EXPECT_EQ(req.header("CONTENT-TYPE"), "application/json");
+    EXPECT_EQ(req.header("Accept"), "");
+    EXPECT_EQ(req.header(HttpField::ContentType), "application/json");
+    EXPECT_EQ(req.header(HttpField::Authorization), "");
+}
+
+// Проверка, что path() не включает query string, а getPath() - цель целиком
+TEST(SimpleRequestTest, PathWithoutQuery)
+{
+    SimpleRequest req("GET", "/api/items?page=2&sort=name", "", "127.0.0.1", 8080);
+
+    EXPECT_EQ(req.path(), "/api/items");
+    EXPECT_EQ(req.getPath(), "/api/items?page=2&sort=name");
+}
+
+// Минимальная реализация IRequest: view-методы работают через get*()
+struct CopyOnlyRequest : IRequest
+{
+    std::string getPath() const override { return "/orders/7?expand=items"; }
+    std::string getMethod() const override { return "GET"; }
+    std::string getBody() const override { return "payload"; }
+    std::map<std::string, std::string> getParams() const override { return {{"expand", "items"}}; }
+    std::map<std::string, std::string> getHeaders() const override { return {{"Content-Type", "text/plain"}}; }
+    std::string getIp() const override { return "127.0.0.1"; }
+    int getPort() const override { return 80; }
+};
+
+// Проверка view-методов IRequest по умолчанию
+TEST(SimpleRequestTest, DefaultViewAccessors)
+{
+    CopyOnlyRequest req;
+
+    EXPECT_EQ(req.path(), "/orders/7");
+    EXPECT_EQ(req.body(), "payload");
+    EXPECT_EQ(req.body().data(), req.body().data());
+    EXPECT_EQ(req.header("content-type"), "text/plain");
+    EXPECT_EQ(req.header(HttpField::ContentType), "text/plain");
+    EXPECT_EQ(req.header("Accept"), "");
+    EXPECT_EQ(req.param("expand"), "items");
+    EXPECT_FALSE(req.param("page").has_value());
+
+    CopyOnlyRequest copy = req;
+    EXPECT_EQ(copy.path(), "/orders/7");
+    EXPECT_NE(copy.body().data(), req.body().data());
+}
@@ -63,3 +63,50 @@ TEST(SimpleResponseTest, MultipleHeaders)
     EXPECT_EQ(headers["Content-Type"], "application/json");
     EXPECT_EQ(headers["Cache-Control"], "no-cache");
 }
+
+// Проверка: потоковые порции копятся в теле
+TEST(SimpleResponseTest, WriteAppendsChunks)
+{
+    SimpleResponse res;
+
+    res.write("hello, ");
+    res.write("world");
+    res.end();
+
+    EXPECT_EQ(res.getBody(), "hello, world");
+}
+
+// Проверка переноса тела без копирования
+TEST(SimpleResponseTest, MoveBody)
+{
+    SimpleResponse res;
+    std::string body(4096, 'x');
+    const char* data = body.data();
+
+    res.setBody(std::move(body));
+
+    EXPECT_EQ(res.body().data(), data);
+}
+
+// Проверка дописывания в зарезервированное тело
+TEST(SimpleResponseTest, AppendBody)
+{
+    SimpleResponse res;
+
+    res.reserveBody(64);
+    res.appendBody("{\"items\":[");
+    res.appendBody("1,2");
+    res.appendBody("]}");
+
+    EXPECT_EQ(res.getBody(), "{\"items\":[1,2]}");
+}
+
+// Проверка тела из общего буфера
+TEST(SimpleResponseTest, SharedBody)
+{
+    SimpleResponse res;
+
+    res.setSharedBody(std::make_shared<const std::string>("cached"));
+
+    EXPECT_EQ(res.getBody(), "cached");
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "SimpleRequest.hpp"
+#include "SimpleResponse.hpp"
+#include "StaticRoutes.hpp"
+
+/**
+ * @file StaticRoutesTest.cpp
+ * @brief Unit-тесты для StaticRouteTable
+ * @author Anton Tobolkin
+ */
+
+namespace
+{
+
+void health(IRequest&, IResponse& res)
+{
+    res.setBody("ok");
+}
+
+void create(IRequest&, IResponse& res)
+{
+    res.setStatus(201);
+}
+
+void version(IRequest&, IResponse& res)
+{
+    res.setBody("1.0");
+}
+
+constexpr auto kRoutes = makeStaticRoutes({
+    route("GET", "/health", &health),
+    route("POST", "/health", &create),
+    route("GET", "/version", &version),
+});
+
+// Таблица строится и проверяется на этапе компиляции
+static_assert(kRoutes.size() == 3);
+static_assert(kRoutes.find(HttpMethod::Get, "/health") == &health);
+static_assert(kRoutes.find(HttpMethod::Post, "/health") == &create);
+static_assert(kRoutes.find(HttpMethod::Get, "/version") == &version);
+static_assert(kRoutes.find(HttpMethod::Put, "/health") == nullptr);
+static_assert(kRoutes.find(HttpMethod::Get, "/health/") == nullptr);
+
+} // namespace
+
+// Тест: поиск через нешаблонное представление и вызов обработчика
+TEST(StaticRoutesTest, FindsAndCallsHandler)
+{
+    StaticRoutes routes = kRoutes.view();
+    EXPECT_FALSE(routes.empty());
+
+    SimpleRequest req("GET", "/version", "", "127.0.0.1", 80);
+    SimpleResponse res;
+    auto handler = routes.find(HttpMethod::Get, "/version");
+    ASSERT_NE(handler, nullptr);
+    handler(req, res);
+    EXPECT_EQ(res.getBody(), "1.0");
+
+    EXPECT_EQ(routes.find(HttpMethod::Get, "/missing"), nullptr);
+    EXPECT_EQ(StaticRoutes().find(HttpMethod::Get, "/health"), nullptr);
+}
+
+// Тест: вне constexpr некорректный маршрут - исключение
+TEST(StaticRoutesTest, RejectsInvalidRoute)
+{
+    EXPECT_THROW(route("PROPFIND", "/dav", &health), std::logic_error);
+    EXPECT_THROW(route("GET", "/users/{id}", &health), std::logic_error);
+    EXPECT_THROW(route("GET", "/users/*", &health), std::logic_error);
+
+    std::array<StaticRoute, 2> duplicate{route("GET", "/a", &health), route("GET", "/a", &version)};
+    EXPECT_THROW(StaticRouteTable<2>{duplicate}, std::logic_error);
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "TimerWheel.hpp"
+#include <iterator>
+#include <memory>
+#include <vector>
+
+/**
+ * @file TimerWheelTest.cpp
+ * @brief Unit-тесты для TimerWheel
+ */
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+const TimerWheel::Clock::time_point kStart{};
+
+} // namespace
+
+// Таймер срабатывает не раньше срока и не позже чем через два тика
+TEST(TimerWheelTest, FiresAfterTimeout)
+{
+    TimerWheel wheel(10ms, kStart);
+    int fired = 0;
+    TimerWheel::Timer timer([&] { ++fired; });
+
+    wheel.schedule(timer, 50ms, kStart);
+    EXPECT_EQ(wheel.size(), 1u);
+
+    wheel.advance(kStart + 49ms);
+    EXPECT_EQ(fired, 0);
+
+    wheel.advance(kStart + 70ms);
+    EXPECT_EQ(fired, 1);
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+// Отменённый и уничтоженный таймеры не срабатывают
+TEST(TimerWheelTest, CancelAndDestroy)
+{
+    TimerWheel wheel(10ms, kStart);
+    int fired = 0;
+
+    TimerWheel::Timer cancelled([&] { ++fired; });
+    wheel.schedule(cancelled, 20ms, kStart);
+    wheel.cancel(cancelled);
+
+    {
+        TimerWheel::Timer destroyed([&] { ++fired; });
+        wheel.schedule(destroyed, 20ms, kStart);
+    }
+
+    EXPECT_EQ(wheel.size(), 0u);
+    wheel.advance(kStart + 1s);
+    EXPECT_EQ(fired, 0);
+}
+
+// Повторная постановка переносит срок, а не добавляет второй таймер
+TEST(TimerWheelTest, Reschedule)
+{
+    TimerWheel wheel(10ms, kStart);
+    int fired = 0;
+    TimerWheel::Timer timer([&] { ++fired; });
+
+    wheel.schedule(timer, 20ms, kStart);
+    wheel.advance(kStart + 10ms);
+    wheel.schedule(timer, 100ms, kStart + 10ms);
+    EXPECT_EQ(wheel.size(), 1u);
+
+    wheel.advance(kStart + 50ms);
+    EXPECT_EQ(fired, 0);
+
+    wheel.advance(kStart + 200ms);
+    EXPECT_EQ(fired, 1);
+}
+
+// Дальние сроки переносятся с верхних уровней и срабатывают вовремя
+TEST(TimerWheelTest, CascadesLongTimeouts)
+{
+    TimerWheel wheel(1ms, kStart);
+    const std::chrono::milliseconds timeouts[] = {63ms, 64ms, 100ms, 4095ms, 4096ms, 300000ms};
+
+    std::vector<TimerWheel::Clock::time_point> firedAt(std::size(timeouts));
+    std::vector<std::unique_ptr<TimerWheel::Timer>> timers;
+    TimerWheel::Clock::time_point now = kStart + 5ms;
+
+    wheel.advance(now);
+    for (std::size_t i = 0; i < std::size(timeouts); ++i)
+    {
+        timers.push_back(std::make_unique<TimerWheel::Timer>([&, i] { firedAt[i] = now; }));
+        wheel.schedule(*timers.back(), timeouts[i], now);
+    }
+
+    const auto scheduledAt = now;
+    while (wheel.size() > 0)
+    {
+        now += 1ms;
+        wheel.advance(now);
+    }
+
+    for (std::size_t i = 0; i < std::size(timeouts); ++i)
+    {
+        EXPECT_GE(firedAt[i], scheduledAt + timeouts[i]) << "timeout " << timeouts[i].count();
+        EXPECT_LE(firedAt[i], scheduledAt + timeouts[i] + 2ms) << "timeout " << timeouts[i].count();
+    }
+}
@@ -0,0 +1,60 @@
+#include "AccessLog.hpp"
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file AccessLogDecode.cpp
+ * @brief Утилита access-log-decode: двоичный журнал доступа в текст или JSON
+ * @author Anton Tobolkin
+ *
+ * Использование: access-log-decode [--json] FILE...
+ * Файлы выводятся по порядку, по одной записи на строку.
+ */
+
+int main(int argc, char* argv[])
+{
+    bool json = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--json")
+        {
+            json = true;
+        }
+        else if (arg == "-h" || arg == "--help")
+        {
+            std::cout << "Usage: " << argv[0] << " [--json] FILE...\n";
+            return 0;
+        }
+        else
+        {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [--json] FILE...\n";
+        return 2;
+    }
+
+    try
+    {
+        for (const auto& file : files)
+        {
+            for (const auto& record : AccessLog::read(file))
+            {
+                std::cout << (json ? AccessLog::toJson(record) : AccessLog::toText(record)) << '\n';
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}